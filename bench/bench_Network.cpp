@@ -0,0 +1,324 @@
+// end to end benchmark of the network path: runs ZincServer in-process and drives synthetic clients over loopback
+//   status: handshake -> status request -> ping
+//   login:  handshake -> login start -> encryption -> login acknowledged -> client information -> config until the disconnect
+// usage: bench_Network [--clients N] [--status N] [--logins N] [--reactors N] [--workers N] [--transport libevent|io_uring]
+//                      [--port N] [--status-fast-path] [--verbose]
+#include <network/minecraft/ZincServer.h>
+#include <network/minecraft/ZincPackets.h>
+#include <util/crypto/AES.h>
+#include <util/crypto/RSA.h>
+#include <util/crypto/Random.h>
+#include <util/ZLibUtil.h>
+#include <ZincConstants.h>
+#include <event2/thread.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// heap allocations made by server threads, the client threads and the driver opt out
+std::atomic<uint64_t> g_allocations = 0;
+thread_local bool t_countAllocations = true;
+
+void* countedMalloc(size_t size) {
+    if (t_countAllocations) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+void* countedRealloc(void* ptr, size_t size) {
+    if (t_countAllocations && !ptr) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::realloc(ptr, size);
+}
+
+}
+
+void* operator new(size_t size) {
+    if (void* ptr = countedMalloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    size_t m_clients = 8;
+    size_t m_statusFlows = 2000; // per client
+    size_t m_loginFlows = 25; // per client
+    size_t m_reactors = 1;
+    int m_workers = 2;
+    std::string m_transport = "libevent";
+    unsigned short m_port = 25700;
+    bool m_statusFastPath = false;
+    bool m_verbose = false;
+};
+struct BenchResult {
+    std::vector<double> m_latencies; // microseconds per flow
+    uint64_t m_packets = 0; // sent and received by the clients
+    uint64_t m_failures = 0;
+};
+
+// blocking client speaking just enough of the protocol for the two flows
+struct BenchClient {
+private:
+    int m_fd = -1;
+    evbuffer* m_input = evbuffer_new();
+    evbuffer* m_frame = evbuffer_new();
+    zinc::AESWrapper m_encrypt, m_decrypt;
+    bool m_isCompressed = false, m_isEncrypted = false;
+public:
+    uint64_t m_packets = 0;
+
+    ~BenchClient() {
+        if (m_fd >= 0) close(m_fd);
+        evbuffer_free(m_input);
+        evbuffer_free(m_frame);
+    }
+
+    bool connect(const unsigned short& port) {
+        m_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_fd < 0) return false;
+        int noDelay = 1;
+        setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return !::connect(m_fd, (struct sockaddr*) &addr, sizeof(addr));
+    }
+    bool send(const zinc::ZincPacket& packet) {
+        evbuffer* output = evbuffer_new();
+        zinc::ZincConnection::writeFrame(output, packet, m_isCompressed);
+        size_t length = evbuffer_get_length(output);
+        unsigned char* data = evbuffer_pullup(output, -1);
+        if (m_isEncrypted) m_encrypt.update(data, length);
+        size_t written = 0;
+        while (written < length) {
+            ssize_t result = ::send(m_fd, data + written, length - written, MSG_NOSIGNAL);
+            if (result <= 0) break;
+            written += zinc::zinc_safe_cast<ssize_t, size_t>(result);
+        }
+        evbuffer_free(output);
+        m_packets++;
+        return written == length;
+    }
+    template<typename T> bool send(const T& packet) {
+        return send(zinc::encodePacket(packet));
+    }
+    bool receive(zinc::ZincPacket& packet) {
+        while (true) {
+            int frameStatus = zinc::TCPUtil::readFrame(m_input, m_frame);
+            if (frameStatus < 0) return false;
+            if (frameStatus) break;
+            unsigned char data[16384];
+            ssize_t length = recv(m_fd, data, sizeof(data), 0);
+            if (length <= 0) return false;
+            if (m_isEncrypted) m_decrypt.update(data, zinc::zinc_safe_cast<ssize_t, size_t>(length));
+            evbuffer_add(m_input, data, zinc::zinc_safe_cast<ssize_t, size_t>(length));
+        }
+        size_t frameLength = evbuffer_get_length(m_frame);
+        const unsigned char* frame = evbuffer_pullup(m_frame, -1);
+        int dataLength = 0, varIntLength = 0;
+        if (m_isCompressed) {
+            varIntLength = zinc::TCPUtil::peekVarInt(frame, frameLength, dataLength);
+            if (varIntLength <= 0) return false;
+        }
+        if (dataLength) packet = zinc::ZincConnection::inflate((const char*) frame, frameLength);
+        else {
+            int packetId = -1;
+            int idLength = zinc::TCPUtil::peekVarInt(frame + varIntLength, frameLength - zinc::zinc_safe_cast<int, size_t>(varIntLength), packetId);
+            if (idLength <= 0) return false;
+            size_t offset = zinc::zinc_safe_cast<int, size_t>(varIntLength + idLength);
+            packet = zinc::ZincPacket(packetId);
+            packet.getData().m_internalBuffer.write((const char*) frame + offset, frameLength - offset);
+        }
+        evbuffer_drain(m_frame, frameLength);
+        m_packets++;
+        return packet.getId() >= 0;
+    }
+    void setCompressed() {
+        m_isCompressed = true;
+    }
+    bool setEncrypted(const std::vector<unsigned char>& secret) {
+        m_encrypt.setKey(secret);
+        m_encrypt.setIV(secret);
+        m_decrypt.setKey(secret);
+        m_decrypt.setIV(secret);
+        m_isEncrypted = m_encrypt.initCFB8(1) && m_decrypt.initCFB8(0);
+        return m_isEncrypted;
+    }
+};
+
+bool sendHandshake(BenchClient& client, const unsigned short& port, const int& nextState) {
+    zinc::HandshakePacket handshake;
+    handshake.m_protocolVersion = zinc::LATEST_MINECRAFT_VERSION_PROTOCOL;
+    handshake.m_serverAddr = "localhost";
+    handshake.m_serverPort = port;
+    handshake.m_nextState = nextState;
+    return client.send(handshake);
+}
+bool runStatus(BenchClient& client, const unsigned short& port) {
+    zinc::ZincPacket packet;
+    if (!client.connect(port) || !sendHandshake(client, port, 1) || !client.send(zinc::StatusRequestPacket())) return false;
+    if (!client.receive(packet) || packet.getId() != zinc::StatusResponsePacket::ID) return false;
+    zinc::PingRequestPacket ping;
+    ping.m_timestamp = 42;
+    return client.send(ping) && client.receive(packet) && packet.getId() == zinc::PingRequestPacket::ID;
+}
+bool runLogin(BenchClient& client, const unsigned short& port, const std::string& name) {
+    if (!client.connect(port) || !sendHandshake(client, port, 2)) return false;
+    zinc::LoginStartPacket loginStart;
+    loginStart.m_playerName = name;
+    if (!client.send(loginStart)) return false;
+    zinc::ZincPacket packet;
+    while (true) {
+        if (!client.receive(packet)) return false;
+        if (packet.getId() == zinc::SetCompressionPacket::ID) client.setCompressed();
+        else if (packet.getId() == zinc::EncryptionRequestPacket::ID) {
+            zinc::EncryptionRequestPacket request;
+            zinc::RSAWrapper rsa (RSA_PKCS1_PADDING);
+            if (!zinc::decodePacket(packet, request) || !rsa.loadPublicKeyFromDER(request.m_publicKey)) return false;
+            std::vector<unsigned char> secret = zinc::RandomUtil::randomBytes(16);
+            zinc::EncryptionResponsePacket response;
+            response.m_sharedSecret = rsa.encrypt(secret);
+            response.m_verifyToken = rsa.encrypt(request.m_verifyToken);
+            if (!client.send(response) || !client.setEncrypted(secret)) return false;
+        } else if (packet.getId() == zinc::LoginSuccessPacket::ID) break;
+        else return false; // login disconnect
+    }
+    zinc::ClientInformationPacket information;
+    information.m_settings.m_locale = "en_us";
+    information.m_settings.m_renderDistance = 10;
+    information.m_settings.m_chatMode = zinc::ZincConnectionInfo::SettingsInfo::ChatMode::Enabled;
+    information.m_settings.m_mainHand = zinc::ZincConnectionInfo::SettingsInfo::MainHand::Right;
+    information.m_settings.m_particleStatus = zinc::ZincConnectionInfo::SettingsInfo::ParticleStatus::All;
+    if (!client.send(zinc::LoginAcknowledgedPacket()) || !client.send(information)) return false;
+    // configuration currently ends with a disconnect, everything before it is registry data, pings and keep alives
+    while (client.receive(packet)) {
+        if (packet.getId() == 2) return true;
+    }
+    return false;
+}
+void runClient(const BenchOptions& options, const size_t& index, const bool& isLogin, BenchResult& result) {
+    t_countAllocations = false;
+    size_t flows = isLogin ? options.m_loginFlows : options.m_statusFlows;
+    result.m_latencies.reserve(flows);
+    for (size_t i = 0; i < flows; i++) {
+        BenchClient client;
+        Clock::time_point start = Clock::now();
+        bool success = isLogin ? runLogin(client, options.m_port, "bench" + std::to_string(index) + "_" + std::to_string(i))
+                               : runStatus(client, options.m_port);
+        if (success) result.m_latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        else result.m_failures++;
+        result.m_packets += client.m_packets;
+    }
+}
+double percentile(const std::vector<double>& sorted, const double& fraction) {
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, (size_t) (fraction * (double) sorted.size()))];
+}
+void runScenario(const BenchOptions& options, const std::string& name, const bool& isLogin) {
+    std::vector<BenchResult> results (options.m_clients);
+    std::vector<std::thread> clients;
+    uint64_t allocations = g_allocations.load();
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < options.m_clients; i++) clients.emplace_back(runClient, std::cref(options), i, isLogin, std::ref(results[i]));
+    for (std::thread& client : clients) client.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    allocations = g_allocations.load() - allocations;
+
+    BenchResult total;
+    for (const BenchResult& result : results) {
+        total.m_latencies.insert(total.m_latencies.end(), result.m_latencies.begin(), result.m_latencies.end());
+        total.m_packets += result.m_packets;
+        total.m_failures += result.m_failures;
+    }
+    std::sort(total.m_latencies.begin(), total.m_latencies.end());
+    std::printf("%-7s %9zu flows %6lu failed %11.1f conn/s %11.1f packets/s %9.1f us p50 %9.1f us p99 %7.2f allocs/packet\n",
+                name.c_str(), total.m_latencies.size(), (unsigned long) total.m_failures, (double) total.m_latencies.size() / seconds,
+                (double) total.m_packets / seconds, percentile(total.m_latencies, 0.5), percentile(total.m_latencies, 0.99),
+                total.m_packets ? (double) allocations / (double) total.m_packets : 0.0);
+}
+bool waitForServer(const unsigned short& port) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        BenchClient client;
+        if (client.connect(port)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+}
+
+int main(int argc, char** argv) {
+    // libevent buffers are counted too, this has to run before anything else touches libevent
+    event_set_mem_functions(countedMalloc, countedRealloc, std::free);
+    evthread_use_pthreads();
+    t_countAllocations = false;
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--clients" && hasValue) options.m_clients = std::max<size_t>(std::stoul(argv[++i]), 1);
+        else if (argument == "--status" && hasValue) options.m_statusFlows = std::stoul(argv[++i]);
+        else if (argument == "--logins" && hasValue) options.m_loginFlows = std::stoul(argv[++i]);
+        else if (argument == "--reactors" && hasValue) options.m_reactors = std::max<size_t>(std::stoul(argv[++i]), 1);
+        else if (argument == "--workers" && hasValue) options.m_workers = std::stoi(argv[++i]);
+        else if (argument == "--transport" && hasValue) options.m_transport = argv[++i];
+        else if (argument == "--port" && hasValue) options.m_port = (unsigned short) std::stoul(argv[++i]);
+        else if (argument == "--status-fast-path") options.m_statusFastPath = true;
+        else if (argument == "--verbose") options.m_verbose = true;
+        else {
+            std::fprintf(stderr, "Unknown argument %s\n", argument.c_str());
+            return 1;
+        }
+    }
+
+    // no session server, no admission limits, nothing that would make the numbers depend on the clock
+    zinc::ZincConfig::CoreConfig& config = zinc::g_zincConfig.m_core;
+    config.m_security.m_onlineMode = false;
+    config.m_security.m_rateLimit = 0;
+    config.m_security.m_subnetConnectionRate = 0;
+    config.m_security.m_maxConcurrentAccount = 0;
+    config.m_network.m_maxPlayerCount = 1 << 30;
+    config.m_network.m_workerThreads = options.m_workers;
+    config.m_network.m_transport = options.m_transport;
+    config.m_optimizations.m_statusFastPath = options.m_statusFastPath;
+    if (!options.m_verbose) std::cout.setstate(std::ios::badbit);
+
+    zinc::g_zincServer.setPort(options.m_port);
+    zinc::g_zincServer.setReactorCount(options.m_reactors);
+    std::thread server ([]() {
+        t_countAllocations = true;
+        zinc::g_zincServer.start();
+    });
+    if (!waitForServer(options.m_port)) {
+        std::fprintf(stderr, "Server did not start on port %u\n", options.m_port);
+        return 1;
+    }
+    std::printf("%zu client(s), %zu reactor(s), %d worker(s), %s transport%s\n", options.m_clients, options.m_reactors, options.m_workers,
+                options.m_transport.c_str(), options.m_statusFastPath ? ", status fast path" : "");
+    if (options.m_statusFlows) runScenario(options, "status", false);
+    if (options.m_loginFlows) runScenario(options, "login", true);
+    zinc::g_zincServer.stop();
+    server.join();
+    return 0;
+}
@@ -0,0 +1,28 @@
+// libFuzzer target for the inbound network path: the input is buffered as if it arrived on a socket and
+// ZincServer::onRead frames, decompresses and dispatches it exactly like a reactor would
+// the first byte picks the starting state (low 3 bits) and whether compression is already on (bit 3)
+// fuzz/corpus holds inputs that once crashed it, keep new findings out of it: fuzz_ZincConnection <workdir> fuzz/corpus
+#include <network/minecraft/ZincServer.h>
+#include <util/EpochReclaimer.h>
+#include <iostream>
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+    std::cout.setstate(std::ios::badbit); // every dispatched packet is logged
+    zinc::g_zincConfig.m_core.m_security.m_onlineMode = false;
+    zinc::g_zincServer.getRSA().generateKeys(1024);
+    return 0;
+}
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (!size) return 0;
+    zinc::ZincConnection* connection = new zinc::ZincConnection();
+    zinc::MemoryStream* stream = new zinc::MemoryStream();
+    connection->getTCPConnection().setStream(stream);
+    connection->setState((zinc::ZincConnection::State) ((data[0] & 7) % zinc::ZincPacketDispatcher::STATE_COUNT));
+    connection->setIsCompressed(data[0] & 8);
+    zinc::ConnectionHandle handle = zinc::g_zincServer.addClient(connection);
+    evbuffer_add(stream->getInput(), data + 1, size - 1);
+    zinc::ZincServer::onRead(stream, connection);
+    zinc::g_zincServer.removeClient(handle);
+    zinc::g_epochReclaimer.collect();
+    return 0;
+}
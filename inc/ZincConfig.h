@@ -26,12 +26,57 @@ private:
 public:
     struct CoreConfig {
         struct Network {
+            // see TCPBindEndpoint, an empty list listens dual-stack on m_serverPort
+            struct BindAddress {
+                std::string m_address = "::";
+                int m_port = 0; // 0 = m_serverPort
+                std::string m_interface;
+                int m_backlog = -1;
+                bool m_noDelay = true;
+                bool m_ipv6Only = false;
+                int m_deferAccept = 0; // seconds
+                int m_receiveBuffer = 0, m_sendBuffer = 0; // bytes
+                int m_fastOpenQueue = 0;
+            };
+            std::vector<BindAddress> m_bindAddresses;
             int m_threshold = 256;
+            int m_compressionLevel = 6; // 1 (fastest) - 9 (smallest), -1 is the zlib default, clamped to that range on load
             int m_serverPort = 25565;
             int m_srvctlPort = 25575;
+            int m_reactorThreads = 1; // 0 = one per hardware thread
+            std::string m_transport = "libevent"; // "libevent" or "io_uring" (Linux 6.0+, falls back to libevent)
+            int m_authThreads = 4;
+            int m_workerThreads = 2; // RSA, cookie and large inflate work, 0 = inline on the reactor
+            int m_outboundLowWatermark = 262144; // bytes, a congested connection recovers below this
+            int m_outboundHighWatermark = 1048576; // bytes, congestion listeners are notified above this
+            int m_outboundHardCap = 16777216; // bytes, the connection is dropped above this
+            int m_handshakeTimeout = 10; // seconds from accept until Login Start, also bounds status pings
+            int m_loginTimeout = 30; // seconds from Login Start until Login Acknowledged
+            int m_keepAliveInterval = 15; // seconds
+            int m_keepAliveTimeout = 30; // seconds
+            // at runtime MOTD and icon are changed through ZincStatusCache::setMotd/setIcon, the cached status frame wouldn't notice otherwise
             std::string m_motd = "A " + LEGACY_COLOR_AQUA + "Zinc" + LEGACY_FORMAT_RESET + " Minecraft Server";
             int m_maxPlayerCount = 20;
             std::string m_iconBase64, m_iconPath = "icon.png";
+
+            std::vector<nlohmann::json> serializeBindAddresses() {
+                std::vector<nlohmann::json> result;
+                for (const BindAddress& bindAddress : m_bindAddresses) {
+                    result.push_back(nlohmann::json{
+                        { "address", bindAddress.m_address },
+                        { "port", bindAddress.m_port },
+                        { "interface", bindAddress.m_interface },
+                        { "backlog", bindAddress.m_backlog },
+                        { "tcp_nodelay", bindAddress.m_noDelay },
+                        { "ipv6_only", bindAddress.m_ipv6Only },
+                        { "defer_accept_seconds", bindAddress.m_deferAccept },
+                        { "receive_buffer", bindAddress.m_receiveBuffer },
+                        { "send_buffer", bindAddress.m_sendBuffer },
+                        { "fast_open_queue", bindAddress.m_fastOpenQueue }
+                    });
+                }
+                return result;
+            }
         } m_network;
         struct Security {
             bool m_onlineMode = true;
@@ -39,14 +84,24 @@ public:
             bool m_allowSurvivalFlight = false;
             bool m_allowPVP = true;
             int m_backupInterval = 1440; // minutes
-            int m_rateLimit = 2;
+            int m_rateLimit = 2; // seconds per connection token for one address, 0 = unlimited
+            int m_connectionBurst = 3;
+            int m_subnetConnectionRate = 20; // connections per second for an IPv4 /24 or IPv6 /64, 0 = unlimited
+            int m_subnetConnectionBurst = 40;
             int m_maxConcurrentAccount = 10;
             std::string m_rbacPath = "config/rbac";
             std::string m_unbanSupport;
+            std::string m_sessionServer = "https://sessionserver.mojang.com";
+            int m_sessionServerTimeout = 5; // seconds
+            bool m_proxyProtocol = false; // trusted peers must open with a PROXY protocol v1/v2 header carrying the client address
+            std::vector<std::string> m_trustedProxies; // addresses of the load balancers, empty = every peer
         } m_security;
         struct Optimizations {
             int m_viewDistance = 10;
             int m_simulationDistance = 10;
+            bool m_statusFastPath = false; // answer server list pings without creating a ZincConnection
+            bool m_packetMetrics = false; // count calls and time spent per packet handler, see ZincPacketDispatcher::getStats
+            int m_offloadInflateThreshold = 262144; // bytes, larger compressed packets are inflated on a worker, 0 = never
         } m_optimizations;
         struct WorldConfig {
             enum class WorldType : int { Limbo, Template, Normal } m_worldType = WorldType::Normal;
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "TCPStream.h"
+#include <util/Logger.h>
+#include <util/Memory.h>
+#include <event2/listener.h>
+#include <linux/io_uring.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace zinc {
+
+struct IOUring;
+typedef void(*IOUringAcceptCallback)(evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr);
+
+// completion based transport: one multishot receive per socket fills the input from the ring's provided buffers,
+// everything written during a loop iteration leaves in a single sendmsg per socket
+struct IOUringStream : public TCPStream {
+private:
+    friend struct IOUring;
+    static constexpr size_t MAX_IOVECS = 64;
+
+    IOUring* m_ring;
+    evutil_socket_t m_fd;
+    evbuffer* m_input = evbuffer_new();
+    evbuffer* m_output = evbuffer_new();
+    evbuffer* m_sending = evbuffer_new(); // owned by the kernel while a send is in flight
+    std::array<evbuffer_iovec, MAX_IOVECS> m_iovecs;
+    struct msghdr m_message {};
+    TCPStreamCallback m_onRead = nullptr, m_onWrite = nullptr;
+    TCPStreamEventCallback m_onEvent = nullptr;
+    void* m_ctx = nullptr;
+    size_t m_lowWatermark = 0;
+    int m_inflight = 0; // submitted operations that haven't posted their final completion yet
+    bool m_reading = false, m_receiving = false, m_sendInFlight = false, m_queued = false, m_isEOF = false, m_closed = false;
+    bool m_cancelPending = false; // close() found the submission queue full
+    bool m_cancellingReceive = false; // disableRead() cancelled the armed receive, its final completion is still due
+
+    static void onOutput(evbuffer* buffer, const evbuffer_cb_info* info, void* ptr);
+    void queue();
+    void flush();
+    void cancel();
+    void maybeRelease();
+    void onReceive(const io_uring_cqe& cqe);
+    void onSend(const io_uring_cqe& cqe);
+public:
+    IOUringStream(IOUring* ring, const evutil_socket_t& fd) : m_ring(ring), m_fd(fd) {
+        evbuffer_add_cb(m_output, onOutput, this);
+    }
+    ~IOUringStream();
+
+    evbuffer* getInput() override;
+    evbuffer* getOutput() override;
+    size_t getOutputLength() override;
+    evutil_socket_t getFd() const override;
+
+    void setCallbacks(TCPStreamCallback onRead, TCPStreamCallback onWrite, TCPStreamEventCallback onEvent, void* ctx) override;
+    void enableRead() override;
+    void disableRead() override;
+    void setWriteLowWatermark(const size_t& watermark) override;
+    void close() override;
+};
+// one ring per reactor, driven from the reactor's libevent loop: completions are signalled through an eventfd
+// and new submissions are collected until the end of the loop iteration, then handed to the kernel in one syscall
+struct IOUring {
+public:
+    static constexpr unsigned ENTRIES = 4096;
+    static constexpr unsigned BUFFER_COUNT = 256; // power of two
+    static constexpr unsigned BUFFER_SIZE = 16384;
+    static constexpr unsigned short BUFFER_GROUP = 0;
+    enum Operation : uint64_t {
+        Accept = 0, Receive = 1, Send = 2, Cancel = 3
+    };
+private:
+    int m_fd = -1, m_eventFd = -1;
+    void* m_sqRing = nullptr;
+    void* m_cqRing = nullptr;
+    size_t m_sqRingSize = 0, m_cqRingSize = 0, m_sqesSize = 0;
+    unsigned* m_sqHead = nullptr;
+    unsigned* m_sqTail = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_sqMask = 0, m_sqEntries = 0, m_cqMask = 0, m_sqLocalTail = 0, m_toSubmit = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    io_uring_buf* m_bufferRing = nullptr; // the ring tail overlays the resv field of the first entry
+    std::vector<unsigned char> m_buffers;
+    unsigned short m_bufferTail = 0;
+    event* m_completionEvent = nullptr;
+    event* m_submitEvent = nullptr;
+    bool m_submitScheduled = false;
+    std::vector<IOUringStream*> m_queue, m_released;
+    std::vector<evutil_socket_t> m_listeners;
+    IOUringAcceptCallback m_onAccept = nullptr;
+    void* m_acceptArg = nullptr;
+    Logger m_logger = Logger("IOUring");
+
+    static void onCompletions(evutil_socket_t fd, short events, void* ptr);
+    static void onSubmit(evutil_socket_t fd, short events, void* ptr);
+    void scheduleSubmit();
+    void submit();
+    void armAccept(const evutil_socket_t& listener);
+public:
+    ~IOUring();
+
+    // false if the kernel can't run this backend (multishot receive needs Linux 6.0), the reactor then stays on libevent
+    bool init(event_base* base, IOUringAcceptCallback onAccept, void* acceptArg);
+    // takes ownership of a bound and listening socket and accepts from it with one multishot accept
+    void listen(const evutil_socket_t& fd);
+    void closeListeners();
+    IOUringStream* createStream(const evutil_socket_t& fd);
+
+    // the entry is zeroed and submitted at the end of the loop iteration, nullptr if the ring stays full
+    io_uring_sqe* getSqe();
+    void schedule(IOUringStream* stream);
+    void release(IOUringStream* stream);
+    const unsigned char* getBuffer(const unsigned short& id) const;
+    void recycleBuffer(const unsigned short& id);
+};
+
+}
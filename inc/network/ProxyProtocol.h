@@ -0,0 +1,26 @@
+#pragma once
+
+#include <event2/buffer.h>
+#include <sys/socket.h>
+#include <cstddef>
+
+namespace zinc {
+
+struct ProxyHeader {
+    bool m_isLocal = false; // LOCAL command or unknown family (proxy health checks), the socket address stays as is
+    sockaddr_storage m_source {};
+};
+// PROXY protocol v1 (text) and v2 (binary) as sent by HAProxy-style L4 load balancers in front of the server
+struct ProxyProtocol {
+    static constexpr size_t MAX_V1_LENGTH = 107; // including the trailing CRLF
+    static constexpr size_t V2_HEADER_LENGTH = 16;
+    static constexpr size_t MAX_HEADER_LENGTH = 1024; // v2 headers with larger TLV sections are refused
+
+    // parses a header at the start of data: returns its length, 0 if more bytes are needed or -1 if malformed
+    static int parse(const unsigned char* data, const size_t& length, ProxyHeader& header);
+    // same as parse, but reads straight from the first chunk of input when it holds the whole header
+    // and drains the header once it is complete, the rest of the stream is left untouched
+    static int read(evbuffer* input, ProxyHeader& header);
+};
+
+}
@@ -1,7 +1,7 @@
 #pragma once
 
+#include "TCPStream.h"
 #include <type/ByteBuffer.h>
-#include <event2/bufferevent.h>
 #include <arpa/inet.h>
 #include <string>
 
@@ -9,35 +9,27 @@ namespace zinc {
 
 struct TCPConnection {
 private:
-    bufferevent* m_bev;
+    TCPStream* m_stream;
     evutil_socket_t m_fd;
     std::string m_ip;
-    struct sockaddr* m_addr;
+    sockaddr_storage m_addr {}; // owned copy, the accept address and PROXY protocol results don't outlive the callback
 public:
-    TCPConnection() : m_bev(nullptr), m_fd(-1), m_ip("0.0.0.0") {}
-    TCPConnection(bufferevent* bev, const evutil_socket_t& fd, struct sockaddr* addr) : m_bev(bev), m_fd(fd), m_ip("0.0.0.0"), m_addr(addr) {
-        m_ip.clear();
-        m_ip.resize(INET6_ADDRSTRLEN);
-        if (addr->sa_family == AF_INET) {
-            struct sockaddr_in* sin = (struct sockaddr_in*)addr;
-            inet_ntop(AF_INET, &sin->sin_addr, m_ip.data(), INET6_ADDRSTRLEN);
-        } else {
-            struct sockaddr_in6* sin6 = (struct sockaddr_in6*)addr;
-            inet_ntop(AF_INET6, &sin6->sin6_addr, m_ip.data(), INET6_ADDRSTRLEN);
-        }
+    TCPConnection() : m_stream(nullptr), m_fd(-1), m_ip("0.0.0.0") {}
+    TCPConnection(TCPStream* stream, const evutil_socket_t& fd, struct sockaddr* addr) : m_stream(stream), m_fd(fd), m_ip("0.0.0.0") {
+        setAddr(addr);
     }
     ~TCPConnection() {
         close();
     }
 
     std::string getIP() const;
-    struct sockaddr* getAddr() const;
-    bufferevent* getBuffer();
-    const bufferevent* getBuffer() const;
+    const struct sockaddr* getAddr() const;
+    TCPStream* getStream();
+    const TCPStream* getStream() const;
     evutil_socket_t getFd() const;
 
-    void setBuffer(bufferevent *bev);
-    void setAddr(struct sockaddr* addr);
+    void setStream(TCPStream* stream);
+    void setAddr(const struct sockaddr* addr);
     void setFd(evutil_socket_t fd);
 
     void send(const ByteBuffer& data);
@@ -1,42 +1,107 @@
 #pragma once
 
+#include <event2/event.h>
 #include <event2/listener.h>
 #include <event2/bufferevent.h>
 #include <event2/buffer.h>
+#include <network/IOUring.h>
+#include <network/TCPStream.h>
 #include <util/Logger.h>
 #include <util/TCPUtil.h>
+#include <util/TimerWheel.h>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace zinc {
 
+// one listening address, every reactor binds its own listener for each endpoint
+struct TCPBindEndpoint {
+    std::string m_address = "::"; // "::" is dual-stack unless m_ipv6Only, falls back to 0.0.0.0 without IPv6 support
+    unsigned short m_port = 0; // 0 = the server's port
+    std::string m_interface; // SO_BINDTODEVICE, empty = every interface
+    int m_backlog = -1; // -1 = libevent default
+    bool m_noDelay = true; // accepted sockets inherit TCP_NODELAY from the listener
+    bool m_ipv6Only = false;
+    int m_deferAccept = 0; // seconds to wait for the first bytes before accept() returns, 0 = off
+    int m_receiveBuffer = 0, m_sendBuffer = 0; // bytes, 0 = kernel default
+    int m_fastOpenQueue = 0; // pending TCP Fast Open requests, 0 = off
+};
+enum class TCPTransport {
+    Libevent, IOUring
+};
+struct TCPReactor {
+    size_t m_id = 0;
+    event_base* m_base = nullptr;
+    std::vector<evconnlistener*> m_listeners;
+    IOUring* m_uring = nullptr; // set when the reactor runs the io_uring transport
+    event* m_taskEvent = nullptr;
+    std::mutex m_taskMutex;
+    std::deque<std::function<void()>> m_tasks;
+    event* m_timerEvent = nullptr;
+    TimerWheel m_timers;
+    std::chrono::steady_clock::time_point m_timerStart;
+    std::thread m_thread;
+};
 class TCPServer {
 private:
     bool m_started = false;
     Logger m_logger = Logger("TCPServer");
     unsigned short m_port;
-    event_base* m_base;
-    evconnlistener* m_listener;
+    size_t m_reactorCount = 1;
+    TCPTransport m_transport = TCPTransport::Libevent;
+    std::vector<TCPBindEndpoint> m_endpoints;
+    std::deque<TCPReactor> m_reactors;
     void(*m_onAccept)(evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr);
+
+    void startReactor(TCPReactor& reactor);
+    // bound but not yet listening socket with the endpoint's options applied, -1 on failure
+    evutil_socket_t bindEndpoint(const TCPBindEndpoint& endpoint);
+    void setOption(const evutil_socket_t& fd, const int& level, const int& name, const int& value, const std::string& description);
+    static void onTasks(evutil_socket_t fd, short events, void* ptr);
+    static void onTimer(evutil_socket_t fd, short events, void* ptr);
 public:
-    TCPServer() : m_port(0), m_base(nullptr), m_listener(nullptr) {}
-    TCPServer(const unsigned short& port, void(*onAccept)(evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr)) 
-        : m_port(port), m_base(nullptr), m_listener(nullptr), m_onAccept(onAccept) {
-        m_base = event_base_new();
-        if (!m_base) {
-            m_logger.error("Failed to create event base", true);
-        }
-    }
+    static constexpr int TIMER_TICK_MILLISECONDS = 100;
+
+    TCPServer() : m_port(0), m_onAccept(nullptr) {}
+    TCPServer(const unsigned short& port, void(*onAccept)(evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr))
+        : m_port(port), m_onAccept(onAccept) {}
     ~TCPServer() {
         if (!m_port) return;
         stop();
-        if (m_base) {
-            event_base_free(m_base);
+        for (TCPReactor& reactor : m_reactors) {
+            if (reactor.m_thread.joinable()) reactor.m_thread.join();
+            if (reactor.m_taskEvent) event_free(reactor.m_taskEvent);
+            if (reactor.m_timerEvent) event_free(reactor.m_timerEvent);
+            delete reactor.m_uring;
+            if (reactor.m_base) event_base_free(reactor.m_base);
         }
     }
 
     void start();
     void stop();
 
+    // runs task on the reactor's thread, safe to call from any thread
+    void post(const size_t& reactorId, const std::function<void()>& task);
+    // runs callback on the reactor's timer wheel after delay (rounded up to whole ticks), must be called on the reactor's thread
+    TimerWheel::TimerId schedule(const size_t& reactorId, const uint64_t& delayMilliseconds, const std::function<void()>& callback);
+    bool cancel(const size_t& reactorId, TimerWheel::TimerId& id);
+
+    // wraps a socket accepted on reactor in the reactor's transport, nullptr on failure
+    static TCPStream* createStream(TCPReactor* reactor, const evutil_socket_t& fd);
+
     void setPort(const unsigned short& port);
+    // empty = a single dual-stack endpoint on the server's port
+    void setEndpoints(const std::vector<TCPBindEndpoint>& endpoints);
+    void setReactorCount(const size_t& reactorCount);
+    // io_uring falls back to libevent per reactor if the kernel doesn't support it
+    void setTransport(const TCPTransport& transport);
+    size_t getReactorCount() const;
+    TCPReactor* getReactor(const size_t& reactorId);
 };
 
 }
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <cstddef>
+
+namespace zinc {
+
+struct TCPStream;
+typedef void(*TCPStreamCallback)(TCPStream* stream, void* ctx);
+typedef void(*TCPStreamEventCallback)(TCPStream* stream, short events, void* ctx); // BEV_EVENT_* flags
+
+// byte stream of one accepted socket, see TCPServer::createStream for the available transports
+// only the owning reactor's thread may touch a stream, its callbacks run there too
+struct TCPStream {
+public:
+    virtual ~TCPStream() {}
+
+    virtual evbuffer* getInput() = 0;
+    // anything appended here is sent without further calls
+    virtual evbuffer* getOutput() = 0;
+    // output the kernel hasn't accepted yet, including a send that is still in flight
+    virtual size_t getOutputLength() = 0;
+    virtual evutil_socket_t getFd() const = 0;
+
+    virtual void setCallbacks(TCPStreamCallback onRead, TCPStreamCallback onWrite, TCPStreamEventCallback onEvent, void* ctx) = 0;
+    virtual void enableRead() = 0;
+    // stops reading from the socket, input that already arrived stays buffered and may still be delivered
+    virtual void disableRead() = 0;
+    // onWrite runs whenever a write leaves at most this many bytes of output
+    virtual void setWriteLowWatermark(const size_t& watermark) = 0;
+    // closes the socket and drops unsent output, the stream must not be used afterwards
+    virtual void close() = 0;
+
+    void write(const void* data, const size_t& length) {
+        evbuffer_add(getOutput(), data, length);
+    }
+};
+// readiness based transport on top of a libevent bufferevent
+struct LibeventStream : public TCPStream {
+private:
+    bufferevent* m_bev;
+    TCPStreamCallback m_onRead = nullptr, m_onWrite = nullptr;
+    TCPStreamEventCallback m_onEvent = nullptr;
+    void* m_ctx = nullptr;
+
+    LibeventStream(bufferevent* bev) : m_bev(bev) {}
+
+    static void onRead(bufferevent* bev, void* ptr);
+    static void onWrite(bufferevent* bev, void* ptr);
+    static void onEvent(bufferevent* bev, short events, void* ptr);
+public:
+    ~LibeventStream() {
+        if (m_bev) bufferevent_free(m_bev);
+    }
+
+    // nullptr if the bufferevent couldn't be created, the socket is closed together with the stream
+    static LibeventStream* create(event_base* base, const evutil_socket_t& fd);
+
+    evbuffer* getInput() override;
+    evbuffer* getOutput() override;
+    size_t getOutputLength() override;
+    evutil_socket_t getFd() const override;
+
+    void setCallbacks(TCPStreamCallback onRead, TCPStreamCallback onWrite, TCPStreamEventCallback onEvent, void* ctx) override;
+    void enableRead() override;
+    void disableRead() override;
+    void setWriteLowWatermark(const size_t& watermark) override;
+    void close() override;
+};
+
+// socketless transport for driving the read path directly, input is appended by the caller and output is never sent
+struct MemoryStream : public TCPStream {
+private:
+    evbuffer* m_input = evbuffer_new();
+    evbuffer* m_output = evbuffer_new();
+public:
+    ~MemoryStream() {
+        evbuffer_free(m_input);
+        evbuffer_free(m_output);
+    }
+
+    evbuffer* getInput() override {
+        return m_input;
+    }
+    evbuffer* getOutput() override {
+        return m_output;
+    }
+    size_t getOutputLength() override {
+        return evbuffer_get_length(m_output);
+    }
+    evutil_socket_t getFd() const override {
+        return -1;
+    }
+
+    void setCallbacks(TCPStreamCallback, TCPStreamCallback, TCPStreamEventCallback, void*) override {}
+    void enableRead() override {}
+    void disableRead() override {}
+    void setWriteLowWatermark(const size_t&) override {}
+    void close() override {
+        delete this;
+    }
+};
+
+}
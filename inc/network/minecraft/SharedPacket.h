@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ZincPacket.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace zinc {
+
+// immutable packet for sending the same bytes to many connections (chat, entity movement, block updates)
+// the payload is serialized once, each framing is built once on first use and shared by every recipient,
+// only encryption is still applied per connection
+struct SharedPacket {
+private:
+    struct State {
+        ZincPacket m_packet;
+        std::once_flag m_isFramed[2]; // indexed by isCompressed
+        std::vector<char> m_frames[2];
+        bool m_isValid[2] = { false, false };
+    };
+    std::shared_ptr<State> m_state;
+public:
+    SharedPacket() {}
+    SharedPacket(ZincPacket packet);
+
+    int getId() const;
+    const ByteBuffer& getData() const;
+    // frame for a connection with the given compression state, nullptr if the packet is empty or framing failed
+    // compression uses the threshold and level configured when the frame is first requested
+    const std::vector<char>* getFrame(const bool& isCompressed) const;
+};
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace zinc {
+
+// IPv4 addresses are stored as IPv4-mapped IPv6 (::ffff:a.b.c.d)
+struct ZincAddressKey {
+    uint64_t m_high = 0, m_low = 0;
+
+    ZincAddressKey() {}
+    ZincAddressKey(const uint64_t& high, const uint64_t& low) : m_high(high), m_low(low) {}
+    ZincAddressKey(const struct sockaddr* addr);
+
+    bool isIPv4() const;
+    // IPv4 /24 or IPv6 /64
+    ZincAddressKey getSubnet() const;
+
+    bool operator==(const ZincAddressKey& key) const;
+    bool operator!=(const ZincAddressKey& key) const;
+};
+struct ZincAddressKeyHash {
+    size_t operator()(const ZincAddressKey& key) const;
+};
+struct ZincTokenBucket {
+    double m_tokens = 0;
+    std::chrono::steady_clock::time_point m_lastRefill;
+
+    // refills at rate tokens/s up to capacity and tells whether a token is available
+    bool canTake(const std::chrono::steady_clock::time_point& now, const double& rate, const double& capacity);
+    // refills like canTake and takes one token if available
+    bool take(const std::chrono::steady_clock::time_point& now, const double& rate, const double& capacity);
+    bool isFull(const std::chrono::steady_clock::time_point& now, const double& rate, const double& capacity) const;
+};
+// decides in onAccept whether a socket may be served at all, before any stream or ZincConnection exists
+struct ZincAdmissionController {
+private:
+    typedef std::list<std::pair<ZincAddressKey, bool>> IdleList; // (key, isSubnet), least recently used at the back
+    struct Entry {
+        ZincTokenBucket m_bucket;
+        int m_connections = 0;
+        IdleList::iterator m_idle; // valid while the entry is evictable: always for subnets, without open connections for addresses
+    };
+    typedef std::unordered_map<ZincAddressKey, Entry, ZincAddressKeyHash> EntryMap;
+    struct Shard {
+        std::mutex m_mutex;
+        EntryMap m_addresses, m_subnets;
+        IdleList m_idle;
+        std::chrono::steady_clock::time_point m_lastSweep;
+    };
+    std::array<Shard, 16> m_shards;
+
+    Shard& getShard(const ZincAddressKey& key);
+    void sweep(Shard& shard, const std::chrono::steady_clock::time_point& now);
+    // evicts idle entries until count more fit, except the given ones, false if only entries with open connections are left
+    bool makeRoom(Shard& shard, const size_t& count, const Entry* address, const Entry* subnet);
+    static double getAddressRate();
+    static double getSubnetRate();
+public:
+    static constexpr size_t MAX_ENTRIES_PER_SHARD = 8192; // keeps memory bounded under floods, a full shard evicts its least recently used idle entry
+    static constexpr int SWEEP_INTERVAL = 10; // seconds, entries are dropped once they are idle and their bucket is full again
+
+    // takes a connection slot for the address, every admitted connection must be released exactly once
+    // refused attempts never create entries, a new address or subnet starts with a full bucket
+    bool admit(const ZincAddressKey& key);
+    bool admit(const ZincAddressKey& key, const std::chrono::steady_clock::time_point& now);
+    void release(const ZincAddressKey& key);
+    size_t getTrackedAddresses();
+    size_t getTrackedSubnets();
+};
+extern ZincAdmissionController g_zincAdmissionController;
+
+}
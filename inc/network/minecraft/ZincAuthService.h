@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ZincConnection.h"
+#include <util/Logger.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace zinc {
+
+struct ZincAuthResult {
+    bool m_success = false;
+    bool m_unreachable = false;
+    std::string m_playerName;
+    uuids::uuid m_playerUUID;
+    std::vector<ZincConnectionProperty> m_properties;
+};
+struct ZincAuthRequest {
+    std::string m_playerName;
+    std::string m_serverId;
+    std::function<void(const ZincAuthResult&)> m_callback; // called on an auth worker thread
+};
+struct ZincAuthService {
+private:
+    Logger m_logger = Logger("ZincAuthService");
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<ZincAuthRequest> m_requests;
+    std::vector<std::thread> m_workers;
+    bool m_started = false;
+
+    void worker();
+    bool waitBeforeRetry(const int& attempt);
+    ZincAuthResult verify(const ZincAuthRequest& request);
+public:
+    static constexpr int MAX_ATTEMPTS = 3;
+    static constexpr int RETRY_BACKOFF_MILLISECONDS = 100; // doubled after every failed attempt
+    static constexpr size_t MAX_QUEUED_REQUESTS = 1024; // further logins are refused until the workers catch up
+
+    ~ZincAuthService() {
+        stop();
+    }
+
+    void start(const size_t& workers);
+    void stop();
+
+    // false if the queue is full, the callback is never called then
+    bool submit(const ZincAuthRequest& request);
+    size_t getQueueSize();
+};
+extern ZincAuthService g_zincAuthService;
+
+}
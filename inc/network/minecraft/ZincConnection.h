@@ -2,8 +2,14 @@
 
 #include "../TCPConnection.h"
 #include "ZincPacket.h"
+#include "SharedPacket.h"
+#include "ZincAdmissionController.h"
 #include <util/crypto/AES.h>
+#include <util/TimerWheel.h>
+#include <util/SlotMap.h>
 #include <external/UUID.h>
+#include <atomic>
+#include <functional>
 #include <mutex>
 #include <ZincConfig.h>
 
@@ -21,7 +27,7 @@ struct ZincConnectionInfo {
         int m_serverPort;
         int m_protocolVersion;
         std::vector<unsigned char> m_verifyToken;
-        long m_lastKeepAlive;
+        long m_lastKeepAlive = -1; // id of the unanswered keep alive, -1 if none
     } m_networkInfo;
     struct PlayerInfo {
         std::string m_playerName;
@@ -41,6 +47,7 @@ struct ZincConnectionInfo {
         enum class ParticleStatus : int { All, Decreased, Minimal } m_particleStatus;
     } m_settingsInfo;
 };
+typedef SlotMapHandle ConnectionHandle;
 struct ZincConnection {
 public:
     enum class State : unsigned char {
@@ -48,28 +55,52 @@ public:
     };
 private:
     TCPConnection m_tcpConnection;
-    State m_state;
-    bool m_isCompressed = false;
+    // atomic, ZincServer::broadcast reads both from other threads
+    std::atomic<State> m_state;
+    std::atomic<bool> m_isCompressed = false;
     bool m_isEncrypted = false;
 
     AESWrapper m_encrypt, m_decrypt;
+    evbuffer* m_decryptedInput = evbuffer_new();
+    evbuffer* m_frame = evbuffer_new();
+    evbuffer* m_outbound = evbuffer_new(); // frames waiting for the next flush
+    bool m_isFlushScheduled = false;
+    std::atomic<size_t> m_outputLength = 0; // bytes in the stream output as of the last flush or write callback
+    std::atomic<bool> m_isCongested = false;
+    bool m_isOverCap = false;
+
+    void scheduleFlush();
+    bool checkHardCap(const size_t& length);
+    void setCongested(const bool& isCongested);
 
     std::map<std::vector<unsigned char>, std::string> m_openedLoginPluginChannels;
 public:
+    static constexpr int MAX_DECOMPRESSED_LENGTH = 8388608;
+    static constexpr int INFLATE_PENDING = -3; // read() result carrying a still compressed frame, see ZincServer::onRead
+
     ZincConnectionInfo m_info;
-    int m_kickAtLogin = 0;
+    size_t m_reactorId = 0;
+    ConnectionHandle m_handle;
+    ZincAddressKey m_addressKey; // admission slot released when the connection is removed
+    TimerWheel::TimerId m_timeout, m_keepAliveTimer; // on the reactor's timer wheel
     bool m_loginFinished = false;
-    bool m_shouldContinue = true;
+    bool m_pendingAuth = false;
+    // reactor thread only, see ZincServer::offload
+    uint64_t m_offloadSequence = 0, m_offloadCompleted = 0;
+    std::map<uint64_t, std::function<void(ZincConnection*)>> m_offloadCompletions;
     std::mutex m_mutex;
 
     ZincConnection() : m_tcpConnection(TCPConnection()), m_state(State::Handshake) {}
     ZincConnection(const TCPConnection& connection) : m_tcpConnection(connection), m_state(State::Handshake) {}
+    ~ZincConnection() {
+        evbuffer_free(m_decryptedInput);
+        evbuffer_free(m_frame);
+        evbuffer_free(m_outbound);
+    }
 
     TCPConnection& getTCPConnection();
     TCPConnection getTCPConnection() const;
-    State& getState();
     State getState() const;
-    bool& getIsCompressed();
     bool getIsCompressed() const;
     bool& getIsEncrypted();
     bool getIsEncrypted() const;
@@ -82,12 +113,31 @@ public:
     void setupEncryption(const std::vector<unsigned char>& secret);
 
     ZincPacket read();
+    // decodes a compressed frame (data length prefix included), id -2 if it is malformed
+    static ZincPacket inflate(const char* frame, const size_t& length);
+    // true while auth or offloaded work is in flight, input stays buffered until then
+    bool hasPendingWork() const;
+    bool hasBufferedInput();
+    // queues the packet, queued packets are written once per event loop iteration or on flush()
     void send(const ZincPacket& packet);
-
+    // queues the frame shared with every other recipient, nothing is serialized or compressed again
+    void send(const SharedPacket& packet);
+    // queues bytes that are already framed for this connection's compression state
+    void sendFrames(const char* frames, const size_t& length);
+    void flush();
+    // called by the stream write callback once the output dropped to the low watermark
+    void onOutputDrained();
+    bool isCongested() const;
+    size_t getQueuedBytes();
+    static bool writeFrame(evbuffer* output, const ZincPacket& packet, const bool& isCompressed);
+
+    void sendKeepAlive(const long& id);
     void sendCookieRequest(const Identifier& cookieId);
-    ByteBuffer extractCookieData(ByteBuffer& cookieRawData);
+    static ByteBuffer extractCookieData(ByteBuffer& cookieRawData);
+    // call on the connection's reactor thread, the packet is queued before this returns
     void storeCookie(const Identifier& cookieId, const std::vector<char>& payload, long lifetime = -1);
     void storeCookie(const Identifier& cookieId, const ByteBuffer& payload, long lifetime = -1);
+    static void writeCookie(ByteBuffer& buffer, const Identifier& cookieId, const std::vector<char>& payload, const long& lifetime);
 
     void sendPluginMessage(const Identifier& pluginChannel, const std::vector<char>& data);
     void sendPluginMessage(const Identifier& pluginChannel, const ByteBuffer& data);
@@ -14,14 +14,16 @@ public:
     ZincPacket(const int& id, const ByteBuffer& data) : m_id(id) {
         setData(data);
     }
+    ZincPacket(const int& id, ByteBuffer&& data) : m_id(id), m_data(std::move(data)) {}
 
     int& getId();
     int getId() const;
     ByteBuffer& getData();
-    ByteBuffer getData() const;
+    const ByteBuffer& getData() const;
 
     void setId(const int& id);
     void setData(const ByteBuffer& data);
+    void setData(ByteBuffer&& data);
 
     bool operator==(const ZincPacket& packet) const;
     bool operator!=(const ZincPacket& packet) const;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ZincConnection.h"
+#include "ZincPacket.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace zinc {
+
+// returns false when the rest of the connection's buffered input must not be read in this callback
+// a handler may remove the connection, which usually frees it right away, so it must not touch the connection afterwards
+typedef std::function<bool(ZincConnection*, ZincPacket&)> ZincPacketHandler;
+struct ZincPacketStats {
+    ZincConnection::State m_state;
+    int m_id;
+    uint64_t m_calls, m_nanoseconds;
+};
+// serverbound handlers indexed by state and packet id, so dispatching a packet is one lookup and one call
+struct ZincPacketDispatcher {
+public:
+    static constexpr size_t STATE_COUNT = (size_t) ZincConnection::State::Play + 1;
+    static constexpr int MAX_PACKET_ID = 0x80; // exclusive, above every serverbound id of the supported protocol
+private:
+    struct Entry {
+        ZincPacketHandler m_handler;
+        std::atomic<uint64_t> m_calls = 0, m_nanoseconds = 0;
+    };
+    std::array<std::array<Entry, MAX_PACKET_ID>, STATE_COUNT> m_entries;
+    std::atomic<uint64_t> m_unhandled = 0;
+public:
+    // replaces any previous handler, must be called before the server starts
+    bool registerHandler(const ZincConnection::State& state, const int& id, const ZincPacketHandler& handler);
+    bool hasHandler(const ZincConnection::State& state, const int& id) const;
+    // ids without a handler are counted and skipped
+    bool dispatch(ZincConnection* connection, ZincPacket& packet);
+
+    // calls and time are only collected while Optimizations::m_packetMetrics is enabled
+    std::vector<ZincPacketStats> getStats() const;
+    uint64_t getUnhandledCount() const;
+    void resetStats();
+};
+
+}
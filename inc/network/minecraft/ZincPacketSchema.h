@@ -0,0 +1,291 @@
+#pragma once
+
+#include "ZincPacket.h"
+#include <type/ByteBuffer.h>
+#include <type/Identifier.h>
+#include <util/VarInt.h>
+#include <external/UUID.h>
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace zinc {
+
+// bounds-checked cursor over a contiguous payload, a short or malformed payload fails the whole decode once
+struct ZincPacketReader {
+    const char* m_data;
+    const char* m_end;
+    bool m_failed = false;
+
+    ZincPacketReader(const char* data, const char* end) : m_data(data), m_end(end) {}
+
+    size_t remaining() const {
+        return zinc_safe_cast<long, size_t>(m_end - m_data);
+    }
+    // nullptr (and the reader marked failed) if fewer than length bytes are left
+    const char* take(const size_t& length) {
+        if (remaining() < length) {
+            m_failed = true;
+            m_data = m_end;
+            return nullptr;
+        }
+        const char* result = m_data;
+        m_data += length;
+        return result;
+    }
+};
+
+// field codecs: each one knows its exact encoded size, writes into pre-reserved memory and reads from a ZincPacketReader
+namespace codec {
+
+template<typename T> struct Numeric {
+    using Type = T;
+    static constexpr size_t size(const T&) { return sizeof(T); }
+    static void write(char*& out, const T& value) {
+        if constexpr (sizeof(T) == 1) *out = (char) value;
+        else {
+            std::memcpy(out, &value, sizeof(T));
+            if constexpr (std::endian::native == std::endian::little) std::reverse(out, out + sizeof(T));
+        }
+        out += sizeof(T);
+    }
+    static void read(ZincPacketReader& in, T& value) {
+        const char* bytes = in.take(sizeof(T));
+        if (!bytes) return;
+        if constexpr (sizeof(T) == 1) value = (T) *bytes;
+        else if constexpr (std::endian::native == std::endian::little) std::reverse_copy(bytes, bytes + sizeof(T), (char*) &value);
+        else std::memcpy(&value, bytes, sizeof(T));
+    }
+};
+struct Boolean {
+    using Type = bool;
+    static constexpr size_t size(const bool&) { return 1; }
+    static void write(char*& out, const bool& value) {
+        *out++ = value ? 1 : 0;
+    }
+    static void read(ZincPacketReader& in, bool& value) {
+        const char* byte = in.take(1);
+        if (byte) value = *byte != 0;
+    }
+};
+template<typename T> struct VarNumeric {
+    using Type = T;
+    static size_t size(const T& value) { return VarInt::size(value); }
+    static void write(char*& out, const T& value) {
+        out += VarInt::encode(out, value);
+    }
+    static void read(ZincPacketReader& in, T& value) {
+        const int length = VarInt::decode(in.m_data, in.remaining(), value);
+        if (length <= 0) {
+            in.m_failed = true;
+            in.m_data = in.m_end;
+            return;
+        }
+        in.m_data += length;
+    }
+};
+template<typename E, typename Underlying = int> struct Enum {
+    using Type = E;
+    static size_t size(const E& value) { return VarNumeric<Underlying>::size((Underlying) value); }
+    static void write(char*& out, const E& value) { VarNumeric<Underlying>::write(out, (Underlying) value); }
+    static void read(ZincPacketReader& in, E& value) {
+        Underlying result = 0;
+        VarNumeric<Underlying>::read(in, result);
+        value = (E) result;
+    }
+};
+// VarInt length followed by the raw bytes, shared by strings and byte arrays
+template<typename Container> struct PrefixedBytes {
+    using Type = Container;
+    static size_t size(const Container& value) { return VarNumeric<int>::size(zinc_safe_cast<size_t, int>(value.size())) + value.size(); }
+    static void write(char*& out, const Container& value) {
+        VarNumeric<int>::write(out, zinc_safe_cast<size_t, int>(value.size()));
+        if (!value.empty()) std::memcpy(out, value.data(), value.size());
+        out += value.size();
+    }
+    static void read(ZincPacketReader& in, Container& value) {
+        int length = -1;
+        VarNumeric<int>::read(in, length);
+        if (length < 0 || zinc_safe_cast<int, size_t>(length) > in.remaining()) {
+            in.m_failed = true;
+            return;
+        }
+        const char* bytes = in.take(zinc_safe_cast<int, size_t>(length));
+        value.assign(bytes, bytes + length);
+    }
+};
+using String = PrefixedBytes<std::string>;
+using ByteArray = PrefixedBytes<std::vector<char>>;
+using UnsignedByteArray = PrefixedBytes<std::vector<unsigned char>>;
+struct Identifier {
+    using Type = zinc::Identifier;
+    static size_t size(const zinc::Identifier& value) { return String::size(value.toString()); }
+    static void write(char*& out, const zinc::Identifier& value) { String::write(out, value.toString()); }
+    static void read(ZincPacketReader& in, zinc::Identifier& value) {
+        std::string result;
+        String::read(in, result);
+        if (in.m_failed) return;
+        // zinc::Identifier can't split a value without a separator
+        size_t separator = result.find(':');
+        if (separator == std::string::npos) {
+            in.m_failed = true;
+            return;
+        }
+        value = zinc::Identifier(result.substr(0, separator), result.substr(separator + 1));
+    }
+};
+struct UUID {
+    using Type = uuids::uuid;
+    static constexpr size_t size(const uuids::uuid&) { return 16; }
+    static void write(char*& out, const uuids::uuid& value) {
+        std::memcpy(out, value.as_bytes().data(), 16);
+        out += 16;
+    }
+    static void read(ZincPacketReader& in, uuids::uuid& value) {
+        const char* bytes = in.take(16);
+        if (!bytes) return;
+        std::array<unsigned char, 16> result;
+        std::memcpy(result.data(), bytes, 16);
+        value = uuids::uuid(result);
+    }
+};
+// exactly N bytes without a length prefix
+template<size_t N> struct FixedBytes {
+    using Type = std::vector<unsigned char>;
+    static constexpr size_t size(const Type&) { return N; }
+    static void write(char*& out, const Type& value) {
+        if (!value.empty()) std::memcpy(out, value.data(), std::min(N, value.size()));
+        if (value.size() < N) std::memset(out + value.size(), 0, N - value.size());
+        out += N;
+    }
+    static void read(ZincPacketReader& in, Type& value) {
+        const char* bytes = in.take(N);
+        if (bytes) value.assign(bytes, bytes + N);
+    }
+};
+// everything left in the payload, only valid as the last field
+struct RemainingBytes {
+    using Type = std::vector<char>;
+    static size_t size(const Type& value) { return value.size(); }
+    static void write(char*& out, const Type& value) {
+        if (!value.empty()) std::memcpy(out, value.data(), value.size());
+        out += value.size();
+    }
+    static void read(ZincPacketReader& in, Type& value) {
+        size_t length = in.remaining();
+        const char* bytes = in.take(length);
+        value.assign(bytes, bytes + length);
+    }
+};
+template<typename Codec> struct PrefixedArray {
+    using Type = std::vector<typename Codec::Type>;
+    static size_t size(const Type& value) {
+        size_t result = VarNumeric<int>::size(zinc_safe_cast<size_t, int>(value.size()));
+        for (const typename Codec::Type& element : value) result += Codec::size(element);
+        return result;
+    }
+    static void write(char*& out, const Type& value) {
+        VarNumeric<int>::write(out, zinc_safe_cast<size_t, int>(value.size()));
+        for (const typename Codec::Type& element : value) Codec::write(out, element);
+    }
+    static void read(ZincPacketReader& in, Type& value) {
+        int length = -1;
+        VarNumeric<int>::read(in, length);
+        // every element takes at least one byte, which bounds the allocation by the payload size
+        if (length < 0 || zinc_safe_cast<int, size_t>(length) > in.remaining()) {
+            in.m_failed = true;
+            return;
+        }
+        value.resize(zinc_safe_cast<int, size_t>(length));
+        for (typename Codec::Type& element : value) Codec::read(in, element);
+    }
+};
+template<typename Codec> struct PrefixedOptional {
+    using Type = std::optional<typename Codec::Type>;
+    static size_t size(const Type& value) { return 1 + (value.has_value() ? Codec::size(value.value()) : 0); }
+    static void write(char*& out, const Type& value) {
+        Boolean::write(out, value.has_value());
+        if (value.has_value()) Codec::write(out, value.value());
+    }
+    static void read(ZincPacketReader& in, Type& value) {
+        bool hasValue = false;
+        Boolean::read(in, hasValue);
+        if (!hasValue) {
+            value.reset();
+            return;
+        }
+        value.emplace();
+        Codec::read(in, value.value());
+    }
+};
+
+}
+
+template<auto Member, typename Codec> struct ZincField;
+template<typename Struct, typename T, T Struct::* Member, typename Codec> struct ZincField<Member, Codec> {
+    static_assert(std::is_same_v<T, typename Codec::Type>, "field type does not match its codec");
+    static size_t size(const Struct& value) { return Codec::size(value.*Member); }
+    static void write(char*& out, const Struct& value) { Codec::write(out, value.*Member); }
+    static void read(ZincPacketReader& in, Struct& value) { Codec::read(in, value.*Member); }
+};
+// ordered field list of a packet or composite, everything below is generated from it
+template<typename... Fields> struct ZincFields {
+    template<typename Struct> static size_t size(const Struct& value) {
+        return (size_t(0) + ... + Fields::size(value));
+    }
+    template<typename Struct> static void write(char*& out, const Struct& value) {
+        (Fields::write(out, value), ...);
+    }
+    template<typename Struct> static void read(ZincPacketReader& in, Struct& value) {
+        (Fields::read(in, value), ...);
+    }
+};
+// types declare their layout as a nested Fields alias, types that can't be changed specialize this instead
+template<typename T> struct ZincSchema {
+    using Fields = typename T::Fields;
+};
+namespace codec {
+
+template<typename T> struct Struct {
+    using Type = T;
+    static size_t size(const T& value) { return ZincSchema<T>::Fields::size(value); }
+    static void write(char*& out, const T& value) { ZincSchema<T>::Fields::write(out, value); }
+    static void read(ZincPacketReader& in, T& value) { ZincSchema<T>::Fields::read(in, value); }
+};
+
+}
+
+// exact payload size of a packet, without its id
+template<typename T> size_t encodedSize(const T& packet) {
+    return ZincSchema<T>::Fields::size(packet);
+}
+// appends the payload to buffer with a single reservation
+template<typename T> void encodePacket(const T& packet, ByteBuffer& buffer) {
+    size_t writer = buffer.m_internalBuffer.getWriter();
+    size_t length = encodedSize(packet);
+    buffer.m_internalBuffer.setWriter(writer + length);
+    char* out = buffer.data() + writer;
+    ZincSchema<T>::Fields::write(out, packet);
+}
+template<typename T> ZincPacket encodePacket(const int& id, const T& packet) {
+    ZincPacket result (id);
+    encodePacket(packet, result.getData());
+    return result;
+}
+template<typename T> ZincPacket encodePacket(const T& packet) {
+    return encodePacket(T::ID, packet);
+}
+// reads from the buffer's reader position, false if the payload was short or malformed
+template<typename T> bool decodePacket(ByteBuffer& buffer, T& packet) {
+    ZincPacketReader reader (buffer.data() + buffer.getReaderPointer(), buffer.data() + buffer.size());
+    ZincSchema<T>::Fields::read(reader, packet);
+    buffer.m_internalBuffer.setReader(zinc_safe_cast<long, size_t>(reader.m_data - buffer.data()));
+    return !reader.m_failed;
+}
+template<typename T> bool decodePacket(ZincPacket& packet, T& result) {
+    return decodePacket(packet.getData(), result);
+}
+
+}
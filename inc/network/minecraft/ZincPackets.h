@@ -0,0 +1,243 @@
+#pragma once
+
+#include "ZincConnection.h"
+#include "ZincPacketSchema.h"
+
+namespace zinc {
+
+template<> struct ZincSchema<ZincConnectionProperty> {
+    using Fields = ZincFields<
+        ZincField<&ZincConnectionProperty::m_name, codec::String>,
+        ZincField<&ZincConnectionProperty::m_value, codec::String>,
+        ZincField<&ZincConnectionProperty::m_signature, codec::PrefixedOptional<codec::String>>>;
+};
+template<> struct ZincSchema<ZincConnectionInfo::SettingsInfo> {
+    typedef ZincConnectionInfo::SettingsInfo SettingsInfo;
+    using Fields = ZincFields<
+        ZincField<&SettingsInfo::m_locale, codec::String>,
+        ZincField<&SettingsInfo::m_renderDistance, codec::Numeric<unsigned char>>,
+        ZincField<&SettingsInfo::m_chatMode, codec::Enum<SettingsInfo::ChatMode>>,
+        ZincField<&SettingsInfo::m_enableChatColors, codec::Boolean>,
+        ZincField<&SettingsInfo::m_skinParts, codec::Numeric<unsigned char>>,
+        ZincField<&SettingsInfo::m_mainHand, codec::Enum<SettingsInfo::MainHand>>,
+        ZincField<&SettingsInfo::m_enableTextFiltering, codec::Boolean>,
+        ZincField<&SettingsInfo::m_idkWhyIEvenListItHereButOk__enableServerListing, codec::Boolean>,
+        ZincField<&SettingsInfo::m_particleStatus, codec::Enum<SettingsInfo::ParticleStatus>>>;
+};
+
+// packets used in more than one state have no ID, pass it to encodePacket instead
+
+/* HANDSHAKE */
+
+struct HandshakePacket {
+    static constexpr int ID = 0;
+    int m_protocolVersion = 0;
+    std::string m_serverAddr;
+    unsigned short m_serverPort = 0;
+    int m_nextState = 0;
+    using Fields = ZincFields<
+        ZincField<&HandshakePacket::m_protocolVersion, codec::VarNumeric<int>>,
+        ZincField<&HandshakePacket::m_serverAddr, codec::String>,
+        ZincField<&HandshakePacket::m_serverPort, codec::Numeric<unsigned short>>,
+        ZincField<&HandshakePacket::m_nextState, codec::VarNumeric<int>>>;
+};
+
+/* STATUS */
+
+struct StatusRequestPacket {
+    static constexpr int ID = 0;
+    using Fields = ZincFields<>;
+};
+struct StatusResponsePacket {
+    static constexpr int ID = 0;
+    std::string m_response;
+    using Fields = ZincFields<ZincField<&StatusResponsePacket::m_response, codec::String>>;
+};
+// also the Status Pong Response, which echoes the payload
+struct PingRequestPacket {
+    static constexpr int ID = 1;
+    int64_t m_timestamp = 0;
+    using Fields = ZincFields<ZincField<&PingRequestPacket::m_timestamp, codec::Numeric<int64_t>>>;
+};
+
+/* LOGIN */
+
+struct LoginStartPacket {
+    static constexpr int ID = 0;
+    std::string m_playerName;
+    uuids::uuid m_playerUUID;
+    using Fields = ZincFields<
+        ZincField<&LoginStartPacket::m_playerName, codec::String>,
+        ZincField<&LoginStartPacket::m_playerUUID, codec::UUID>>;
+};
+struct EncryptionRequestPacket {
+    static constexpr int ID = 1;
+    std::string m_serverId;
+    std::vector<unsigned char> m_publicKey, m_verifyToken;
+    bool m_shouldAuthenticate = true;
+    using Fields = ZincFields<
+        ZincField<&EncryptionRequestPacket::m_serverId, codec::String>,
+        ZincField<&EncryptionRequestPacket::m_publicKey, codec::UnsignedByteArray>,
+        ZincField<&EncryptionRequestPacket::m_verifyToken, codec::UnsignedByteArray>,
+        ZincField<&EncryptionRequestPacket::m_shouldAuthenticate, codec::Boolean>>;
+};
+struct EncryptionResponsePacket {
+    static constexpr int ID = 1;
+    std::vector<unsigned char> m_sharedSecret, m_verifyToken;
+    using Fields = ZincFields<
+        ZincField<&EncryptionResponsePacket::m_sharedSecret, codec::UnsignedByteArray>,
+        ZincField<&EncryptionResponsePacket::m_verifyToken, codec::UnsignedByteArray>>;
+};
+struct LoginSuccessPacket {
+    static constexpr int ID = 2;
+    uuids::uuid m_playerUUID;
+    std::string m_playerName;
+    std::vector<ZincConnectionProperty> m_properties;
+    using Fields = ZincFields<
+        ZincField<&LoginSuccessPacket::m_playerUUID, codec::UUID>,
+        ZincField<&LoginSuccessPacket::m_playerName, codec::String>,
+        ZincField<&LoginSuccessPacket::m_properties, codec::PrefixedArray<codec::Struct<ZincConnectionProperty>>>>;
+};
+struct SetCompressionPacket {
+    static constexpr int ID = 3;
+    int m_threshold = 0;
+    using Fields = ZincFields<ZincField<&SetCompressionPacket::m_threshold, codec::VarNumeric<int>>>;
+};
+struct LoginPluginResponsePacket {
+    static constexpr int ID = 2;
+    std::vector<unsigned char> m_messageId;
+    std::vector<char> m_data;
+    using Fields = ZincFields<
+        ZincField<&LoginPluginResponsePacket::m_messageId, codec::FixedBytes<4>>,
+        ZincField<&LoginPluginResponsePacket::m_data, codec::RemainingBytes>>;
+};
+struct LoginAcknowledgedPacket {
+    static constexpr int ID = 3;
+    using Fields = ZincFields<>;
+};
+
+/* LOGIN, CONFIG & PLAY */
+
+struct CookieRequestPacket {
+    Identifier m_key;
+    using Fields = ZincFields<ZincField<&CookieRequestPacket::m_key, codec::Identifier>>;
+};
+struct CookieResponsePacket {
+    Identifier m_key;
+    std::optional<std::vector<char>> m_payload;
+    using Fields = ZincFields<
+        ZincField<&CookieResponsePacket::m_key, codec::Identifier>,
+        ZincField<&CookieResponsePacket::m_payload, codec::PrefixedOptional<codec::ByteArray>>>;
+};
+
+/* CONFIG */
+
+struct ClientInformationPacket {
+    static constexpr int ID = 0;
+    ZincConnectionInfo::SettingsInfo m_settings;
+    using Fields = ZincFields<ZincField<&ClientInformationPacket::m_settings, codec::Struct<ZincConnectionInfo::SettingsInfo>>>;
+};
+struct FinishConfigurationPacket {
+    static constexpr int ID = 3;
+    using Fields = ZincFields<>;
+};
+struct AcknowledgeFinishConfigurationPacket {
+    static constexpr int ID = 3;
+    using Fields = ZincFields<>;
+};
+struct ConfigPingPacket {
+    static constexpr int ID = 5;
+    std::vector<unsigned char> m_id;
+    using Fields = ZincFields<ZincField<&ConfigPingPacket::m_id, codec::FixedBytes<4>>>;
+};
+struct ConfigPongPacket {
+    static constexpr int ID = 5;
+    std::vector<unsigned char> m_id;
+    using Fields = ZincFields<ZincField<&ConfigPongPacket::m_id, codec::FixedBytes<4>>>;
+};
+struct KnownPacksPacket {
+    static constexpr int ID = 12;
+    std::vector<Identifier> m_packs;
+    using Fields = ZincFields<ZincField<&KnownPacksPacket::m_packs, codec::PrefixedArray<codec::Identifier>>>;
+};
+
+/* CONFIG & PLAY */
+
+struct PluginMessagePacket {
+    Identifier m_channel;
+    std::vector<char> m_data;
+    using Fields = ZincFields<
+        ZincField<&PluginMessagePacket::m_channel, codec::Identifier>,
+        ZincField<&PluginMessagePacket::m_data, codec::RemainingBytes>>;
+};
+struct KeepAlivePacket {
+    int64_t m_id = 0;
+    using Fields = ZincFields<ZincField<&KeepAlivePacket::m_id, codec::Numeric<int64_t>>>;
+};
+
+/* PLAY */
+
+struct ConfirmTeleportationPacket {
+    static constexpr int ID = 0;
+    int m_teleportId = 0;
+    using Fields = ZincFields<ZincField<&ConfirmTeleportationPacket::m_teleportId, codec::VarNumeric<int>>>;
+};
+struct SynchronizePlayerPositionPacket {
+    static constexpr int ID = 0x41;
+    int m_teleportId = 0;
+    double m_x = 0, m_y = 0, m_z = 0;
+    double m_velocityX = 0, m_velocityY = 0, m_velocityZ = 0;
+    float m_yaw = 0, m_pitch = 0;
+    int m_flags = 0; // TeleportFlags::encode()
+    using Fields = ZincFields<
+        ZincField<&SynchronizePlayerPositionPacket::m_teleportId, codec::VarNumeric<int>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_x, codec::Numeric<double>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_y, codec::Numeric<double>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_z, codec::Numeric<double>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_velocityX, codec::Numeric<double>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_velocityY, codec::Numeric<double>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_velocityZ, codec::Numeric<double>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_yaw, codec::Numeric<float>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_pitch, codec::Numeric<float>>,
+        ZincField<&SynchronizePlayerPositionPacket::m_flags, codec::Numeric<int>>>;
+};
+// movement flags of the serverbound movement packets: 1 on ground, 2 pushing against a wall
+struct SetPlayerPositionPacket {
+    static constexpr int ID = 0x1C;
+    double m_x = 0, m_y = 0, m_z = 0;
+    unsigned char m_flags = 0;
+    using Fields = ZincFields<
+        ZincField<&SetPlayerPositionPacket::m_x, codec::Numeric<double>>,
+        ZincField<&SetPlayerPositionPacket::m_y, codec::Numeric<double>>,
+        ZincField<&SetPlayerPositionPacket::m_z, codec::Numeric<double>>,
+        ZincField<&SetPlayerPositionPacket::m_flags, codec::Numeric<unsigned char>>>;
+};
+struct SetPlayerPositionAndRotationPacket {
+    static constexpr int ID = 0x1D;
+    double m_x = 0, m_y = 0, m_z = 0;
+    float m_yaw = 0, m_pitch = 0;
+    unsigned char m_flags = 0;
+    using Fields = ZincFields<
+        ZincField<&SetPlayerPositionAndRotationPacket::m_x, codec::Numeric<double>>,
+        ZincField<&SetPlayerPositionAndRotationPacket::m_y, codec::Numeric<double>>,
+        ZincField<&SetPlayerPositionAndRotationPacket::m_z, codec::Numeric<double>>,
+        ZincField<&SetPlayerPositionAndRotationPacket::m_yaw, codec::Numeric<float>>,
+        ZincField<&SetPlayerPositionAndRotationPacket::m_pitch, codec::Numeric<float>>,
+        ZincField<&SetPlayerPositionAndRotationPacket::m_flags, codec::Numeric<unsigned char>>>;
+};
+struct SetPlayerRotationPacket {
+    static constexpr int ID = 0x1E;
+    float m_yaw = 0, m_pitch = 0;
+    unsigned char m_flags = 0;
+    using Fields = ZincFields<
+        ZincField<&SetPlayerRotationPacket::m_yaw, codec::Numeric<float>>,
+        ZincField<&SetPlayerRotationPacket::m_pitch, codec::Numeric<float>>,
+        ZincField<&SetPlayerRotationPacket::m_flags, codec::Numeric<unsigned char>>>;
+};
+struct SetPlayerMovementFlagsPacket {
+    static constexpr int ID = 0x1F;
+    unsigned char m_flags = 0;
+    using Fields = ZincFields<ZincField<&SetPlayerMovementFlagsPacket::m_flags, codec::Numeric<unsigned char>>>;
+};
+
+}
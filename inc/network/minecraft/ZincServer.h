@@ -2,27 +2,85 @@
 
 #include "../TCPServer.h"
 #include "ZincConnection.h"
+#include "ZincPacketDispatcher.h"
 #include <util/crypto/RSA.h>
+#include <util/EpochReclaimer.h>
+#include <util/WorkerPool.h>
+#include <atomic>
+#include <deque>
 #include <mutex>
 
 namespace zinc {
 
+// state for a connection that hasn't finished its handshake yet, see Optimizations::m_statusFastPath
+// and Security::m_proxyProtocol
+struct ZincPendingConnection {
+    TCPReactor* m_reactor = nullptr;
+    sockaddr_storage m_addr;
+    ZincAddressKey m_addressKey;
+    TimerWheel::TimerId m_timeout;
+    bool m_isStatus = false;
+    bool m_statusAnswered = false, m_pingAnswered = false; // one of each is answered, like vanilla
+    bool m_awaitingProxyHeader = false; // admission waits for the client address from the PROXY header
+};
 struct ZincServer {
 private:
     bool m_init, m_started = false;
     TCPServer m_server;
     int m_port;
-    std::unordered_map<evutil_socket_t, ZincConnection*> m_clients;
-    std::unordered_map<std::string, long> m_rateLimiterData;
-    std::unordered_map<std::string, int> m_concurrentAccounts;
+    SlotMap<ZincConnection> m_clients;
+    ZincPacketDispatcher m_dispatcher;
+    WorkerPool m_workers;
+    std::vector<ZincAddressKey> m_trustedProxies;
     RSAWrapper m_rsa = RSAWrapper(RSA_PKCS1_PADDING);
+
+    void registerDefaultHandlers();
+    static bool handleHandshake(ZincConnection* connection, ZincPacket& packet);
+    static bool handleStatusRequest(ZincConnection* connection, ZincPacket& packet);
+    static bool handlePingRequest(ZincConnection* connection, ZincPacket& packet);
+    static bool handleLoginStart(ZincConnection* connection, ZincPacket& packet);
+    static bool handleEncryptionResponse(ZincConnection* connection, ZincPacket& packet);
+    static bool handleLoginPluginResponse(ZincConnection* connection, ZincPacket& packet);
+    static bool handleLoginAcknowledged(ZincConnection* connection, ZincPacket& packet);
+    static bool handleCookieResponse(ZincConnection* connection, ZincPacket& packet);
+    static bool handleClientInformation(ZincConnection* connection, ZincPacket& packet);
+    static bool handlePluginMessage(ZincConnection* connection, ZincPacket& packet);
+    static bool handleConfigAcknowledged(ZincConnection* connection, ZincPacket& packet);
+    static bool handleKeepAlivePacket(ZincConnection* connection, ZincPacket& packet);
+    static bool handleConfigPong(ZincConnection* connection, ZincPacket& packet);
+
+    static void completeEncryption(ZincConnection* connection, const std::vector<unsigned char>& sharedSecret);
+    static void completeLogin(ZincConnection* connection);
+    static ZincConnection* acceptConnection(TCPStream* stream, TCPReactor* reactor, struct sockaddr* addr, const ZincAddressKey& addressKey);
+    static void closePending(TCPStream* stream, ZincPendingConnection* pending);
+    static void promotePending(TCPStream* stream, ZincPendingConnection* pending);
+    bool expectsProxyHeader(const ZincAddressKey& peer) const;
+    static void setTimeout(ZincConnection* connection, const int& seconds, const std::string& reason);
+    static void scheduleKeepAlive(ZincConnection* connection, const uint64_t& delayMilliseconds);
+    static void sendKeepAlive(ZincConnection* connection);
+    static void handleKeepAlive(ZincConnection* connection, const int64_t& keepAlive);
+    static bool writePending(TCPStream* stream, const void* data, const size_t& length);
+    // re-enables reading once nothing is pending anymore and handles the input buffered meanwhile
+    static void resumeRead(ZincConnection* connection);
+    static void onPendingRead(TCPStream* stream, void* ptr);
+    static void onPendingWrite(TCPStream* stream, void* ptr);
+    static void onPendingEvent(TCPStream* stream, short events, void* ptr);
 public:
-    int m_onlinePlayers = 0;
+    enum class OffloadStage : size_t {
+        RSA, Cookie, Inflate
+    };
+    static constexpr int MAX_PENDING_FRAME_LENGTH = 1024; // handshake, status request and ping are all far smaller
+
+    std::atomic<int> m_onlinePlayers = 0;
     std::mutex m_mutex;
     RSAWrapper m_cookieRSA;
 
-    ZincServer() : m_init(true), m_server(25565, onAccept), m_port(25565) {}
-    ZincServer(const unsigned short& port) : m_init(true), m_server(port, onAccept), m_port(port) {}
+    ZincServer() : m_init(true), m_server(25565, onAccept), m_port(25565) {
+        registerDefaultHandlers();
+    }
+    ZincServer(const unsigned short& port) : m_init(true), m_server(port, onAccept), m_port(port) {
+        registerDefaultHandlers();
+    }
     ~ZincServer() {
         if (m_init) stop();
     }
@@ -31,20 +89,37 @@ public:
     void stop();
 
     void setPort(const int& port);
+    void setReactorCount(const size_t& reactorCount);
+    void post(const size_t& reactorId, const std::function<void()>& task);
+    TimerWheel::TimerId schedule(const size_t& reactorId, const uint64_t& delayMilliseconds, const std::function<void()>& callback);
+    bool cancel(const size_t& reactorId, TimerWheel::TimerId& id);
+    // call on the connection's reactor thread: work runs on the worker pool, completion back on the reactor
+    // completions of one connection run in submission order and reading is paused until all of them ran
+    void offload(ZincConnection* connection, const OffloadStage& stage, const std::function<void()>& work,
+                 const std::function<void(ZincConnection*)>& completion);
+    WorkerStageStats getOffloadStats(const OffloadStage& stage) const;
 
     RSAWrapper& getRSA();
     RSAWrapper getRSA() const;
+    // plugins register or replace serverbound packet handlers here before the server starts
+    ZincPacketDispatcher& getPacketDispatcher();
 
-    void addClient(ZincConnection* client);
-    bool isConnected(evutil_socket_t fd) const;
-    void removeClient(evutil_socket_t fd);
-    ZincConnection* getClient(evutil_socket_t fd);
+    // lookups are lock-free, off the connection's reactor thread keep g_epochReclaimer.pin() alive while using the result
+    ConnectionHandle addClient(ZincConnection* client);
+    bool isConnected(const ConnectionHandle& handle) const;
+    ZincConnection* getClient(const ConnectionHandle& handle) const;
+    size_t getClientCount() const;
+    // must run on the connection's reactor thread, the connection is deleted once no pinned thread can see it
+    void removeClient(const ConnectionHandle& handle);
+    // sends the packet to every connection in Play accepted by filter (every one if it's empty), callable from any thread
+    void broadcast(const SharedPacket& packet, const std::function<bool(ZincConnection*)>& filter = nullptr);
 
     static void onAccept(evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr);
-    static void onRead(bufferevent* bev, void* ptr);
-    static void onEvent(bufferevent *bev, short events, void *ctx);
+    static void onRead(TCPStream* stream, void* ptr);
+    static void onWrite(TCPStream* stream, void* ptr);
+    static void onEvent(TCPStream* stream, short events, void *ctx);
 };
 
 extern ZincServer g_zincServer;
 
-}
\ No newline at end of file
+}
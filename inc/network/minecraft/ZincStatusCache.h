@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace zinc {
+
+// keeps the framed Status Response so server list pings don't rebuild and dump the JSON every time
+struct ZincStatusCache {
+private:
+    std::mutex m_mutex;
+    std::shared_ptr<const std::vector<char>> m_frame;
+    int m_onlinePlayers = 0, m_maxPlayerCount = 0;
+
+    std::shared_ptr<const std::vector<char>> build();
+public:
+    // returns the uncompressed, unencrypted Status Response frame, rebuilt if the player counts changed or after invalidate()
+    std::shared_ptr<const std::vector<char>> getFrame();
+    // MOTD and icon changes go through here, so pings only compare the player counts
+    void setMotd(const std::string& motd);
+    void setIcon(const std::string& iconBase64);
+    void invalidate();
+};
+extern ZincStatusCache g_zincStatusCache;
+
+}
@@ -29,8 +29,8 @@ public:
     SrvCtlConnection* getClient(evutil_socket_t fd);
 
     static void onAccept(evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr);
-    static void onRead(bufferevent* bev, void* ptr);
-    static void onEvent(bufferevent *bev, short events, void *ctx);
+    static void onRead(TCPStream* stream, void* ptr);
+    static void onEvent(TCPStream* stream, short events, void *ctx);
 };
 
 extern SrvCtlServer g_srvCtlServer;
@@ -12,18 +12,18 @@ namespace zinc {
 
 template<typename T> struct Registry {
     std::unordered_map<std::string, int> m_registryData;
-    std::unordered_map<std::string, std::function<std::vector<char>(const T&)>> m_writers;
+    std::unordered_map<std::string, std::function<void(const T&, ByteBuffer&)>> m_writers; // write in place into the target buffer
     std::unordered_map<std::string, std::function<NBTElement(const T&)>> m_nbtWriters;
     std::unordered_map<std::string, std::function<T(ByteBuffer&)>> m_readers;
     Identifier m_defaultIdentifier = Identifier("minecraft", "default");
 
     Registry() {}
     Registry(const std::unordered_map<std::string, int>& registryData, 
-             const std::unordered_map<std::string, std::function<std::vector<char>(const T&)>>& writers,
+             const std::unordered_map<std::string, std::function<void(const T&, ByteBuffer&)>>& writers,
              const std::unordered_map<std::string, std::function<T(ByteBuffer&)>>& readers, const Identifier& defaultIdentifier) 
         : m_registryData(registryData), m_writers(writers), m_readers(readers), m_defaultIdentifier(defaultIdentifier) {}
     Registry(const std::unordered_map<std::string, int>& registryData, 
-             const std::unordered_map<std::string, std::function<std::vector<char>(const T&)>>& writers,
+             const std::unordered_map<std::string, std::function<void(const T&, ByteBuffer&)>>& writers,
              const std::unordered_map<std::string, std::function<T(ByteBuffer&)>>& readers,
              const std::unordered_map<std::string, std::function<T(ByteBuffer&)>>& nbtWriters, const Identifier& defaultIdentifier) 
         : m_registryData(registryData), m_writers(writers), m_nbtWriters(nbtWriters), m_readers(readers), m_defaultIdentifier(defaultIdentifier) {}
@@ -32,13 +32,13 @@ template<typename T> struct Registry {
         for (const auto& registryValue : m_registryData) if (registryValue.second == value) return Identifier(registryValue.first);
         return m_defaultIdentifier;
     }
-    void registerValue(const Identifier& identifier, const std::function<std::vector<char>(const T&)>& writer, 
+    void registerValue(const Identifier& identifier, const std::function<void(const T&, ByteBuffer&)>& writer, 
                        const std::function<T(ByteBuffer&)>& reader, const int& value) {
         m_registryData.emplace(identifier.toString(), value);
         m_writers.emplace(identifier.toString(), writer);
         m_readers.emplace(identifier.toString(), reader);
     }
-    void registerValue(const Identifier& identifier, const std::function<std::vector<char>(const T&)>& writer, 
+    void registerValue(const Identifier& identifier, const std::function<void(const T&, ByteBuffer&)>& writer, 
                        const std::function<T(ByteBuffer&)>& reader, const std::unordered_map<std::string, std::function<T(ByteBuffer&)>>& nbtWriter, 
                        const int& value) {
         m_registryData.emplace(identifier.toString(), value);
@@ -61,9 +61,13 @@ extern Registry<SlotDisplayData> g_slotDisplayRegistry;
 extern Registry<char> g_mushroomVariantsRegistry;
 extern std::unordered_map<std::string, std::unordered_map<std::string, NBTElement>> g_registries;
 
+// channel and cookie callbacks may remove the connection, the server checks it's still connected before using it again
+// init channels only build the payload and must not remove the connection, post() the kick to its reactor instead
 extern std::unordered_map<std::string, std::function<void(ByteBuffer&, ZincConnection*)>> g_zincServerPluginChannels;
 extern std::unordered_map<std::string, std::function<void(std::optional<std::vector<char>>&, ZincConnection*)>> g_zincCookieResponseParsers;
 extern std::unordered_map<ZincConnection::State, std::vector<std::string>> g_zincCookieRequests;
 extern std::unordered_map<ZincConnection::State, std::unordered_map<std::string, std::function<ByteBuffer(ZincConnection*)>>> g_zincServerInitPluginChannels;
+// called on the connection's reactor thread when its outbound queue crosses the high (true) or low (false) watermark
+extern std::vector<std::function<void(ZincConnection*, const bool&)>> g_zincCongestionListeners;
 
 }
\ No newline at end of file
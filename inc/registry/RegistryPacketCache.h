@@ -0,0 +1,31 @@
+#pragma once
+
+#include <util/Logger.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace zinc {
+
+// Registry Data packets are identical for every player, so they are serialized, compressed and framed once
+// and the resulting bytes are copied into each connection's output during Configuration
+struct RegistryPacketCache {
+private:
+    Logger m_logger = Logger("RegistryPacketCache");
+    std::mutex m_mutex;
+    std::shared_ptr<const std::vector<char>> m_frames[2]; // indexed by isCompressed
+    std::vector<size_t> m_snapshot;
+    int m_threshold = 0;
+    int m_compressionLevel = 0;
+
+    std::vector<size_t> takeSnapshot() const;
+    std::shared_ptr<const std::vector<char>> build(const bool& isCompressed);
+public:
+    // returns every Registry Data packet framed for a connection with the given compression state
+    std::shared_ptr<const std::vector<char>> getFrames(const bool& isCompressed);
+    // must be called after g_registries is mutated in a way that keeps the entry counts unchanged
+    void invalidate();
+};
+extern RegistryPacketCache g_registryPacketCache;
+
+}
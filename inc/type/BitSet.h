@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 
 namespace zinc {
 
@@ -32,6 +33,9 @@ struct BitSet {
     bool operator==(const BitSet& other) const;
     bool operator!=(const BitSet& other) const;
 
+    // number of longs up to the highest set bit, what toLongArray returns and the network form carries
+    size_t longCount() const;
+    size_t encodedSize() const;
     std::vector<unsigned long> toLongArray() const;
     std::vector<unsigned char> toByteArray() const;
     static BitSet fromLongArray(const std::vector<unsigned long>& longs);
@@ -7,7 +7,9 @@
 #include <optional>
 #include <type_traits>
 #include <array>
-#include <deque>
+#include <span>
+#include <cstring>
+#include <string_view>
 
 #include <util/Logger.h>
 #include <external/UUID.h>
@@ -29,6 +31,8 @@
 #include "ChunkData.h"
 #include "XorY.h"
 #include <util/Memory.h>
+#include <util/VarInt.h>
+#include <util/ByteSwap.h>
 #include "nbt/NBTElement.h"
 
 namespace zinc {
@@ -61,34 +65,52 @@ struct SlotDisplayData {
 };
 struct ByteBuffer {
     Logger m_logger = Logger("ByteBuffer");
+    // contiguous growable storage: small payloads stay inline, larger ones come from a per-thread slab arena
     struct InternalByteBuffer {
     public:
-        static constexpr size_t BLOCK_SIZE = 4096;
+        static constexpr size_t INLINE_SIZE = 64;
     private:
-        Logger m_logger = Logger("InternalByteBuffer");
-        std::deque<std::vector<char>> m_blocks;
-        size_t m_writeBlock = 0, m_writeOffset = 0;
-        size_t m_readBlock = 0, m_readOffset = 0;
-        std::mutex m_mutex;
+        std::array<char, INLINE_SIZE> m_inline;
+        char* m_data = m_inline.data();
+        size_t m_capacity = INLINE_SIZE;
+        size_t m_writeOffset = 0, m_readOffset = 0;
 
-        bool m_enableBlockRecycle = false;
+        bool m_enableBlockRecycle = false; // drop already read bytes instead of growing
+        bool m_readFailed = false; // sticky until clear(), set by any short or malformed read
+
+        bool isInline() const;
+        void grow(const size_t& length);
+        void release() noexcept;
     public:
-        InternalByteBuffer();
+        InternalByteBuffer() {}
+        InternalByteBuffer(InternalByteBuffer&& buffer) noexcept;
+        InternalByteBuffer(const InternalByteBuffer&) = delete;
+        InternalByteBuffer& operator=(InternalByteBuffer&& buffer) noexcept;
+        InternalByteBuffer& operator=(const InternalByteBuffer&) = delete;
         ~InternalByteBuffer();
 
         void clear() noexcept;
+        void reserve(const size_t& capacity);
 
         void write(const char* data, const size_t& length);
         std::vector<char> read(const size_t& length);
+        // advances the reader and returns the consumed bytes in place, nullptr if fewer are available
+        const char* consume(const size_t& length);
+
+        char* data();
+        const char* data() const;
+        size_t capacity() const;
 
         bool& areBlocksRecycled();
         bool areBlocksRecycled() const;
-        std::pair<size_t, size_t> getReader() const;
-        std::pair<size_t, size_t> getWriter() const;
+        bool hasReadFailed() const;
+        size_t getReader() const;
+        size_t getWriter() const;
 
         void toggleBlockRecycle(const bool& state);
-        void setReader(const std::pair<size_t, size_t>& reader);
-        void setWriter(const std::pair<size_t, size_t>& writer);
+        void setReader(const size_t& reader);
+        void setWriter(const size_t& writer);
+        void setReadFailed(const bool& readFailed);
 
         std::vector<char> getBytes() const;
 
@@ -100,21 +122,18 @@ struct ByteBuffer {
     ByteBuffer() : m_isBigEndian(true) {}
     ByteBuffer(const bool& isBigEndian) : m_isBigEndian(isBigEndian) {}
     ByteBuffer(const std::vector<char>& bytes, const size_t& readPtr = 0) : m_isBigEndian(true) {
-        size_t readBlock = (readPtr / InternalByteBuffer::BLOCK_SIZE);
-        size_t readOffset = (readPtr % InternalByteBuffer::BLOCK_SIZE);
         m_internalBuffer.write(bytes.data(), bytes.size());
-        m_internalBuffer.setReader(std::make_pair(readBlock, readOffset));
+        m_internalBuffer.setReader(readPtr);
     }
     ByteBuffer(const std::vector<char>& bytes, const size_t& readPtr, const bool& isBigEndian) : m_isBigEndian(isBigEndian) {
-        size_t readBlock = (readPtr / InternalByteBuffer::BLOCK_SIZE);
-        size_t readOffset = (readPtr % InternalByteBuffer::BLOCK_SIZE);
         m_internalBuffer.write(bytes.data(), bytes.size());
-        m_internalBuffer.setReader(std::make_pair(readBlock, readOffset));
+        m_internalBuffer.setReader(readPtr);
     }
-    ByteBuffer(ByteBuffer&& buffer) : m_isBigEndian(buffer.m_isBigEndian) {
-        std::vector<char> bytes = buffer.m_internalBuffer.getBytes();
-        m_internalBuffer.write(bytes.data(), bytes.size());
-        m_internalBuffer.setReader(buffer.m_internalBuffer.getReader());
+    ByteBuffer(ByteBuffer&& buffer) noexcept : m_internalBuffer(std::move(buffer.m_internalBuffer)), m_isBigEndian(buffer.m_isBigEndian) {}
+    ByteBuffer& operator=(ByteBuffer&& buffer) noexcept {
+        m_internalBuffer = std::move(buffer.m_internalBuffer);
+        m_isBigEndian = buffer.m_isBigEndian;
+        return *this;
     }
 
     void clear() noexcept;
@@ -122,10 +141,36 @@ struct ByteBuffer {
     std::vector<char> getBytes() const;
     size_t size() const;
     size_t getReaderPointer() const;
+    // whole written contents without copying, valid until the next write
+    char* data();
+    const char* data() const;
+    std::span<const char> getSpan() const;
 
     void writeBytes(const std::vector<char>& bytes);
+    void writeBytes(std::span<const char> bytes);
+    // makes room for length more bytes, so the writes of an already sized value don't reallocate
+    void reserveWrite(const size_t& length);
     std::vector<char> readBytes(const size_t& length);
 
+    // non-allocating reads: views point into the storage and stay valid until the next write or clear
+    // nothing throws, a short read returns nullopt/false/an empty view and marks the buffer, see hasReadFailed
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> std::optional<T> peek() const {
+        const size_t reader = m_internalBuffer.getReader();
+        if (m_internalBuffer.getWriter() - reader < sizeof(T)) return std::nullopt;
+        const char* bytes = m_internalBuffer.data() + reader;
+        if constexpr (std::is_same_v<T, bool>) return *bytes != 0;
+        T result;
+        if (m_isBigEndian) std::reverse_copy(bytes, bytes + sizeof(T), (char*)&result);
+        else std::copy(bytes, bytes + sizeof(T), (char*)&result);
+        return result;
+    }
+    bool readInto(std::span<char> out);
+    std::span<const char> readSpan(const size_t& length);
+    // VarInt length prefixed like readString
+    std::string_view readStringView();
+    // true once any read ran past the end or hit a malformed VarInt, cleared by clear()
+    bool hasReadFailed() const;
+
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> void writeNumeric(const T& value) {
         if constexpr (std::is_same_v<T, bool>) { writeByte(value ? 1 : 0); return; }
         if constexpr (std::is_same_v<T, char>) { writeByte(value); return; }
@@ -140,11 +185,45 @@ struct ByteBuffer {
         if constexpr (std::is_same_v<T, char>) return readByte();
         if constexpr (std::is_same_v<T, unsigned char>) return readUnsignedByte();
         T result = 0;
-        std::vector<char> bytes = readBytes(sizeof(T));
-        if (m_isBigEndian) std::reverse(bytes.begin(), bytes.end());
-        std::copy(bytes.begin(), bytes.end(), (char*)&result);
+        const char* bytes = m_internalBuffer.consume(sizeof(T));
+        if (!bytes) return result;
+        if (m_isBigEndian) std::reverse_copy(bytes, bytes + sizeof(T), (char*)&result);
+        else std::copy(bytes, bytes + sizeof(T), (char*)&result);
+        return result;
+    }
+
+    // bulk writeNumeric/readNumeric: one reserve and a single byte-swapping pass between the array and the storage
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> void writeNumericArray(std::span<const T> values) {
+        if (values.empty()) return;
+        const size_t writer = m_internalBuffer.getWriter(), length = values.size() * sizeof(T);
+        m_internalBuffer.reserve(writer + length);
+        if (m_isBigEndian) ByteSwap::copy(m_internalBuffer.data() + writer, (const char*) values.data(), values.size(), sizeof(T));
+        else std::memcpy(m_internalBuffer.data() + writer, values.data(), length);
+        m_internalBuffer.setWriter(writer + length);
+    }
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> std::vector<T> readNumericArray(const size_t& count) {
+        const size_t available = m_internalBuffer.getWriter() - m_internalBuffer.getReader();
+        if (count > available / sizeof(T)) {
+            // checked before allocating, the count usually comes straight from a length prefix on the wire
+            m_logger.error("Not enough data to read numeric array");
+            m_internalBuffer.setReadFailed(true);
+            m_internalBuffer.setReader(m_internalBuffer.getWriter());
+            return {};
+        }
+        if (!count) return {};
+        const char* bytes = m_internalBuffer.consume(count * sizeof(T));
+        std::vector<T> result (count);
+        if (m_isBigEndian) ByteSwap::copy((char*) result.data(), bytes, count, sizeof(T));
+        else std::memcpy(result.data(), bytes, count * sizeof(T));
         return result;
     }
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> void writePrefixedNumericArray(std::span<const T> values) {
+        writeVarNumeric<int>(zinc_safe_cast<size_t, int>(values.size()));
+        writeNumericArray<T>(values);
+    }
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> std::vector<T> readPrefixedNumericArray() {
+        return readNumericArray<T>(zinc_safe_cast<int, size_t>(readVarNumeric<int>()));
+    }
 
     void writeByte(const char& c);
     char readByte();
@@ -155,49 +234,36 @@ struct ByteBuffer {
         return sizeof(T) * 8 / 7 + 1;
     }
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> static size_t getVarNumericLength(const T& value) {
-        size_t count = 0;
-        using UnsignedT = std::make_unsigned_t<T>;
-        UnsignedT uv = static_cast<UnsignedT>(value);
-        do { count++; uv >>= 7; } while (uv);
-        return count;
+        return VarInt::size(value);
     }
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> void writeVarNumeric(const T& value) {
-        std::array<uint8_t, varNumericMaxSize<T>()> temp;
-        size_t count = 0;
-        using UnsignedT = std::make_unsigned_t<T>;
-        UnsignedT uv = static_cast<UnsignedT>(value);
-        do { temp[count++] = (uv & 0x7F) | 0x80; uv >>= 7; } while (uv);
-        temp[count-1] &= 0x7F;
-        m_internalBuffer.write((const char*) temp.data(), count);
+        std::array<char, varNumericMaxSize<T>()> temp;
+        m_internalBuffer.write(temp.data(), VarInt::encode(temp.data(), value));
     }
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> T readVarNumeric() {
-        using UnsignedT = std::make_unsigned_t<T>;
-        UnsignedT result = 0;
-        int shift = 0;
-        std::vector<char> readByte;
-        const auto maxBytes = varNumericMaxSize<T>();
-        for (size_t i = 0; i < maxBytes; ++i) {
-            readByte = m_internalBuffer.read(1);
-            const uint8_t byte = zinc_safe_cast<char, uint8_t>(readByte[0]);
-            result |= static_cast<UnsignedT>(byte & 0x7F) << shift;
-            if (!(byte & 0x80)) {
-                if constexpr (std::is_signed_v<T>) {
-                    constexpr auto signBit = static_cast<UnsignedT>(1) << (sizeof(T) * 8 - 1);
-                    if (result & signBit) {
-                        result |= static_cast<UnsignedT>(~0) << (sizeof(T) * 8 - 1);
-                    }
-                }
-                return static_cast<T>(result);
-            }
-            shift += 7;
-            if (shift >= (int)(sizeof(T) * 8)) {
-                m_logger.error("VarInt overflow");
-                return 0;
-            }
+        const size_t reader = m_internalBuffer.getReader(), available = m_internalBuffer.getWriter() - reader;
+        T result = 0;
+        const int length = VarInt::decode(m_internalBuffer.data() + reader, available, result);
+        if (length > 0) {
+            m_internalBuffer.setReader(reader + zinc_safe_cast<int, size_t>(length));
+            return result;
+        }
+        if (length < 0) {
+            m_logger.error("VarInt overflow");
+            m_internalBuffer.setReadFailed(true);
+            m_internalBuffer.setReader(reader + varNumericMaxSize<T>());
+            return 0;
         }
-        m_logger.error("Malformed VarInt");
+        m_logger.error("Not enough data to read VarInt");
+        m_internalBuffer.setReadFailed(true);
+        m_internalBuffer.setReader(m_internalBuffer.getWriter());
         return 0;
     }
+    // VarInts back to back without a length prefix, single byte runs are converted in SIMD blocks
+    void writeVarIntArray(std::span<const int> values);
+    std::vector<int> readVarIntArray(const size_t& count);
+    void writePrefixedVarIntArray(std::span<const int> values);
+    std::vector<int> readPrefixedVarIntArray();
     template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>> static size_t getZigZagVarNumericLength(const T& value) {
         using UnsignedT = std::make_unsigned_t<T>;
         auto transformed = static_cast<UnsignedT>((value << 1) ^ (value >> (sizeof(T) * 8 - 1)));
@@ -276,12 +342,14 @@ struct ByteBuffer {
     }
     template<typename T> std::vector<T> readArray(T(ByteBuffer::*func)(), size_t length) {
         std::vector<T> result;
-        for (size_t i = 0; i < length; i++) result.push_back((this->*func)());
+        result.reserve(std::min(length, m_internalBuffer.getWriter() - m_internalBuffer.getReader()));
+        for (size_t i = 0; i < length && !m_internalBuffer.hasReadFailed(); i++) result.push_back((this->*func)());
         return result;
     }
     template<typename T> std::vector<T> readArray(std::function<T(ByteBuffer&)> func, size_t length) {
         std::vector<T> result;
-        for (size_t i = 0; i < length; i++) result.push_back(func(*this));
+        result.reserve(std::min(length, m_internalBuffer.getWriter() - m_internalBuffer.getReader()));
+        for (size_t i = 0; i < length && !m_internalBuffer.hasReadFailed(); i++) result.push_back(func(*this));
         return result;
     }
     template<typename T> std::vector<T> readPrefixedArray(T(ByteBuffer::*func)()) {
@@ -5,6 +5,8 @@
 
 namespace zinc {
 
+struct ByteBuffer;
+
 struct LightData {
     BitSet m_skyLightMask;
     BitSet m_blockLightMask;
@@ -16,6 +18,8 @@ struct LightData {
     LightData() {}
 
     std::vector<char> toBytes() const;
+    size_t encodedSize() const;
+    void encode(ByteBuffer& buffer) const;
 
     bool operator==(const LightData& data) const;
     bool operator!=(const LightData& data) const;
@@ -5,6 +5,8 @@
 
 namespace zinc {
 
+struct ByteBuffer;
+
 struct SlotDisplay {
     Identifier m_type = Identifier("minecraft:empty");
     int m_itemType;
@@ -16,6 +18,8 @@ struct SlotDisplay {
     SlotDisplay() {}
 
     std::vector<char> toBytes() const;
+    // writes through the registry writer straight into buffer
+    void encode(ByteBuffer& buffer) const;
 
     bool operator==(const SlotDisplay& slotDisplay) const;
     bool operator!=(const SlotDisplay& slotDisplay) const;
@@ -35,6 +39,7 @@ struct RecipeDisplay {
     RecipeDisplay() {}
 
     std::vector<char> toBytes() const;
+    void encode(ByteBuffer& buffer) const;
 
     bool operator==(const RecipeDisplay& recipeDisplay) const;
     bool operator!=(const RecipeDisplay& recipeDisplay) const;
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 
 namespace zinc {
 
+struct ByteBuffer;
+
 struct ComponentWrapper {
     int m_type;
     std::vector<char> m_dataAndType;
@@ -26,6 +29,10 @@ struct Slot {
     
     std::vector<char> toBytes() const;
     std::vector<char> toBytesHashed() const;
+    // exact length of encode(), used to reserve once before writing
+    size_t encodedSize() const;
+    void encode(ByteBuffer& buffer) const;
+    void encodeHashed(ByteBuffer& buffer) const;
 
     bool operator==(const Slot& slot) const;
     bool operator!=(const Slot& slot) const;
@@ -113,6 +113,8 @@ struct TextComponent {
     std::string encodeJSON() const;
     void encodeJSON(ByteBuffer& buffer) const;
     void encode(ByteBuffer& buffer) const;
+    // exact length of encode(buffer) as network NBT
+    size_t encodedSize(const bool& isBigEndian = true) const;
     void decode(const NBTElement& element);
     void decode(ByteBuffer& buffer);
 
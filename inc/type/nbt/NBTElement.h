@@ -47,7 +47,12 @@ struct NBTElement {
 
     std::vector<char> encode() const;
     void encode(ByteBuffer& byteBuffer) const;
+    // encodes as if m_settings were settings, used for children and network NBT
+    void encode(ByteBuffer& byteBuffer, const NBTSettings& settings) const;
     void decode(ByteBuffer& byteBuffer);
+    // exact number of bytes encode() writes into a buffer of the given byte order
+    size_t encodedSize(const bool& isBigEndian) const;
+    size_t encodedSize(const bool& isBigEndian, const NBTSettings& settings) const;
 
     std::string toJSON() const;
 
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace zinc {
+
+// reversed-byte-order copy of count elements of width 2, 4 or 8 bytes (1 is a plain copy), used for big endian numeric arrays
+// one pshufb per 32 bytes with AVX2 (16 with SSSE3), __builtin_bswap for the tail and without SIMD
+struct ByteSwap {
+    static void copy(char* out, const char* in, const size_t& count, const size_t& width) noexcept;
+};
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace zinc {
+
+// epoch-based reclamation: objects unlinked from a lock-free structure are retired here and only
+// destroyed once no thread that could still see them is inside a Guard
+struct EpochReclaimer {
+private:
+    static constexpr uint64_t IDLE = UINT64_MAX;
+    struct alignas(64) Participant {
+        std::atomic<uint64_t> m_epoch = IDLE;
+    };
+    struct Retired {
+        std::function<void()> m_deleter;
+        uint64_t m_epoch;
+    };
+    std::atomic<uint64_t> m_globalEpoch = 0;
+    std::array<Participant, 256> m_participants;
+    std::mutex m_mutex;
+    std::deque<Retired> m_retired;
+
+    size_t enter();
+    void exit(const size_t& participant);
+public:
+    struct Guard {
+    private:
+        EpochReclaimer* m_reclaimer;
+        size_t m_participant;
+    public:
+        Guard(EpochReclaimer& reclaimer) : m_reclaimer(&reclaimer), m_participant(reclaimer.enter()) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() {
+            m_reclaimer->exit(m_participant);
+        }
+    };
+
+    EpochReclaimer() {}
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+    ~EpochReclaimer() {
+        for (Retired& retired : m_retired) retired.m_deleter();
+    }
+
+    // pointers read from a lock-free structure stay valid while the returned guard lives
+    Guard pin();
+    void retire(const std::function<void()>& deleter);
+    // destroys every retired object no guard can reach anymore, called by retire()
+    void collect();
+    size_t getRetiredCount();
+};
+extern EpochReclaimer g_epochReclaimer;
+
+}
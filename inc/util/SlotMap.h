@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace zinc {
+
+// stable reference into a SlotMap, stale once the value is erased even if its slot is reused
+struct SlotMapHandle {
+    uint32_t m_index = UINT32_MAX;
+    uint32_t m_generation = 0;
+
+    bool isValid() const {
+        return m_index != UINT32_MAX;
+    }
+    bool operator==(const SlotMapHandle& handle) const {
+        return m_index == handle.m_index && m_generation == handle.m_generation;
+    }
+    bool operator!=(const SlotMapHandle& handle) const {
+        return !operator==(handle);
+    }
+};
+// generation-indexed table of pointers, lookups are lock-free while insert/erase take a mutex
+// chunks are never moved or freed before the map itself, erased values must be reclaimed by the caller
+template<typename T> struct SlotMap {
+private:
+    struct Slot {
+        std::atomic<uint32_t> m_generation = 0; // odd while occupied
+        std::atomic<T*> m_value = nullptr;
+    };
+    std::array<std::atomic<Slot*>, 1024> m_chunks = {};
+    std::mutex m_mutex;
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_nextSlot = 0;
+    std::atomic<size_t> m_size = 0;
+
+    Slot* getSlot(const uint32_t& index) const {
+        if ((index >> CHUNK_BITS) >= m_chunks.size()) return nullptr;
+        Slot* chunk = m_chunks[index >> CHUNK_BITS].load();
+        if (!chunk) return nullptr;
+        return &chunk[index & (CHUNK_SIZE - 1)];
+    }
+public:
+    static constexpr uint32_t CHUNK_BITS = 10;
+    static constexpr uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+
+    SlotMap() {}
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+    ~SlotMap() {
+        for (std::atomic<Slot*>& chunk : m_chunks) delete[] chunk.load();
+    }
+
+    // returns an invalid handle once every chunk is in use
+    SlotMapHandle insert(T* value) {
+        std::lock_guard lock(m_mutex);
+        uint32_t index;
+        if (m_freeSlots.size()) {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            if ((m_nextSlot >> CHUNK_BITS) >= m_chunks.size()) return SlotMapHandle();
+            if (!(m_nextSlot & (CHUNK_SIZE - 1))) m_chunks[m_nextSlot >> CHUNK_BITS].store(new Slot[CHUNK_SIZE]);
+            index = m_nextSlot++;
+        }
+        Slot* slot = getSlot(index);
+        slot->m_value.store(value);
+        uint32_t generation = slot->m_generation.load() + 1;
+        slot->m_generation.store(generation);
+        m_size++;
+        return { index, generation };
+    }
+    T* get(const SlotMapHandle& handle) const {
+        Slot* slot = getSlot(handle.m_index);
+        if (!slot || slot->m_generation.load() != handle.m_generation) return nullptr;
+        T* value = slot->m_value.load();
+        // the slot may have been erased (and reused) between the two loads
+        if (slot->m_generation.load() != handle.m_generation) return nullptr;
+        return value;
+    }
+    T* erase(const SlotMapHandle& handle) {
+        std::lock_guard lock(m_mutex);
+        Slot* slot = getSlot(handle.m_index);
+        if (!slot || slot->m_generation.load() != handle.m_generation) return nullptr;
+        T* value = slot->m_value.load();
+        slot->m_generation.store(handle.m_generation + 1);
+        slot->m_value.store(nullptr);
+        m_freeSlots.push_back(handle.m_index);
+        m_size--;
+        return value;
+    }
+    // calls function(handle, value) for every occupied slot, values may be erased concurrently
+    template<typename F> void forEach(const F& function) const {
+        for (uint32_t chunkIndex = 0; chunkIndex < m_chunks.size(); chunkIndex++) {
+            Slot* chunk = m_chunks[chunkIndex].load();
+            if (!chunk) break;
+            for (uint32_t i = 0; i < CHUNK_SIZE; i++) {
+                uint32_t generation = chunk[i].m_generation.load();
+                if (!(generation & 1)) continue;
+                T* value = chunk[i].m_value.load();
+                if (value && chunk[i].m_generation.load() == generation) function(SlotMapHandle{ (chunkIndex << CHUNK_BITS) | i, generation }, value);
+            }
+        }
+    }
+    size_t size() const {
+        return m_size;
+    }
+};
+
+}
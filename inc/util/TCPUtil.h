@@ -1,15 +1,26 @@
 #pragma once
 
 #include <type/ByteBuffer.h>
-#include <event2/bufferevent.h>
+#include <network/TCPStream.h>
+#include <event2/buffer.h>
 
 namespace zinc {
 
 struct TCPUtil {
-    static size_t read(bufferevent* bev, ByteBuffer& buffer);
-    static ByteBuffer read(bufferevent* bev);
-    static void send(bufferevent* bev, const ByteBuffer& buffer);
-    static void drain(bufferevent* bev, const size_t& length);
+    static size_t read(TCPStream* stream, ByteBuffer& buffer);
+    static ByteBuffer read(TCPStream* stream);
+    static void send(TCPStream* stream, const ByteBuffer& buffer);
+    static void drain(TCPStream* stream, const size_t& length);
+
+    static constexpr int MAX_FRAME_LENGTH = 2097151; // largest length a 3-byte VarInt prefix can carry
+
+    // decodes a VarInt from raw bytes: returns its size, 0 if more bytes are needed or -1 if malformed
+    static int peekVarInt(const unsigned char* data, const size_t& length, int& value);
+    // encodes a VarInt into out (at least 5 bytes) and returns its size
+    static size_t writeVarInt(unsigned char* out, const int& value);
+    // moves one length-prefixed frame (without the prefix) from input to frame
+    // returns 1 when a frame was moved, 0 if it is still incomplete or -1 if the prefix is malformed
+    static int readFrame(evbuffer* input, evbuffer* frame);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace zinc {
+
+// hierarchical timing wheel: 4 levels of 64 slots, O(1) schedule/cancel and amortized O(1) per tick
+// not thread safe, every wheel belongs to one reactor thread
+struct TimerWheel {
+    struct TimerId {
+        uint32_t m_index = UINT32_MAX;
+        uint32_t m_generation = 0;
+
+        bool isValid() const {
+            return m_index != UINT32_MAX;
+        }
+    };
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    struct Timer {
+        std::function<void()> m_callback;
+        uint64_t m_expiry = 0;
+        uint32_t m_prev = NIL, m_next = NIL;
+        uint32_t m_slot = NIL;
+        uint32_t m_generation = 0;
+    };
+    std::vector<Timer> m_timers;
+    std::vector<uint32_t> m_freeTimers;
+    std::array<uint32_t, 256> m_slots;
+    uint64_t m_tick = 0;
+    size_t m_size = 0;
+
+    void link(const uint32_t& index);
+    void unlink(const uint32_t& index);
+    void release(const uint32_t& index);
+    void cascade(const size_t& level);
+public:
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = 1 << SLOT_BITS;
+    static constexpr size_t LEVELS = 4;
+    static constexpr uint64_t MAX_DELAY = (1ULL << (SLOT_BITS * LEVELS)) - 1; // longer delays are re-cascaded at the top level
+
+    TimerWheel() {
+        m_slots.fill(NIL);
+    }
+
+    // callback runs from advance() once delay ticks have passed (at least 1)
+    TimerId schedule(const uint64_t& delay, const std::function<void()>& callback);
+    bool cancel(TimerId& id);
+    bool isScheduled(const TimerId& id) const;
+    void advance(const uint64_t& ticks = 1);
+
+    uint64_t getTick() const;
+    size_t size() const;
+};
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace zinc {
+
+// VarInt/VarLong codecs over raw memory, shared by ByteBuffer, the packet schema codecs and frame parsing
+// values that fit in 8 encoded bytes are handled as one 64-bit word (pext/pdep with BMI2, shift-and-mask otherwise),
+// the array variants add SSE4.1/AVX2 fast paths for runs of single byte values
+struct VarInt {
+    template<typename T> static constexpr size_t maxSize() noexcept {
+        return sizeof(T) * 8 / 7 + 1;
+    }
+    template<typename T> static size_t size(const T& value) noexcept {
+        using UnsignedT = std::make_unsigned_t<T>;
+        // bit_width(v | 1) is 1..64, so this is 1..maxSize without a loop
+        return (static_cast<size_t>(std::bit_width(static_cast<uint64_t>(static_cast<UnsignedT>(value)) | 1)) + 6) / 7;
+    }
+
+    // encodes value into out (at least maxSize<T>() bytes) and returns its size
+    template<typename T> static size_t encode(char* out, const T& value) noexcept {
+        using UnsignedT = std::make_unsigned_t<T>;
+        const uint64_t uv = static_cast<uint64_t>(static_cast<UnsignedT>(value));
+        const size_t length = size(uv);
+        if constexpr (std::endian::native == std::endian::little) {
+            if (length <= 8) {
+                // continuation bits on every byte but the last
+                const uint64_t word = spread(uv) | (0x8080808080808080ULL & ((1ULL << (8 * (length - 1))) - 1));
+                std::memcpy(out, &word, length);
+                return length;
+            }
+        }
+        uint64_t remaining = uv;
+        size_t i = 0;
+        for (; remaining >= 0x80; remaining >>= 7) out[i++] = static_cast<char>((remaining & 0x7F) | 0x80);
+        out[i++] = static_cast<char>(remaining);
+        return i;
+    }
+    // decodes one value from [data, data + length): returns its size, 0 if more bytes are needed or -1 if it is longer than maxSize<T>()
+    // bits above the width of T are dropped, like the byte-wise readers always did
+    template<typename T> static int decode(const char* data, const size_t& length, T& value) noexcept {
+        using UnsignedT = std::make_unsigned_t<T>;
+        constexpr size_t maxLength = maxSize<T>();
+        if constexpr (std::endian::native == std::endian::little) {
+            if (length >= 8) {
+                uint64_t word;
+                std::memcpy(&word, data, 8);
+                const uint64_t stops = ~word & 0x8080808080808080ULL;
+                if (stops) {
+                    const size_t encoded = static_cast<size_t>(std::countr_zero(stops)) / 8 + 1;
+                    if (encoded > maxLength) return -1;
+                    value = static_cast<T>(static_cast<UnsignedT>(gather(word & (~0ULL >> (64 - 8 * encoded)))));
+                    return static_cast<int>(encoded);
+                }
+                if (maxLength <= 8) return -1;
+            }
+        }
+        uint64_t result = 0;
+        for (size_t i = 0; i < maxLength; i++) {
+            if (i >= length) return 0;
+            const uint8_t byte = static_cast<uint8_t>(data[i]);
+            result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if (!(byte & 0x80)) {
+                value = static_cast<T>(static_cast<UnsignedT>(result));
+                return static_cast<int>(i + 1);
+            }
+        }
+        return -1;
+    }
+
+    // encodes every value back to back into out (at least values.size() * maxSize<int>() bytes) and returns the bytes written
+    static size_t encodeArray(char* out, std::span<const int> values) noexcept;
+    // decodes values.size() VarInts: returns the bytes consumed or -1 if the input ends early or one of them is malformed
+    static long decodeArray(const char* data, const size_t& length, std::span<int> values) noexcept;
+private:
+    // low 56 bits of value into the low 7 bits of 8 bytes
+    static uint64_t spread(const uint64_t& value) noexcept {
+#if defined(__BMI2__)
+        return _pdep_u64(value, 0x7F7F7F7F7F7F7F7FULL);
+#else
+        uint64_t x = value & 0x00FFFFFFFFFFFFFFULL;
+        x = ((x << 4) & 0x0FFFFFFF00000000ULL) | (x & 0x000000000FFFFFFFULL);
+        x = ((x << 2) & 0x3FFF00003FFF0000ULL) | (x & 0x00003FFF00003FFFULL);
+        x = ((x << 1) & 0x7F007F007F007F00ULL) | (x & 0x007F007F007F007FULL);
+        return x;
+#endif
+    }
+    // inverse of spread, the high bit of every byte is ignored
+    static uint64_t gather(const uint64_t& word) noexcept {
+#if defined(__BMI2__)
+        return _pext_u64(word, 0x7F7F7F7F7F7F7F7FULL);
+#else
+        uint64_t x = word & 0x7F7F7F7F7F7F7F7FULL;
+        x = ((x & 0x7F007F007F007F00ULL) >> 1) | (x & 0x007F007F007F007FULL);
+        x = ((x & 0x3FFF00003FFF0000ULL) >> 2) | (x & 0x00003FFF00003FFFULL);
+        x = ((x & 0x0FFFFFFF00000000ULL) >> 4) | (x & 0x000000000FFFFFFFULL);
+        return x;
+#endif
+    }
+};
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace zinc {
+
+struct WorkerStageStats {
+    int64_t m_queueDepth = 0; // submitted but not finished
+    uint64_t m_completed = 0;
+    uint64_t m_totalLatencyNanoseconds = 0; // submit to finish, includes queueing
+    uint64_t m_maxLatencyNanoseconds = 0;
+};
+// work-stealing pool for CPU-heavy jobs: every worker owns a deque, idle workers steal from the back of the others
+// jobs are tagged with a stage so queue depth and latency can be tracked per kind of work
+struct WorkerPool {
+public:
+    static constexpr size_t MAX_STAGES = 8;
+private:
+    struct Task {
+        std::function<void()> m_work;
+        size_t m_stage = 0;
+        std::chrono::steady_clock::time_point m_submitted;
+    };
+    struct alignas(64) Worker {
+        std::mutex m_mutex;
+        std::deque<Task> m_tasks;
+        std::thread m_thread;
+    };
+    struct alignas(64) Stage {
+        std::atomic<int64_t> m_queueDepth = 0;
+        std::atomic<uint64_t> m_completed = 0, m_totalLatency = 0, m_maxLatency = 0;
+    };
+    std::deque<Worker> m_workers;
+    std::array<Stage, MAX_STAGES> m_stages;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<size_t> m_pending = 0, m_nextWorker = 0;
+    bool m_started = false;
+
+    void worker(const size_t& index);
+    bool pop(const size_t& index, Task& task);
+    void run(Task& task);
+public:
+    ~WorkerPool() {
+        stop();
+    }
+
+    // threads == 0 keeps the pool stopped, submitted work then runs inline on the caller
+    void start(const size_t& threads);
+    // drops queued work that hasn't started yet
+    void stop();
+
+    void submit(const size_t& stage, const std::function<void()>& work);
+
+    size_t getThreadCount() const;
+    WorkerStageStats getStats(const size_t& stage) const;
+};
+
+}
@@ -1,12 +1,45 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
+#include <zlib-ng.h>
 
 namespace zinc {
 
+// deflate/inflate streams that are initialized once and reset between packets
+struct ZLibContext {
+private:
+    zng_stream m_deflate, m_inflate;
+    bool m_isDeflateReady = false, m_isInflateReady = false;
+    int m_level;
+public:
+    ZLibContext(const int& level = Z_DEFAULT_COMPRESSION) : m_level(level) {}
+    ZLibContext(const ZLibContext&) = delete;
+    ZLibContext& operator=(const ZLibContext&) = delete;
+    ~ZLibContext() {
+        if (m_isDeflateReady) zng_deflateEnd(&m_deflate);
+        if (m_isInflateReady) zng_inflateEnd(&m_inflate);
+    }
+
+    // one context per thread, shared by every connection that thread serves
+    static ZLibContext& getThreadLocal();
+
+    void setLevel(const int& level);
+    int getLevel() const;
+
+    static size_t compressBound(const size_t& length);
+    // returns the compressed size or 0 on failure
+    size_t compress(const uint8_t* data, const size_t& length, uint8_t* out, const size_t& outCapacity);
+    // deflates prefix followed by data as one stream, so the two never have to be joined in memory first
+    size_t compress(const uint8_t* prefix, const size_t& prefixLength, const uint8_t* data, const size_t& length, uint8_t* out,
+                    const size_t& outCapacity);
+    // out must hold exactly the decompressed size
+    bool uncompress(const uint8_t* data, const size_t& length, uint8_t* out, const size_t& outLength);
+};
+
 struct ZLibUtil {
     static std::vector<char> compress(const std::vector<char>& buffer);
     static std::vector<char> uncompress(const std::vector<char>& buffer, const size_t& decompressedSize);
 };
 
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
+#include <openssl/evp.h>
 #include "../Memory.h"
 #include "../Logger.h"
 
@@ -12,16 +14,27 @@ private:
     Lockable<SafeVector<unsigned char>> m_iv = Lockable<SafeVector<unsigned char>>(SafeVector<unsigned char>(16));
     bool m_isKeySet;
     bool m_isIVSet;
+    EVP_CIPHER_CTX* m_context = nullptr; // keeps the CFB8 stream state between calls
+    int m_enc = -1;
     Logger m_logger = Logger("AESWrapper");
 
-    std::vector<unsigned char> processCFB8(const std::vector<unsigned char>& data, int enc);
+    void logError(const std::string& message);
 public:
     AESWrapper() : m_isKeySet(false), m_isIVSet(false) {}
-    ~AESWrapper() {}
+    AESWrapper(const AESWrapper&) = delete;
+    AESWrapper& operator=(const AESWrapper&) = delete;
+    ~AESWrapper() {
+        if (m_context) EVP_CIPHER_CTX_free(m_context);
+    }
 
     void setKey(const std::vector<unsigned char>& key);
     void setIV(const std::vector<unsigned char>& iv);
 
+    // creates the long-lived cipher context from the current key and IV (enc: 1 encrypt, 0 decrypt)
+    bool initCFB8(const int& enc);
+    // transforms data in place, continuing the stream from the previous call
+    bool update(uint8_t* data, const size_t& length);
+
     std::vector<unsigned char> encryptCFB8(const std::vector<unsigned char>& data);
     std::vector<unsigned char> decryptCFB8(const std::vector<unsigned char>& data);
 };
@@ -8,6 +8,7 @@
 #include <util/crypto/Random.h>
 #include <type/ByteBuffer.h>
 #include <fstream>
+#include <algorithm>
 #include <thread>
 
 namespace zinc {
@@ -41,11 +42,24 @@ void ZincConfig::save(const std::string& workdir) {
     nlohmann::json coreSettings = {
         { "network", {
             { "threshold", m_core.m_network.m_threshold },
+            { "compression_level", m_core.m_network.m_compressionLevel },
             { "server_port", m_core.m_network.m_serverPort },
             { "srvctl_port", m_core.m_network.m_srvctlPort },
+            { "reactor_threads", m_core.m_network.m_reactorThreads },
+            { "transport", m_core.m_network.m_transport },
+            { "auth_threads", m_core.m_network.m_authThreads },
+            { "worker_threads", m_core.m_network.m_workerThreads },
+            { "outbound_low_watermark", m_core.m_network.m_outboundLowWatermark },
+            { "outbound_high_watermark", m_core.m_network.m_outboundHighWatermark },
+            { "outbound_hard_cap", m_core.m_network.m_outboundHardCap },
+            { "handshake_timeout_seconds", m_core.m_network.m_handshakeTimeout },
+            { "login_timeout_seconds", m_core.m_network.m_loginTimeout },
+            { "keep_alive_interval_seconds", m_core.m_network.m_keepAliveInterval },
+            { "keep_alive_timeout_seconds", m_core.m_network.m_keepAliveTimeout },
             { "motd", m_core.m_network.m_motd },
             { "max_player_count", m_core.m_network.m_maxPlayerCount },
-            { "icon_path", m_core.m_network.m_iconPath }
+            { "icon_path", m_core.m_network.m_iconPath },
+            { "bind_addresses", m_core.m_network.serializeBindAddresses() }
         }},
         { "security", {
             { "online_mode", m_core.m_security.m_onlineMode },
@@ -54,13 +68,23 @@ void ZincConfig::save(const std::string& workdir) {
             { "allow_pvp", m_core.m_security.m_allowPVP },
             { "backup_interval_minutes", m_core.m_security.m_backupInterval },
             { "rate_limit_seconds", m_core.m_security.m_rateLimit },
+            { "connection_burst", m_core.m_security.m_connectionBurst },
+            { "subnet_connections_per_second", m_core.m_security.m_subnetConnectionRate },
+            { "subnet_connection_burst", m_core.m_security.m_subnetConnectionBurst },
             { "max_concurrent_account", m_core.m_security.m_maxConcurrentAccount },
             { "rbac_path", m_core.m_security.m_rbacPath },
-            { "unban_support", m_core.m_security.m_unbanSupport }
+            { "unban_support", m_core.m_security.m_unbanSupport },
+            { "session_server", m_core.m_security.m_sessionServer },
+            { "session_server_timeout_seconds", m_core.m_security.m_sessionServerTimeout },
+            { "proxy_protocol", m_core.m_security.m_proxyProtocol },
+            { "trusted_proxies", m_core.m_security.m_trustedProxies }
         }},
         { "optimizations", {
             { "view_distance", m_core.m_optimizations.m_viewDistance },
-            { "simulation_distance", m_core.m_optimizations.m_simulationDistance }
+            { "simulation_distance", m_core.m_optimizations.m_simulationDistance },
+            { "status_fast_path", m_core.m_optimizations.m_statusFastPath },
+            { "packet_metrics", m_core.m_optimizations.m_packetMetrics },
+            { "offload_inflate_threshold", m_core.m_optimizations.m_offloadInflateThreshold }
         }},
         { "worlds", {
             { "default_world", m_core.m_worlds.m_defaultWorld },
@@ -77,10 +101,51 @@ void ZincConfig::load(const std::string& workdir) {
     nlohmann::json coreSettings = readJSONFile(workdir + "/config/zinc.json");
         if (coreSettings.contains("network")) {
             if (coreSettings["network"].contains("threshold")) m_core.m_network.m_threshold = coreSettings["network"]["threshold"];
+            if (coreSettings["network"].contains("compression_level")) {
+                int compressionLevel = coreSettings["network"]["compression_level"];
+                // zlib rejects anything else and every compressed packet would be dropped
+                m_core.m_network.m_compressionLevel = std::clamp(compressionLevel, -1, 9);
+                if (compressionLevel != m_core.m_network.m_compressionLevel)
+                    m_logger.warning("compression_level " + std::to_string(compressionLevel) + " is out of range, using " +
+                                     std::to_string(m_core.m_network.m_compressionLevel));
+            }
             if (coreSettings["network"].contains("server_port")) m_core.m_network.m_serverPort = coreSettings["network"]["server_port"];
             if (coreSettings["network"].contains("srvctl_port")) m_core.m_network.m_srvctlPort = coreSettings["network"]["srvctl_port"];
+            if (coreSettings["network"].contains("reactor_threads")) m_core.m_network.m_reactorThreads = coreSettings["network"]["reactor_threads"];
+            if (coreSettings["network"].contains("transport")) m_core.m_network.m_transport = coreSettings["network"]["transport"];
+            if (coreSettings["network"].contains("auth_threads")) m_core.m_network.m_authThreads = coreSettings["network"]["auth_threads"];
+            if (coreSettings["network"].contains("worker_threads")) m_core.m_network.m_workerThreads = coreSettings["network"]["worker_threads"];
+            if (coreSettings["network"].contains("outbound_low_watermark")) 
+                m_core.m_network.m_outboundLowWatermark = coreSettings["network"]["outbound_low_watermark"];
+            if (coreSettings["network"].contains("outbound_high_watermark")) 
+                m_core.m_network.m_outboundHighWatermark = coreSettings["network"]["outbound_high_watermark"];
+            if (coreSettings["network"].contains("outbound_hard_cap")) m_core.m_network.m_outboundHardCap = coreSettings["network"]["outbound_hard_cap"];
+            if (coreSettings["network"].contains("handshake_timeout_seconds")) 
+                m_core.m_network.m_handshakeTimeout = coreSettings["network"]["handshake_timeout_seconds"];
+            if (coreSettings["network"].contains("login_timeout_seconds")) m_core.m_network.m_loginTimeout = coreSettings["network"]["login_timeout_seconds"];
+            if (coreSettings["network"].contains("keep_alive_interval_seconds")) 
+                m_core.m_network.m_keepAliveInterval = coreSettings["network"]["keep_alive_interval_seconds"];
+            if (coreSettings["network"].contains("keep_alive_timeout_seconds")) 
+                m_core.m_network.m_keepAliveTimeout = coreSettings["network"]["keep_alive_timeout_seconds"];
             if (coreSettings["network"].contains("motd")) m_core.m_network.m_motd = coreSettings["network"]["motd"];
             if (coreSettings["network"].contains("max_player_count")) m_core.m_network.m_maxPlayerCount = coreSettings["network"]["max_player_count"];
+            if (coreSettings["network"].contains("bind_addresses")) {
+                m_core.m_network.m_bindAddresses.clear();
+                for (const auto& bindAddressJSON : coreSettings["network"]["bind_addresses"]) {
+                    CoreConfig::Network::BindAddress bindAddress;
+                    if (bindAddressJSON.contains("address")) bindAddress.m_address = bindAddressJSON["address"];
+                    if (bindAddressJSON.contains("port")) bindAddress.m_port = bindAddressJSON["port"];
+                    if (bindAddressJSON.contains("interface")) bindAddress.m_interface = bindAddressJSON["interface"];
+                    if (bindAddressJSON.contains("backlog")) bindAddress.m_backlog = bindAddressJSON["backlog"];
+                    if (bindAddressJSON.contains("tcp_nodelay")) bindAddress.m_noDelay = bindAddressJSON["tcp_nodelay"];
+                    if (bindAddressJSON.contains("ipv6_only")) bindAddress.m_ipv6Only = bindAddressJSON["ipv6_only"];
+                    if (bindAddressJSON.contains("defer_accept_seconds")) bindAddress.m_deferAccept = bindAddressJSON["defer_accept_seconds"];
+                    if (bindAddressJSON.contains("receive_buffer")) bindAddress.m_receiveBuffer = bindAddressJSON["receive_buffer"];
+                    if (bindAddressJSON.contains("send_buffer")) bindAddress.m_sendBuffer = bindAddressJSON["send_buffer"];
+                    if (bindAddressJSON.contains("fast_open_queue")) bindAddress.m_fastOpenQueue = bindAddressJSON["fast_open_queue"];
+                    m_core.m_network.m_bindAddresses.push_back(bindAddress);
+                }
+            }
             if (coreSettings["network"].contains("icon_path")) m_core.m_network.m_iconPath = coreSettings["network"]["icon_path"];
         }
         if (coreSettings.contains("security")) {
@@ -92,16 +157,33 @@ void ZincConfig::load(const std::string& workdir) {
             if (coreSettings["security"].contains("backup_interval_minutes")) 
                 m_core.m_security.m_backupInterval = coreSettings["security"]["backup_interval_minutes"];
             if (coreSettings["security"].contains("rate_limit_seconds")) m_core.m_security.m_rateLimit = coreSettings["security"]["rate_limit_seconds"];
+            if (coreSettings["security"].contains("connection_burst")) m_core.m_security.m_connectionBurst = coreSettings["security"]["connection_burst"];
+            if (coreSettings["security"].contains("subnet_connections_per_second")) 
+                m_core.m_security.m_subnetConnectionRate = coreSettings["security"]["subnet_connections_per_second"];
+            if (coreSettings["security"].contains("subnet_connection_burst")) 
+                m_core.m_security.m_subnetConnectionBurst = coreSettings["security"]["subnet_connection_burst"];
             if (coreSettings["security"].contains("max_concurrent_account")) 
                 m_core.m_security.m_maxConcurrentAccount = coreSettings["security"]["max_concurrent_account"];
             if (coreSettings["security"].contains("rbac_path")) m_core.m_security.m_rbacPath = coreSettings["security"]["rbac_path"];
             if (coreSettings["security"].contains("unban_support")) m_core.m_security.m_unbanSupport = coreSettings["security"]["unban_support"];
+            if (coreSettings["security"].contains("session_server")) m_core.m_security.m_sessionServer = coreSettings["security"]["session_server"];
+            if (coreSettings["security"].contains("session_server_timeout_seconds")) 
+                m_core.m_security.m_sessionServerTimeout = coreSettings["security"]["session_server_timeout_seconds"];
+            if (coreSettings["security"].contains("proxy_protocol")) m_core.m_security.m_proxyProtocol = coreSettings["security"]["proxy_protocol"];
+            if (coreSettings["security"].contains("trusted_proxies")) 
+                m_core.m_security.m_trustedProxies = coreSettings["security"]["trusted_proxies"].get<std::vector<std::string>>();
         }
         if (coreSettings.contains("optimizations")) {
             if (coreSettings["optimizations"].contains("view_distance")) 
                 m_core.m_optimizations.m_viewDistance = coreSettings["optimizations"]["view_distance"];
             if (coreSettings["optimizations"].contains("simulation_distance")) 
                 m_core.m_optimizations.m_simulationDistance = coreSettings["optimizations"]["simulation_distance"];
+            if (coreSettings["optimizations"].contains("status_fast_path")) 
+                m_core.m_optimizations.m_statusFastPath = coreSettings["optimizations"]["status_fast_path"];
+            if (coreSettings["optimizations"].contains("packet_metrics")) 
+                m_core.m_optimizations.m_packetMetrics = coreSettings["optimizations"]["packet_metrics"];
+            if (coreSettings["optimizations"].contains("offload_inflate_threshold")) 
+                m_core.m_optimizations.m_offloadInflateThreshold = coreSettings["optimizations"]["offload_inflate_threshold"];
         }
         if (coreSettings.contains("worlds")) {
             if (coreSettings["worlds"].contains("default_world")) 
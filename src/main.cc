@@ -5,10 +5,14 @@
 #include <network/srvctl/SrvCtlServer.h>
 #include <loader/ZincMessengerBridge.h>
 #include <util/crypto/CRC32.h>
+#include <event2/thread.h>
 #include <thread>
 
 void ThreadMain() {
     zinc::g_zincServer.setPort(zinc::g_zincConfig.m_core.m_network.m_serverPort);
+    int reactorThreads = zinc::g_zincConfig.m_core.m_network.m_reactorThreads;
+    if (reactorThreads <= 0) reactorThreads = zinc::zinc_safe_cast<unsigned, int>(std::thread::hardware_concurrency());
+    zinc::g_zincServer.setReactorCount(zinc::zinc_safe_cast<int, size_t>(reactorThreads));
     zinc::g_zincServer.start();
 }
 void ThreadSrvCtl() {
@@ -18,6 +22,7 @@ void ThreadSrvCtl() {
 
 int main(int argc, char **argv) {
     zinc::initCRC32();
+    evthread_use_pthreads(); // reactors receive work from auth and plugin threads
     try {
         zinc::Logger("Main").info("Starting Zinc server...");
         zinc::g_zincArguments.parse(argc, argv);
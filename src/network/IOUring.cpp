@@ -0,0 +1,390 @@
+#include <network/IOUring.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace zinc {
+
+static_assert(sizeof(evbuffer_iovec) == sizeof(struct iovec) && offsetof(evbuffer_iovec, iov_len) == offsetof(struct iovec, iov_len),
+              "evbuffer_iovec has to be passable to sendmsg as is");
+
+namespace {
+
+template<typename T> T* ringPointer(void* ring, const unsigned& offset) {
+    return (T*) ((unsigned char*) ring + offset);
+}
+uint64_t tag(const void* ptr, const IOUring::Operation& operation) {
+    return (uint64_t) ptr | operation;
+}
+bool hasMultishotReceive() {
+    struct utsname name;
+    if (uname(&name)) return false;
+    int major = 0;
+    if (sscanf(name.release, "%d", &major) != 1) return false;
+    return major >= 6;
+}
+
+}
+
+IOUringStream::~IOUringStream() {
+    evbuffer_free(m_input);
+    evbuffer_free(m_output);
+    evbuffer_free(m_sending);
+    evutil_closesocket(m_fd);
+}
+void IOUringStream::onOutput(evbuffer*, const evbuffer_cb_info* info, void* ptr) {
+    IOUringStream* stream = (IOUringStream*) ptr;
+    if (info->n_added && !stream->m_closed) stream->queue();
+}
+void IOUringStream::queue() {
+    if (m_queued) return;
+    m_queued = true;
+    m_ring->schedule(this);
+}
+void IOUringStream::flush() {
+    m_queued = false;
+    if (m_closed) {
+        if (m_cancelPending) cancel();
+        return maybeRelease();
+    }
+    if (m_reading && !m_receiving && !m_isEOF) {
+        io_uring_sqe* sqe = m_ring->getSqe();
+        if (!sqe) return queue();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = m_fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = IOUring::BUFFER_GROUP;
+        sqe->user_data = tag(this, IOUring::Receive);
+        m_receiving = true;
+        m_inflight++;
+    } else if (!m_reading && m_receiving && !m_cancellingReceive) {
+        // a multishot receive would keep filling the input, so it is cancelled instead of just not re-armed
+        io_uring_sqe* sqe = m_ring->getSqe();
+        if (!sqe) return queue();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = tag(this, IOUring::Receive);
+        sqe->user_data = tag(nullptr, IOUring::Cancel);
+        m_cancellingReceive = true;
+    }
+    if (m_sendInFlight) return;
+    // moving the chains doesn't copy, the kernel reads straight from them until the send completes
+    evbuffer_add_buffer(m_sending, m_output);
+    if (!evbuffer_get_length(m_sending)) return;
+    io_uring_sqe* sqe = m_ring->getSqe();
+    if (!sqe) return queue();
+    int chunkCount = evbuffer_peek(m_sending, -1, nullptr, m_iovecs.data(), zinc_safe_cast<size_t, int>(MAX_IOVECS));
+    m_message.msg_iov = (struct iovec*) m_iovecs.data();
+    m_message.msg_iovlen = std::min(zinc_safe_cast<int, size_t>(chunkCount), MAX_IOVECS);
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = m_fd;
+    sqe->addr = (uint64_t) &m_message;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = tag(this, IOUring::Send);
+    m_sendInFlight = true;
+    m_inflight++;
+}
+void IOUringStream::cancel() {
+    m_cancelPending = false;
+    if (!m_inflight) return;
+    // the ring holds its own reference to the socket, so pending operations have to be cancelled explicitly
+    io_uring_sqe* sqe = m_ring->getSqe();
+    if (!sqe) {
+        // retried from flush, the stream isn't released while it is queued
+        m_cancelPending = true;
+        return queue();
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = m_fd;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = tag(nullptr, IOUring::Cancel);
+}
+void IOUringStream::maybeRelease() {
+    if (m_closed && !m_inflight && !m_queued) m_ring->release(this);
+}
+void IOUringStream::onReceive(const io_uring_cqe& cqe) {
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        m_receiving = m_cancellingReceive = false;
+        m_inflight--;
+    }
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        unsigned short id = (unsigned short) (cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        // copied out right away so a slow reader never holds on to ring buffers the other sockets need
+        if (cqe.res > 0 && !m_closed) evbuffer_add(m_input, m_ring->getBuffer(id), zinc_safe_cast<int, size_t>(cqe.res));
+        m_ring->recycleBuffer(id);
+    }
+    if (m_closed) return maybeRelease();
+    if (cqe.res > 0) {
+        if (m_onRead) m_onRead(this, m_ctx);
+    } else if (!cqe.res) {
+        m_isEOF = true;
+        if (m_onEvent) m_onEvent(this, BEV_EVENT_READING | BEV_EVENT_EOF, m_ctx);
+        return;
+    } else if (cqe.res != -ENOBUFS && cqe.res != -ECANCELED) {
+        m_isEOF = true;
+        if (m_onEvent) m_onEvent(this, BEV_EVENT_READING | BEV_EVENT_ERROR, m_ctx);
+        return;
+    }
+    // a multishot receive ends when the buffer ring ran dry, it is re-armed once this iteration recycled them
+    if (!m_closed && !m_receiving && m_reading) queue();
+}
+void IOUringStream::onSend(const io_uring_cqe& cqe) {
+    m_sendInFlight = false;
+    m_inflight--;
+    if (m_closed) return maybeRelease();
+    if (cqe.res < 0) {
+        if (m_onEvent) m_onEvent(this, BEV_EVENT_WRITING | BEV_EVENT_ERROR, m_ctx);
+        return;
+    }
+    evbuffer_drain(m_sending, zinc_safe_cast<int, size_t>(cqe.res));
+    if (evbuffer_get_length(m_sending) || evbuffer_get_length(m_output)) queue();
+    if (m_onWrite && getOutputLength() <= m_lowWatermark) m_onWrite(this, m_ctx);
+}
+evbuffer* IOUringStream::getInput() {
+    return m_input;
+}
+evbuffer* IOUringStream::getOutput() {
+    return m_output;
+}
+size_t IOUringStream::getOutputLength() {
+    return evbuffer_get_length(m_output) + evbuffer_get_length(m_sending);
+}
+evutil_socket_t IOUringStream::getFd() const {
+    return m_fd;
+}
+void IOUringStream::setCallbacks(TCPStreamCallback onRead, TCPStreamCallback onWrite, TCPStreamEventCallback onEvent, void* ctx) {
+    m_onRead = onRead;
+    m_onWrite = onWrite;
+    m_onEvent = onEvent;
+    m_ctx = ctx;
+}
+void IOUringStream::enableRead() {
+    m_reading = true;
+    if (!m_receiving) queue();
+}
+void IOUringStream::disableRead() {
+    m_reading = false;
+    if (m_receiving) queue();
+}
+void IOUringStream::setWriteLowWatermark(const size_t& watermark) {
+    m_lowWatermark = watermark;
+}
+void IOUringStream::close() {
+    if (m_closed) return;
+    m_closed = true;
+    m_onRead = m_onWrite = nullptr;
+    m_onEvent = nullptr;
+    cancel();
+    maybeRelease();
+}
+
+IOUring::~IOUring() {
+    for (evutil_socket_t listener : m_listeners) evutil_closesocket(listener);
+    for (IOUringStream* stream : m_released) delete stream;
+    if (m_completionEvent) event_free(m_completionEvent);
+    if (m_submitEvent) event_free(m_submitEvent);
+    if (m_fd >= 0) ::close(m_fd);
+    if (m_eventFd >= 0) ::close(m_eventFd);
+    if (m_sqes) munmap(m_sqes, m_sqesSize);
+    if (m_cqRing && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+    if (m_sqRing) munmap(m_sqRing, m_sqRingSize);
+    if (m_bufferRing) munmap(m_bufferRing, BUFFER_COUNT * sizeof(io_uring_buf));
+}
+bool IOUring::init(event_base* base, IOUringAcceptCallback onAccept, void* acceptArg) {
+    m_onAccept = onAccept;
+    m_acceptArg = acceptArg;
+    if (!hasMultishotReceive()) {
+        m_logger.warning("io_uring transport needs Linux 6.0 or newer");
+        return false;
+    }
+    io_uring_params params {};
+    m_fd = (int) syscall(__NR_io_uring_setup, ENTRIES, &params);
+    if (m_fd < 0) {
+        m_logger.warning(std::string("io_uring_setup failed: ") + std::strerror(errno));
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        m_logger.warning("io_uring is missing required features");
+        return false;
+    }
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) {
+        m_sqRing = nullptr;
+        return false;
+    }
+    m_cqRing = m_sqRing;
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = (io_uring_sqe*) mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if (m_sqes == MAP_FAILED) {
+        m_sqes = nullptr;
+        return false;
+    }
+    m_sqHead = ringPointer<unsigned>(m_sqRing, params.sq_off.head);
+    m_sqTail = ringPointer<unsigned>(m_sqRing, params.sq_off.tail);
+    m_sqMask = *ringPointer<unsigned>(m_sqRing, params.sq_off.ring_mask);
+    m_sqEntries = *ringPointer<unsigned>(m_sqRing, params.sq_off.ring_entries);
+    m_sqLocalTail = *m_sqTail;
+    // entries are always used in ring order, so the indirection array is the identity
+    unsigned* sqArray = ringPointer<unsigned>(m_sqRing, params.sq_off.array);
+    for (unsigned i = 0; i < m_sqEntries; i++) sqArray[i] = i;
+    m_cqHead = ringPointer<unsigned>(m_cqRing, params.cq_off.head);
+    m_cqTail = ringPointer<unsigned>(m_cqRing, params.cq_off.tail);
+    m_cqMask = *ringPointer<unsigned>(m_cqRing, params.cq_off.ring_mask);
+    m_cqes = ringPointer<io_uring_cqe>(m_cqRing, params.cq_off.cqes);
+
+    void* bufferRing = mmap(nullptr, BUFFER_COUNT * sizeof(io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufferRing == MAP_FAILED) return false;
+    m_bufferRing = (io_uring_buf*) bufferRing;
+    io_uring_buf_reg registration {};
+    registration.ring_addr = (uint64_t) m_bufferRing;
+    registration.ring_entries = BUFFER_COUNT;
+    registration.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        m_logger.warning(std::string("Failed to register the io_uring buffer ring: ") + std::strerror(errno));
+        return false;
+    }
+    m_buffers.resize(size_t(BUFFER_COUNT) * BUFFER_SIZE);
+    for (unsigned short id = 0; id < BUFFER_COUNT; id++) recycleBuffer(id);
+
+    m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_eventFd < 0 || syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_EVENTFD, &m_eventFd, 1) < 0) {
+        m_logger.warning(std::string("Failed to register the io_uring eventfd: ") + std::strerror(errno));
+        return false;
+    }
+    m_completionEvent = event_new(base, m_eventFd, EV_READ | EV_PERSIST, onCompletions, this);
+    m_submitEvent = event_new(base, -1, 0, onSubmit, this);
+    return m_completionEvent && m_submitEvent && !event_add(m_completionEvent, nullptr);
+}
+void IOUring::onCompletions(evutil_socket_t, short, void* ptr) {
+    IOUring* ring = (IOUring*) ptr;
+    uint64_t count = 0;
+    if (read(ring->m_eventFd, &count, sizeof(count)) < 0 && errno != EAGAIN) ring->m_logger.error("Failed to read the io_uring eventfd");
+    unsigned head = *ring->m_cqHead;
+    while (head != __atomic_load_n(ring->m_cqTail, __ATOMIC_ACQUIRE)) {
+        // copied and consumed first, handlers may submit and reap again
+        io_uring_cqe cqe = ring->m_cqes[head & ring->m_cqMask];
+        __atomic_store_n(ring->m_cqHead, ++head, __ATOMIC_RELEASE);
+        void* target = (void*) (cqe.user_data & ~uint64_t(3));
+        switch ((Operation) (cqe.user_data & 3)) {
+        case Accept: {
+            evutil_socket_t listener = (evutil_socket_t) (cqe.user_data >> 2);
+            if (cqe.res >= 0) {
+                sockaddr_storage addr {};
+                socklen_t length = sizeof(addr);
+                if (getpeername(cqe.res, (struct sockaddr*) &addr, &length)) evutil_closesocket(cqe.res);
+                else ring->m_onAccept(nullptr, cqe.res, (struct sockaddr*) &addr, (int) length, ring->m_acceptArg);
+            } else if (cqe.res != -ECANCELED) ring->m_logger.warning(std::string("Accept failed: ") + std::strerror(-cqe.res));
+            if (!(cqe.flags & IORING_CQE_F_MORE) && std::find(ring->m_listeners.begin(), ring->m_listeners.end(), listener) != ring->m_listeners.end())
+                ring->armAccept(listener);
+            break;
+        }
+        case Receive: ((IOUringStream*) target)->onReceive(cqe); break;
+        case Send: ((IOUringStream*) target)->onSend(cqe); break;
+        case Cancel: break;
+        }
+    }
+}
+void IOUring::onSubmit(evutil_socket_t, short, void* ptr) {
+    IOUring* ring = (IOUring*) ptr;
+    ring->m_submitScheduled = false;
+    std::vector<IOUringStream*> queue;
+    queue.swap(ring->m_queue);
+    for (IOUringStream* stream : queue) stream->flush();
+    ring->submit();
+    for (IOUringStream* stream : ring->m_released) delete stream;
+    ring->m_released.clear();
+}
+void IOUring::scheduleSubmit() {
+    if (m_submitScheduled) return;
+    m_submitScheduled = true;
+    // runs after everything already active in this loop iteration, which batches their submissions
+    event_active(m_submitEvent, EV_WRITE, 0);
+}
+void IOUring::submit() {
+    if (!m_toSubmit) return;
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+    long submitted = syscall(__NR_io_uring_enter, m_fd, m_toSubmit, 0, 0, nullptr, 0);
+    if (submitted < 0) {
+        if (errno != EAGAIN && errno != EBUSY && errno != EINTR) m_logger.error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+        scheduleSubmit();
+        return;
+    }
+    m_toSubmit -= zinc_safe_cast<long, unsigned>(submitted);
+}
+void IOUring::armAccept(const evutil_socket_t& listener) {
+    io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        m_logger.error("io_uring submission queue is full, can't accept on fd " + std::to_string(listener));
+        return;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listener;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = ((uint64_t) listener << 2) | Accept;
+}
+void IOUring::listen(const evutil_socket_t& fd) {
+    m_listeners.push_back(fd);
+    armAccept(fd);
+}
+void IOUring::closeListeners() {
+    for (evutil_socket_t listener : m_listeners) {
+        if (io_uring_sqe* sqe = getSqe()) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = listener;
+            sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+            sqe->user_data = tag(nullptr, Cancel);
+        }
+    }
+    submit();
+    for (evutil_socket_t listener : m_listeners) evutil_closesocket(listener);
+    m_listeners.clear();
+}
+IOUringStream* IOUring::createStream(const evutil_socket_t& fd) {
+    return new IOUringStream(this, fd);
+}
+io_uring_sqe* IOUring::getSqe() {
+    if (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) {
+        submit();
+        if (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) return nullptr;
+    }
+    io_uring_sqe* sqe = &m_sqes[m_sqLocalTail & m_sqMask];
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    m_sqLocalTail++;
+    m_toSubmit++;
+    scheduleSubmit();
+    return sqe;
+}
+void IOUring::schedule(IOUringStream* stream) {
+    m_queue.push_back(stream);
+    scheduleSubmit();
+}
+void IOUring::release(IOUringStream* stream) {
+    m_released.push_back(stream);
+    scheduleSubmit();
+}
+const unsigned char* IOUring::getBuffer(const unsigned short& id) const {
+    return m_buffers.data() + size_t(id) * BUFFER_SIZE;
+}
+void IOUring::recycleBuffer(const unsigned short& id) {
+    io_uring_buf& buffer = m_bufferRing[m_bufferTail & (BUFFER_COUNT - 1)];
+    buffer.addr = (uint64_t) getBuffer(id);
+    buffer.len = BUFFER_SIZE;
+    buffer.bid = id;
+    m_bufferTail++;
+    __atomic_store_n(&m_bufferRing[0].resv, m_bufferTail, __ATOMIC_RELEASE);
+}
+
+}
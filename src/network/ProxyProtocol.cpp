@@ -0,0 +1,127 @@
+#include <network/ProxyProtocol.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+
+namespace zinc {
+
+namespace {
+
+constexpr unsigned char V1_SIGNATURE[] = { 'P', 'R', 'O', 'X', 'Y', ' ' };
+constexpr unsigned char V2_SIGNATURE[] = { '\r', '\n', '\r', '\n', 0, '\r', '\n', 'Q', 'U', 'I', 'T', '\n' };
+
+// 1 if data starts with the signature, 0 if it is a prefix of it, -1 otherwise
+template<size_t N> int matchSignature(const unsigned char* data, const size_t& length, const unsigned char (&signature)[N]) {
+    if (std::memcmp(data, signature, std::min(length, N))) return -1;
+    return length >= N ? 1 : 0;
+}
+bool parsePort(const std::string& text, unsigned short& port) {
+    if (text.empty() || text.size() > 5 || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) return false;
+    unsigned long value = std::stoul(text);
+    if (value > 65535) return false;
+    port = (unsigned short) value;
+    return true;
+}
+bool parseAddress(const std::string& text, const int& family, sockaddr_storage& address) {
+    if (family == AF_INET) {
+        sockaddr_in* sin = (sockaddr_in*) &address;
+        sin->sin_family = AF_INET;
+        return inet_pton(AF_INET, text.c_str(), &sin->sin_addr) == 1;
+    }
+    sockaddr_in6* sin6 = (sockaddr_in6*) &address;
+    sin6->sin6_family = AF_INET6;
+    return inet_pton(AF_INET6, text.c_str(), &sin6->sin6_addr) == 1;
+}
+// "PROXY TCP4 <src> <dst> <srcport> <dstport>\r\n", or "PROXY UNKNOWN ...\r\n"
+int parseV1(const unsigned char* data, const size_t& length, ProxyHeader& header) {
+    const unsigned char* end = nullptr;
+    for (size_t i = 1; i < std::min(length, ProxyProtocol::MAX_V1_LENGTH); i++) if (data[i - 1] == '\r' && data[i] == '\n') {
+        end = data + i - 1;
+        break;
+    }
+    if (!end) return length >= ProxyProtocol::MAX_V1_LENGTH ? -1 : 0;
+    int headerLength = (int) (end - data) + 2;
+    std::array<std::string, 6> fields;
+    size_t count = 0;
+    for (const unsigned char* it = data + sizeof(V1_SIGNATURE); it <= end; it++) {
+        if (it == end || *it == ' ') {
+            if (++count == fields.size()) break;
+            continue;
+        }
+        fields[count].push_back((char) *it);
+    }
+    if (fields[0] == "UNKNOWN") {
+        header.m_isLocal = true;
+        return headerLength;
+    }
+    if (count != 5 || (fields[0] != "TCP4" && fields[0] != "TCP6")) return -1;
+    int family = fields[0] == "TCP4" ? AF_INET : AF_INET6;
+    sockaddr_storage destination {};
+    unsigned short sourcePort = 0, destinationPort = 0;
+    header.m_source = sockaddr_storage {};
+    if (!parseAddress(fields[1], family, header.m_source) || !parseAddress(fields[2], family, destination) ||
+        !parsePort(fields[3], sourcePort) || !parsePort(fields[4], destinationPort)) return -1;
+    if (family == AF_INET) ((sockaddr_in*) &header.m_source)->sin_port = htons(sourcePort);
+    else ((sockaddr_in6*) &header.m_source)->sin6_port = htons(sourcePort);
+    header.m_isLocal = false;
+    return headerLength;
+}
+int parseV2(const unsigned char* data, const size_t& length, ProxyHeader& header) {
+    if (length < ProxyProtocol::V2_HEADER_LENGTH) return 0;
+    unsigned char version = (unsigned char) (data[12] >> 4), command = (unsigned char) (data[12] & 0x0F), family = (unsigned char) (data[13] >> 4);
+    size_t addressLength = (size_t) ((data[14] << 8) | data[15]);
+    size_t headerLength = ProxyProtocol::V2_HEADER_LENGTH + addressLength;
+    if (version != 2 || command > 1 || headerLength > ProxyProtocol::MAX_HEADER_LENGTH) return -1;
+    if (length < headerLength) return 0;
+    const unsigned char* addresses = data + ProxyProtocol::V2_HEADER_LENGTH;
+    header.m_source = sockaddr_storage {};
+    header.m_isLocal = false;
+    // LOCAL connections, UNSPEC and UNIX sockets carry no usable client address
+    if (command == 0 || (family != 1 && family != 2)) header.m_isLocal = true;
+    else if (family == 1) {
+        if (addressLength < 12) return -1;
+        sockaddr_in* sin = (sockaddr_in*) &header.m_source;
+        sin->sin_family = AF_INET;
+        std::memcpy(&sin->sin_addr, addresses, 4);
+        std::memcpy(&sin->sin_port, addresses + 8, 2);
+    } else {
+        if (addressLength < 36) return -1;
+        sockaddr_in6* sin6 = (sockaddr_in6*) &header.m_source;
+        sin6->sin6_family = AF_INET6;
+        std::memcpy(&sin6->sin6_addr, addresses, 16);
+        std::memcpy(&sin6->sin6_port, addresses + 32, 2);
+    }
+    return (int) headerLength;
+}
+
+}
+
+int ProxyProtocol::parse(const unsigned char* data, const size_t& length, ProxyHeader& header) {
+    if (!length) return 0;
+    if (data[0] == V1_SIGNATURE[0]) {
+        int match = matchSignature(data, length, V1_SIGNATURE);
+        return match <= 0 ? match : parseV1(data, length, header);
+    }
+    int match = matchSignature(data, length, V2_SIGNATURE);
+    return match <= 0 ? match : parseV2(data, length, header);
+}
+int ProxyProtocol::read(evbuffer* input, ProxyHeader& header) {
+    size_t available = evbuffer_get_length(input);
+    size_t length = std::min(available, MAX_HEADER_LENGTH);
+    if (!length) return 0;
+    evbuffer_iovec chunk;
+    std::array<unsigned char, MAX_HEADER_LENGTH> scratch;
+    const unsigned char* data = scratch.data();
+    // the header almost always arrives in the first read, only a header split across chunks is copied out
+    if (evbuffer_peek(input, (ev_ssize_t) length, nullptr, &chunk, 1) >= 1 && chunk.iov_len >= length) data = (const unsigned char*) chunk.iov_base;
+    else evbuffer_copyout(input, scratch.data(), length);
+    int result = parse(data, length, header);
+    if (result > 0) evbuffer_drain(input, (size_t) result);
+    if (!result && available >= MAX_HEADER_LENGTH) return -1;
+    return result;
+}
+
+}
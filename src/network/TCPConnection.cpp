@@ -1,49 +1,62 @@
 #include <network/TCPConnection.h>
 #include <util/TCPUtil.h>
+#include <cstring>
 
 namespace zinc {
 
 std::string TCPConnection::getIP() const {
     return m_ip;
 }
-struct sockaddr* TCPConnection::getAddr() const {
-    return m_addr;
+const struct sockaddr* TCPConnection::getAddr() const {
+    return (const struct sockaddr*) &m_addr;
 }
-bufferevent* TCPConnection::getBuffer() {
-    return m_bev;
+TCPStream* TCPConnection::getStream() {
+    return m_stream;
 }
-const bufferevent* TCPConnection::getBuffer() const {
-    return m_bev;
+const TCPStream* TCPConnection::getStream() const {
+    return m_stream;
 }
 evutil_socket_t TCPConnection::getFd() const {
     return m_fd;
 }
-void TCPConnection::setBuffer(bufferevent *bev) {
-    m_bev = bev;
+void TCPConnection::setStream(TCPStream* stream) {
+    m_stream = stream;
 }
-void TCPConnection::setAddr(struct sockaddr* addr) {
-    m_addr = addr;
+void TCPConnection::setAddr(const struct sockaddr* addr) {
     m_ip.clear();
     m_ip.resize(INET6_ADDRSTRLEN);
     if (addr->sa_family == AF_INET) {
-        struct sockaddr_in* sin = (struct sockaddr_in*)addr;
+        std::memcpy(&m_addr, addr, sizeof(struct sockaddr_in));
+        const struct sockaddr_in* sin = (const struct sockaddr_in*)addr;
+        inet_ntop(AF_INET, &sin->sin_addr, m_ip.data(), INET6_ADDRSTRLEN);
+    } else if (IN6_IS_ADDR_V4MAPPED(&((const struct sockaddr_in6*)addr)->sin6_addr)) {
+        // IPv4 peers of a dual-stack listener look the same as on an IPv4 one, so bans and PROXY sources keep matching
+        const struct sockaddr_in6* sin6 = (const struct sockaddr_in6*)addr;
+        struct sockaddr_in* sin = (struct sockaddr_in*)&m_addr;
+        m_addr = {};
+        sin->sin_family = AF_INET;
+        sin->sin_port = sin6->sin6_port;
+        std::memcpy(&sin->sin_addr, sin6->sin6_addr.s6_addr + 12, sizeof(sin->sin_addr));
         inet_ntop(AF_INET, &sin->sin_addr, m_ip.data(), INET6_ADDRSTRLEN);
     } else {
-        struct sockaddr_in6* sin6 = (struct sockaddr_in6*)addr;
+        std::memcpy(&m_addr, addr, sizeof(struct sockaddr_in6));
+        const struct sockaddr_in6* sin6 = (const struct sockaddr_in6*)addr;
         inet_ntop(AF_INET6, &sin6->sin6_addr, m_ip.data(), INET6_ADDRSTRLEN);
     }
+    m_ip.resize(std::strlen(m_ip.c_str())); // bans compare the address as a string
 }
 void TCPConnection::setFd(evutil_socket_t fd) {
     m_fd = fd;
 }
 void TCPConnection::send(const ByteBuffer& data) {
-    TCPUtil::send(m_bev, data);
+    TCPUtil::send(m_stream, data);
 }
 ByteBuffer TCPConnection::read() {
-    return TCPUtil::read(m_bev);
+    return TCPUtil::read(m_stream);
 }
 void TCPConnection::close() {
-    if (m_bev) bufferevent_free(m_bev);
+    if (m_stream) m_stream->close();
+    m_stream = nullptr;
 }
 bool TCPConnection::operator==(const TCPConnection& connection) const {
     return m_fd == connection.getFd();
@@ -1,33 +1,210 @@
 #include <network/TCPServer.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
 
 namespace zinc {
 
+void TCPServer::setOption(const evutil_socket_t& fd, const int& level, const int& name, const int& value, const std::string& description) {
+    // tuning options are best effort, the listener still works with kernel defaults
+    if (setsockopt(fd, level, name, &value, sizeof(value))) m_logger.warning("Failed to set " + description + ": " + std::strerror(errno));
+}
+evutil_socket_t TCPServer::bindEndpoint(const TCPBindEndpoint& endpoint) {
+    sockaddr_storage addr {};
+    socklen_t length = 0;
+    unsigned short port = htons(endpoint.m_port ? endpoint.m_port : m_port);
+    sockaddr_in* sin = (sockaddr_in*) &addr;
+    sockaddr_in6* sin6 = (sockaddr_in6*) &addr;
+    if (inet_pton(AF_INET, endpoint.m_address.c_str(), &sin->sin_addr) == 1) {
+        sin->sin_family = AF_INET;
+        sin->sin_port = port;
+        length = sizeof(sockaddr_in);
+    } else if (inet_pton(AF_INET6, endpoint.m_address.c_str(), &sin6->sin6_addr) == 1) {
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = port;
+        length = sizeof(sockaddr_in6);
+    } else {
+        m_logger.error("Invalid bind address " + endpoint.m_address);
+        return -1;
+    }
+    evutil_socket_t fd = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (fd < 0 && errno == EAFNOSUPPORT && endpoint.m_address == "::") {
+        m_logger.warning("IPv6 is not available, listening on 0.0.0.0 instead");
+        TCPBindEndpoint fallback = endpoint;
+        fallback.m_address = "0.0.0.0";
+        return bindEndpoint(fallback);
+    }
+    if (fd < 0) {
+        m_logger.error("Failed to create socket for " + endpoint.m_address + ": " + std::strerror(errno));
+        return -1;
+    }
+    evutil_make_socket_nonblocking(fd);
+    evutil_make_socket_closeonexec(fd);
+    evutil_make_listen_socket_reuseable(fd);
+    // every reactor binds its own listener and lets the kernel balance accepts between them
+    if (m_reactorCount > 1) evutil_make_listen_socket_reuseable_port(fd);
+    if (addr.ss_family == AF_INET6) setOption(fd, IPPROTO_IPV6, IPV6_V6ONLY, endpoint.m_ipv6Only, "IPV6_V6ONLY");
+#ifdef SO_BINDTODEVICE
+    if (!endpoint.m_interface.empty() &&
+        setsockopt(fd, SOL_SOCKET, SO_BINDTODEVICE, endpoint.m_interface.c_str(), zinc_safe_cast<size_t, socklen_t>(endpoint.m_interface.size()))) {
+        m_logger.warning("Failed to bind to interface " + endpoint.m_interface + ": " + std::strerror(errno));
+    }
+#endif
+    if (endpoint.m_noDelay) setOption(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+#ifdef TCP_DEFER_ACCEPT
+    if (endpoint.m_deferAccept > 0) setOption(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, endpoint.m_deferAccept, "TCP_DEFER_ACCEPT");
+#endif
+    // buffer sizes have to be set before listen() so the window scale is negotiated with them
+    if (endpoint.m_receiveBuffer > 0) setOption(fd, SOL_SOCKET, SO_RCVBUF, endpoint.m_receiveBuffer, "SO_RCVBUF");
+    if (endpoint.m_sendBuffer > 0) setOption(fd, SOL_SOCKET, SO_SNDBUF, endpoint.m_sendBuffer, "SO_SNDBUF");
+#ifdef TCP_FASTOPEN
+    if (endpoint.m_fastOpenQueue > 0) setOption(fd, IPPROTO_TCP, TCP_FASTOPEN, endpoint.m_fastOpenQueue, "TCP_FASTOPEN");
+#endif
+    if (bind(fd, (struct sockaddr*) &addr, length)) {
+        m_logger.error("Failed to bind " + endpoint.m_address + " port " + std::to_string(ntohs(port)) + ": " + std::strerror(errno));
+        evutil_closesocket(fd);
+        return -1;
+    }
+    return fd;
+}
+void TCPServer::startReactor(TCPReactor& reactor) {
+    reactor.m_base = event_base_new();
+    if (!reactor.m_base) {
+        m_logger.error("Failed to create event base", true);
+    }
+    if (m_transport == TCPTransport::IOUring) {
+        reactor.m_uring = new IOUring();
+        if (!reactor.m_uring->init(reactor.m_base, m_onAccept, &reactor)) {
+            if (!reactor.m_id) m_logger.warning("io_uring is not available, using the libevent transport");
+            delete reactor.m_uring;
+            reactor.m_uring = nullptr;
+        }
+    }
+    std::vector<TCPBindEndpoint> endpoints = m_endpoints;
+    if (endpoints.empty()) endpoints.push_back(TCPBindEndpoint());
+    for (const TCPBindEndpoint& endpoint : endpoints) {
+        evutil_socket_t fd = bindEndpoint(endpoint);
+        if (reactor.m_uring) {
+            if (fd < 0 || ::listen(fd, endpoint.m_backlog < 0 ? SOMAXCONN : endpoint.m_backlog)) {
+                if (fd >= 0) evutil_closesocket(fd);
+                m_logger.error("Failed to create listener", true);
+            }
+            reactor.m_uring->listen(fd);
+            if (!reactor.m_id) m_logger.debug("Listening on " + endpoint.m_address + " port " + std::to_string(endpoint.m_port ? endpoint.m_port : m_port) + " (io_uring)");
+            continue;
+        }
+        evconnlistener* listener = fd < 0 ? nullptr : evconnlistener_new(reactor.m_base, m_onAccept, &reactor, LEV_OPT_CLOSE_ON_FREE, endpoint.m_backlog, fd);
+        if (!listener) {
+            if (fd >= 0) evutil_closesocket(fd);
+            m_logger.error("Failed to create listener", true);
+        }
+        reactor.m_listeners.push_back(listener);
+        if (!reactor.m_id) m_logger.debug("Listening on " + endpoint.m_address + " port " + std::to_string(endpoint.m_port ? endpoint.m_port : m_port));
+    }
+    reactor.m_taskEvent = event_new(reactor.m_base, -1, 0, onTasks, &reactor);
+    if (!reactor.m_taskEvent) {
+        m_logger.error("Failed to create reactor task event", true);
+    }
+    // one periodic event drives every connection timeout of this reactor
+    reactor.m_timerEvent = event_new(reactor.m_base, -1, EV_PERSIST, onTimer, &reactor);
+    struct timeval tick = { 0, TIMER_TICK_MILLISECONDS * 1000 };
+    if (!reactor.m_timerEvent || event_add(reactor.m_timerEvent, &tick)) {
+        m_logger.error("Failed to create reactor timer event", true);
+    }
+    reactor.m_timerStart = std::chrono::steady_clock::now();
+}
+void TCPServer::onTasks(evutil_socket_t, short, void* ptr) {
+    TCPReactor* reactor = (TCPReactor*) ptr;
+    std::deque<std::function<void()>> tasks;
+    reactor->m_taskMutex.lock();
+    tasks.swap(reactor->m_tasks);
+    reactor->m_taskMutex.unlock();
+    for (const std::function<void()>& task : tasks) task();
+}
+void TCPServer::onTimer(evutil_socket_t, short, void* ptr) {
+    TCPReactor* reactor = (TCPReactor*) ptr;
+    // catch up on ticks missed while the loop was busy
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - reactor->m_timerStart).count();
+    uint64_t tick = zinc_safe_cast<int64_t, uint64_t>(elapsed / TIMER_TICK_MILLISECONDS);
+    if (tick > reactor->m_timers.getTick()) reactor->m_timers.advance(tick - reactor->m_timers.getTick());
+}
 void TCPServer::start() {
     if (!m_port) return;
-    if (m_base == nullptr) return;
-    struct sockaddr_in sin;
-    memset(&sin, 0, sizeof(sin));
-    sin.sin_family = AF_INET;
-    sin.sin_port = htons(m_port);
-
-    m_listener = evconnlistener_new_bind(m_base, m_onAccept, m_base, LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE, -1, (struct sockaddr*)&sin, sizeof(sin));
-    if (!m_listener) {
-        m_logger.error("Failed to create listener", true);
+    if (m_onAccept == nullptr) return;
+    m_reactors.resize(m_reactorCount);
+    for (size_t i = 0; i < m_reactorCount; i++) {
+        m_reactors[i].m_id = i;
+        startReactor(m_reactors[i]);
     }
-    m_logger.debug("Started TCPServer");
+    m_logger.debug("Started TCPServer with " + std::to_string(m_reactorCount) + " reactor(s)");
     m_started = true;
-    event_base_dispatch(m_base);
+    for (size_t i = 1; i < m_reactorCount; i++) {
+        m_reactors[i].m_thread = std::thread(event_base_dispatch, m_reactors[i].m_base);
+    }
+    event_base_dispatch(m_reactors[0].m_base);
+    for (size_t i = 1; i < m_reactorCount; i++) {
+        if (m_reactors[i].m_thread.joinable()) m_reactors[i].m_thread.join();
+    }
 }
 void TCPServer::stop() {
     if (!m_started) return;
     m_logger.debug("Stopped TCPServer");
-    if (m_listener) {
-        evconnlistener_free(m_listener);
-        m_listener = nullptr;
+    for (TCPReactor& reactor : m_reactors) {
+        for (evconnlistener* listener : reactor.m_listeners) evconnlistener_free(listener);
+        reactor.m_listeners.clear();
+        if (reactor.m_uring) {
+            IOUring* uring = reactor.m_uring;
+            post(reactor.m_id, [uring]() { uring->closeListeners(); });
+        }
+        if (reactor.m_base) event_base_loopexit(reactor.m_base, nullptr);
     }
+    m_started = false;
+}
+void TCPServer::post(const size_t& reactorId, const std::function<void()>& task) {
+    if (reactorId >= m_reactors.size() || !m_reactors[reactorId].m_taskEvent) return;
+    TCPReactor& reactor = m_reactors[reactorId];
+    reactor.m_taskMutex.lock();
+    reactor.m_tasks.push_back(task);
+    reactor.m_taskMutex.unlock();
+    event_active(reactor.m_taskEvent, EV_READ, 0);
+}
+TimerWheel::TimerId TCPServer::schedule(const size_t& reactorId, const uint64_t& delayMilliseconds, const std::function<void()>& callback) {
+    if (reactorId >= m_reactors.size()) return TimerWheel::TimerId();
+    uint64_t tick = zinc_safe_cast<int, uint64_t>(TIMER_TICK_MILLISECONDS);
+    return m_reactors[reactorId].m_timers.schedule((delayMilliseconds + tick - 1) / tick, callback);
+}
+bool TCPServer::cancel(const size_t& reactorId, TimerWheel::TimerId& id) {
+    if (reactorId >= m_reactors.size()) return false;
+    return m_reactors[reactorId].m_timers.cancel(id);
+}
+TCPStream* TCPServer::createStream(TCPReactor* reactor, const evutil_socket_t& fd) {
+    if (reactor->m_uring) return reactor->m_uring->createStream(fd);
+    return LibeventStream::create(reactor->m_base, fd);
 }
 void TCPServer::setPort(const unsigned short& port) {
     m_port = port;
 }
+void TCPServer::setEndpoints(const std::vector<TCPBindEndpoint>& endpoints) {
+    if (m_started) return;
+    m_endpoints = endpoints;
+}
+void TCPServer::setReactorCount(const size_t& reactorCount) {
+    if (m_started) return;
+    m_reactorCount = std::max<size_t>(reactorCount, 1);
+}
+void TCPServer::setTransport(const TCPTransport& transport) {
+    if (m_started) return;
+    m_transport = transport;
+}
+size_t TCPServer::getReactorCount() const {
+    return m_reactorCount;
+}
+TCPReactor* TCPServer::getReactor(const size_t& reactorId) {
+    if (reactorId >= m_reactors.size()) return nullptr;
+    return &m_reactors[reactorId];
+}
 
 }
@@ -0,0 +1,54 @@
+#include <network/TCPStream.h>
+
+namespace zinc {
+
+LibeventStream* LibeventStream::create(event_base* base, const evutil_socket_t& fd) {
+    bufferevent* bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+    if (!bev) return nullptr;
+    return new LibeventStream(bev);
+}
+void LibeventStream::onRead(bufferevent*, void* ptr) {
+    LibeventStream* stream = (LibeventStream*) ptr;
+    if (stream->m_onRead) stream->m_onRead(stream, stream->m_ctx);
+}
+void LibeventStream::onWrite(bufferevent*, void* ptr) {
+    LibeventStream* stream = (LibeventStream*) ptr;
+    if (stream->m_onWrite) stream->m_onWrite(stream, stream->m_ctx);
+}
+void LibeventStream::onEvent(bufferevent*, short events, void* ptr) {
+    LibeventStream* stream = (LibeventStream*) ptr;
+    if (stream->m_onEvent) stream->m_onEvent(stream, events, stream->m_ctx);
+}
+evbuffer* LibeventStream::getInput() {
+    return bufferevent_get_input(m_bev);
+}
+evbuffer* LibeventStream::getOutput() {
+    return bufferevent_get_output(m_bev);
+}
+size_t LibeventStream::getOutputLength() {
+    return evbuffer_get_length(bufferevent_get_output(m_bev));
+}
+evutil_socket_t LibeventStream::getFd() const {
+    return bufferevent_getfd(m_bev);
+}
+void LibeventStream::setCallbacks(TCPStreamCallback onRead, TCPStreamCallback onWrite, TCPStreamEventCallback onEvent, void* ctx) {
+    m_onRead = onRead;
+    m_onWrite = onWrite;
+    m_onEvent = onEvent;
+    m_ctx = ctx;
+    bufferevent_setcb(m_bev, LibeventStream::onRead, LibeventStream::onWrite, LibeventStream::onEvent, this);
+}
+void LibeventStream::enableRead() {
+    bufferevent_enable(m_bev, EV_READ);
+}
+void LibeventStream::disableRead() {
+    bufferevent_disable(m_bev, EV_READ);
+}
+void LibeventStream::setWriteLowWatermark(const size_t& watermark) {
+    bufferevent_setwatermark(m_bev, EV_WRITE, watermark, 0);
+}
+void LibeventStream::close() {
+    delete this;
+}
+
+}
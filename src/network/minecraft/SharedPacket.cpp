@@ -0,0 +1,33 @@
+#include <network/minecraft/SharedPacket.h>
+#include <network/minecraft/ZincConnection.h>
+
+namespace zinc {
+
+SharedPacket::SharedPacket(ZincPacket packet) : m_state(std::make_shared<State>()) {
+    m_state->m_packet = std::move(packet);
+}
+int SharedPacket::getId() const {
+    return m_state ? m_state->m_packet.getId() : -1;
+}
+const ByteBuffer& SharedPacket::getData() const {
+    static const ByteBuffer empty;
+    return m_state ? m_state->m_packet.getData() : empty;
+}
+const std::vector<char>* SharedPacket::getFrame(const bool& isCompressed) const {
+    if (!m_state) return nullptr;
+    State& state = *m_state;
+    const size_t index = isCompressed ? 1 : 0;
+    // recipients on other reactors may ask at the same time, the first one frames and the rest wait for it
+    std::call_once(state.m_isFramed[index], [&state, &index, &isCompressed]() {
+        evbuffer* output = evbuffer_new();
+        if (ZincConnection::writeFrame(output, state.m_packet, isCompressed)) {
+            state.m_frames[index].resize(evbuffer_get_length(output));
+            evbuffer_remove(output, state.m_frames[index].data(), state.m_frames[index].size());
+            state.m_isValid[index] = true;
+        }
+        evbuffer_free(output);
+    });
+    return state.m_isValid[index] ? &state.m_frames[index] : nullptr;
+}
+
+}
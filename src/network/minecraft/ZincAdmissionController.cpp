@@ -0,0 +1,164 @@
+#include <network/minecraft/ZincAdmissionController.h>
+#include <ZincConfig.h>
+#include <netinet/in.h>
+#include <algorithm>
+#include <cstring>
+
+namespace zinc {
+
+ZincAdmissionController g_zincAdmissionController;
+
+ZincAddressKey::ZincAddressKey(const struct sockaddr* addr) {
+    if (addr->sa_family == AF_INET) {
+        const struct sockaddr_in* sin = (const struct sockaddr_in*) addr;
+        m_low = 0x0000FFFF00000000ULL | ntohl(sin->sin_addr.s_addr);
+    } else if (addr->sa_family == AF_INET6) {
+        const unsigned char* bytes = ((const struct sockaddr_in6*) addr)->sin6_addr.s6_addr;
+        for (size_t i = 0; i < 8; i++) {
+            m_high = (m_high << 8) | bytes[i];
+            m_low = (m_low << 8) | bytes[i + 8];
+        }
+    }
+}
+bool ZincAddressKey::isIPv4() const {
+    return !m_high && (m_low >> 32) == 0x0000FFFFULL;
+}
+ZincAddressKey ZincAddressKey::getSubnet() const {
+    if (isIPv4()) return ZincAddressKey(m_high, m_low & 0xFFFFFFFFFFFFFF00ULL);
+    return ZincAddressKey(m_high, 0);
+}
+bool ZincAddressKey::operator==(const ZincAddressKey& key) const {
+    return m_high == key.m_high && m_low == key.m_low;
+}
+bool ZincAddressKey::operator!=(const ZincAddressKey& key) const {
+    return !operator==(key);
+}
+size_t ZincAddressKeyHash::operator()(const ZincAddressKey& key) const {
+    uint64_t hash = (key.m_high ^ (key.m_low * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+    return static_cast<size_t>(hash ^ (hash >> 31));
+}
+bool ZincTokenBucket::canTake(const std::chrono::steady_clock::time_point& now, const double& rate, const double& capacity) {
+    if (rate <= 0) return true;
+    double elapsed = std::chrono::duration<double>(now - m_lastRefill).count();
+    m_tokens = std::min(capacity, m_tokens + elapsed * rate);
+    m_lastRefill = now;
+    return m_tokens >= 1;
+}
+bool ZincTokenBucket::take(const std::chrono::steady_clock::time_point& now, const double& rate, const double& capacity) {
+    if (!canTake(now, rate, capacity)) return false;
+    if (rate > 0) m_tokens--;
+    return true;
+}
+bool ZincTokenBucket::isFull(const std::chrono::steady_clock::time_point& now, const double& rate, const double& capacity) const {
+    if (rate <= 0) return true;
+    return m_tokens + std::chrono::duration<double>(now - m_lastRefill).count() * rate >= capacity;
+}
+double ZincAdmissionController::getAddressRate() {
+    if (g_zincConfig.m_core.m_security.m_rateLimit <= 0) return 0;
+    return 1.0 / g_zincConfig.m_core.m_security.m_rateLimit;
+}
+double ZincAdmissionController::getSubnetRate() {
+    return std::max(g_zincConfig.m_core.m_security.m_subnetConnectionRate, 0);
+}
+ZincAdmissionController::Shard& ZincAdmissionController::getShard(const ZincAddressKey& key) {
+    // an address and its subnet always share a shard
+    return m_shards[ZincAddressKeyHash()(key.getSubnet()) % m_shards.size()];
+}
+void ZincAdmissionController::sweep(Shard& shard, const std::chrono::steady_clock::time_point& now) {
+    double addressRate = getAddressRate(), subnetRate = getSubnetRate();
+    double addressCapacity = std::max(g_zincConfig.m_core.m_security.m_connectionBurst, 1);
+    double subnetCapacity = std::max(g_zincConfig.m_core.m_security.m_subnetConnectionBurst, 1);
+    std::erase_if(shard.m_addresses, [&](const auto& entry) {
+        if (entry.second.m_connections || !entry.second.m_bucket.isFull(now, addressRate, addressCapacity)) return false;
+        shard.m_idle.erase(entry.second.m_idle);
+        return true;
+    });
+    std::erase_if(shard.m_subnets, [&](const auto& entry) {
+        if (!entry.second.m_bucket.isFull(now, subnetRate, subnetCapacity)) return false;
+        shard.m_idle.erase(entry.second.m_idle);
+        return true;
+    });
+    shard.m_lastSweep = now;
+}
+bool ZincAdmissionController::makeRoom(Shard& shard, const size_t& count, const Entry* address, const Entry* subnet) {
+    while (shard.m_addresses.size() + shard.m_subnets.size() + count > MAX_ENTRIES_PER_SHARD) {
+        if (shard.m_idle.empty()) return false;
+        const auto& [key, isSubnet] = shard.m_idle.back();
+        EntryMap& entries = isSubnet ? shard.m_subnets : shard.m_addresses;
+        auto it = entries.find(key);
+        // the entries of this attempt were just moved to the front, reaching them means nothing else is left
+        if (&it->second == address || &it->second == subnet) return false;
+        entries.erase(it);
+        shard.m_idle.pop_back();
+    }
+    return true;
+}
+bool ZincAdmissionController::admit(const ZincAddressKey& key) {
+    return admit(key, std::chrono::steady_clock::now());
+}
+bool ZincAdmissionController::admit(const ZincAddressKey& key, const std::chrono::steady_clock::time_point& now) {
+    double addressRate = getAddressRate(), subnetRate = getSubnetRate();
+    double addressCapacity = std::max(g_zincConfig.m_core.m_security.m_connectionBurst, 1);
+    double subnetCapacity = std::max(g_zincConfig.m_core.m_security.m_subnetConnectionBurst, 1);
+    int maxConnections = g_zincConfig.m_core.m_security.m_maxConcurrentAccount;
+    Shard& shard = getShard(key);
+    std::lock_guard lock(shard.m_mutex);
+    if (now - shard.m_lastSweep >= std::chrono::seconds(SWEEP_INTERVAL)) sweep(shard, now);
+    // only existing entries can refuse, so a refused attempt never creates one
+    // neither bucket pays for a connection the other one refuses
+    auto addressIt = shard.m_addresses.find(key);
+    Entry* address = addressIt != shard.m_addresses.end() ? &addressIt->second : nullptr;
+    Entry* subnet = nullptr;
+    if (subnetRate > 0) {
+        auto subnetIt = shard.m_subnets.find(key.getSubnet());
+        if (subnetIt != shard.m_subnets.end()) subnet = &subnetIt->second;
+    }
+    if (address && maxConnections > 0 && address->m_connections >= maxConnections) return false;
+    if (address && !address->m_bucket.canTake(now, addressRate, addressCapacity)) return false;
+    if (subnet && !subnet->m_bucket.canTake(now, subnetRate, subnetCapacity)) return false;
+
+    if (address && !address->m_connections) shard.m_idle.splice(shard.m_idle.begin(), shard.m_idle, address->m_idle);
+    if (subnet) shard.m_idle.splice(shard.m_idle.begin(), shard.m_idle, subnet->m_idle);
+    bool needsSubnet = subnetRate > 0 && !subnet;
+    if (!makeRoom(shard, size_t(address ? 0 : 1) + size_t(needsSubnet ? 1 : 0), address, subnet)) return false;
+    if (!address) {
+        address = &shard.m_addresses[key];
+        address->m_bucket.m_tokens = addressCapacity;
+        address->m_bucket.m_lastRefill = now;
+    } else if (!address->m_connections) shard.m_idle.erase(address->m_idle); // an address with open connections is never evicted
+    if (needsSubnet) {
+        subnet = &shard.m_subnets[key.getSubnet()];
+        subnet->m_bucket.m_tokens = subnetCapacity;
+        subnet->m_bucket.m_lastRefill = now;
+        subnet->m_idle = shard.m_idle.insert(shard.m_idle.begin(), { key.getSubnet(), true });
+    }
+    address->m_bucket.take(now, addressRate, addressCapacity);
+    if (subnet) subnet->m_bucket.take(now, subnetRate, subnetCapacity);
+    address->m_connections++;
+    return true;
+}
+void ZincAdmissionController::release(const ZincAddressKey& key) {
+    Shard& shard = getShard(key);
+    std::lock_guard lock(shard.m_mutex);
+    auto it = shard.m_addresses.find(key);
+    if (it == shard.m_addresses.end() || it->second.m_connections <= 0) return;
+    if (!--it->second.m_connections) it->second.m_idle = shard.m_idle.insert(shard.m_idle.begin(), { key, false });
+}
+size_t ZincAdmissionController::getTrackedAddresses() {
+    size_t count = 0;
+    for (Shard& shard : m_shards) {
+        std::lock_guard lock(shard.m_mutex);
+        count += shard.m_addresses.size();
+    }
+    return count;
+}
+size_t ZincAdmissionController::getTrackedSubnets() {
+    size_t count = 0;
+    for (Shard& shard : m_shards) {
+        std::lock_guard lock(shard.m_mutex);
+        count += shard.m_subnets.size();
+    }
+    return count;
+}
+
+}
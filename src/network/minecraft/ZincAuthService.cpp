@@ -0,0 +1,113 @@
+#include <network/minecraft/ZincAuthService.h>
+#include <external/JSON.h>
+#include <ZincConfig.h>
+#include <curlpp/cURLpp.hpp>
+#include <curlpp/Easy.hpp>
+#include <curlpp/Infos.hpp>
+#include <curlpp/Options.hpp>
+#include <chrono>
+#include <sstream>
+
+namespace zinc {
+
+ZincAuthService g_zincAuthService;
+
+void ZincAuthService::start(const size_t& workers) {
+    std::lock_guard lock(m_mutex);
+    if (m_started) return;
+    m_started = true;
+    for (size_t i = 0; i < std::max<size_t>(workers, 1); i++) m_workers.emplace_back(&ZincAuthService::worker, this);
+    m_logger.debug("Started " + std::to_string(m_workers.size()) + " auth worker(s)");
+}
+void ZincAuthService::stop() {
+    m_mutex.lock();
+    if (!m_started) {
+        m_mutex.unlock();
+        return;
+    }
+    m_started = false;
+    m_mutex.unlock();
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers) if (worker.joinable()) worker.join();
+    m_workers.clear();
+}
+bool ZincAuthService::submit(const ZincAuthRequest& request) {
+    m_mutex.lock();
+    if (m_requests.size() >= MAX_QUEUED_REQUESTS) {
+        m_mutex.unlock();
+        m_logger.warning("Auth queue is full, refusing login of " + request.m_playerName);
+        return false;
+    }
+    m_requests.push_back(request);
+    m_mutex.unlock();
+    m_condition.notify_one();
+    return true;
+}
+size_t ZincAuthService::getQueueSize() {
+    std::lock_guard lock(m_mutex);
+    return m_requests.size();
+}
+void ZincAuthService::worker() {
+    while (true) {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this]() { return !m_started || !m_requests.empty(); });
+        if (!m_started) return;
+        ZincAuthRequest request = m_requests.front();
+        m_requests.pop_front();
+        lock.unlock();
+        request.m_callback(verify(request));
+    }
+}
+bool ZincAuthService::waitBeforeRetry(const int& attempt) {
+    std::unique_lock lock(m_mutex);
+    // stop() doesn't wait for the backoff, the request then fails as unreachable
+    return !m_condition.wait_for(lock, std::chrono::milliseconds(RETRY_BACKOFF_MILLISECONDS << (attempt - 1)), [this]() { return !m_started; });
+}
+ZincAuthResult ZincAuthService::verify(const ZincAuthRequest& request) {
+    ZincAuthResult result;
+    result.m_unreachable = true;
+    // the name comes straight from Login Start
+    std::string url = g_zincConfig.m_core.m_security.m_sessionServer + "/session/minecraft/hasJoined?username="
+                    + curlpp::escape(request.m_playerName) + "&serverId=" + curlpp::escape(request.m_serverId);
+    std::string profile;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        if (attempt && !waitBeforeRetry(attempt)) return result;
+        try {
+            std::stringstream ss;
+            curlpp::Easy easy;
+            easy.setOpt(new curlpp::options::Url(url));
+            easy.setOpt(new curlpp::options::Timeout(g_zincConfig.m_core.m_security.m_sessionServerTimeout));
+            easy.setOpt(new curlpp::options::WriteStream(&ss));
+            easy.perform();
+            long responseCode = curlpp::infos::ResponseCode::get(easy);
+            if (responseCode >= 500) continue;
+            result.m_unreachable = false;
+            if (responseCode != 200) return result; // 204: player did not join through mojang
+            profile = ss.str();
+            break;
+        } catch (std::exception& e) {
+            m_logger.error(e.what());
+        }
+    }
+    if (result.m_unreachable) return result;
+    // the session server answered, asking again would only get the same malformed profile
+    try {
+        nlohmann::json JSON = nlohmann::json::parse(profile);
+        result.m_playerUUID = uuids::uuid::from_string(std::string(JSON["id"])).value();
+        result.m_playerName = JSON["name"];
+        for (auto const& propertyJSON : JSON["properties"]) {
+            ZincConnectionProperty property;
+            property.m_name = propertyJSON.at("name");
+            property.m_value = propertyJSON.at("value");
+            if (propertyJSON.contains("signature"))
+                property.m_signature = propertyJSON.at("signature");
+            result.m_properties.push_back(property);
+        }
+        result.m_success = true;
+    } catch (std::exception& e) {
+        m_logger.error("Session server sent an invalid profile for " + request.m_playerName + ": " + e.what());
+    }
+    return result;
+}
+
+}
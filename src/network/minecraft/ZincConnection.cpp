@@ -6,6 +6,8 @@
 #include <exception>
 #include <network/minecraft/ZincConnection.h>
 #include <network/minecraft/ZincServer.h>
+#include <network/minecraft/ZincPackets.h>
+#include <registry/DefaultRegistries.h>
 #include <string>
 #include <util/TCPUtil.h>
 #include <util/ZLibUtil.h>
@@ -28,15 +30,9 @@ TCPConnection& ZincConnection::getTCPConnection() {
 TCPConnection ZincConnection::getTCPConnection() const {
     return m_tcpConnection;
 }
-ZincConnection::State& ZincConnection::getState() {
-    return m_state;
-}
 ZincConnection::State ZincConnection::getState() const {
     return m_state;
 }
-bool& ZincConnection::getIsCompressed() {
-    return m_isCompressed;
-}
 bool ZincConnection::getIsCompressed() const {
     return m_isCompressed;
 }
@@ -58,10 +54,9 @@ void ZincConnection::setIsEncrypted(const bool& isEncrypted) {
 }
 void ZincConnection::setupCompression() {
     if (m_state != State::Login) return;
-    ZincPacket packet;
-    packet.setId(3);
-    packet.getData().writeVarNumeric<int>(g_zincConfig.m_core.m_network.m_threshold);
-    send(packet);
+    SetCompressionPacket packet;
+    packet.m_threshold = g_zincConfig.m_core.m_network.m_threshold;
+    send(encodePacket(packet));
     setIsCompressed(true);
 }
 void ZincConnection::setupEncryption(const std::vector<unsigned char>& secret) {
@@ -69,93 +64,205 @@ void ZincConnection::setupEncryption(const std::vector<unsigned char>& secret) {
     m_encrypt.setIV(secret);
     m_decrypt.setKey(secret);
     m_decrypt.setIV(secret);
+    if (!m_encrypt.initCFB8(1) || !m_decrypt.initCFB8(0)) return;
+    flush(); // frames queued so far must leave unencrypted
     m_isEncrypted = true;
 }
 ZincPacket ZincConnection::read() {
-    m_mutex.lock();
-    ByteBuffer tmpBuffer = m_tcpConnection.read(), buffer;
-    m_mutex.unlock();
+    evbuffer* input = m_tcpConnection.getStream()->getInput();
     if (m_isEncrypted) {
-        buffer.writeArray<unsigned char>(
-            m_decrypt.decryptCFB8(tmpBuffer.readArray<unsigned char>(&ByteBuffer::readUnsignedByte, tmpBuffer.size())),
-            &ByteBuffer::writeUnsignedByte
-        );
-    } else {
-        buffer.m_internalBuffer.write(tmpBuffer.getBytes().data(), tmpBuffer.size());
+        // every byte is decrypted exactly once, in place, then its chains move to the plaintext buffer
+        size_t length = evbuffer_get_length(input);
+        if (length) {
+            int chunkCount = evbuffer_peek(input, -1, nullptr, nullptr, 0);
+            std::vector<evbuffer_iovec> chunks (zinc_safe_cast<int, size_t>(chunkCount));
+            evbuffer_peek(input, -1, nullptr, chunks.data(), chunkCount);
+            for (const evbuffer_iovec& chunk : chunks) m_decrypt.update((uint8_t*) chunk.iov_base, chunk.iov_len);
+            evbuffer_add_buffer(m_decryptedInput, input);
+        }
+        input = m_decryptedInput;
     }
-    tmpBuffer.clear();
-    size_t length = zinc_safe_cast<int, size_t>(buffer.readVarNumeric<int>());
-    int packetId = -1;
-    ByteBuffer dataBuffer;
-    if (length > buffer.size()) {
-        return ZincPacket(-1); // wait for more data
-    } else TCPUtil::drain(m_tcpConnection.getBuffer(), 
-        buffer.getVarNumericLength<int>(zinc_safe_cast<size_t, int>(length)) + length);
-    m_shouldContinue = false;
+    int frameStatus = TCPUtil::readFrame(input, m_frame);
+    if (frameStatus < 0) return ZincPacket(-2); // malformed length prefix
+    if (!frameStatus) return ZincPacket(-1); // wait for more data
+    size_t frameLength = evbuffer_get_length(m_frame);
+    const unsigned char* frame = evbuffer_pullup(m_frame, -1);
+    int packetId = -1, varIntLength = 0;
+    ZincPacket packet;
     if (m_isCompressed) {
-        size_t dataLength = zinc_safe_cast<int, size_t>(buffer.readVarNumeric<int>());
+        int dataLength = 0;
+        varIntLength = TCPUtil::peekVarInt(frame, frameLength, dataLength);
+        if (varIntLength <= 0 || dataLength < 0 || dataLength > MAX_DECOMPRESSED_LENGTH) {
+            evbuffer_drain(m_frame, frameLength);
+            return ZincPacket(-2);
+        }
         if (dataLength) {
-            tmpBuffer.writeBytes(buffer.readBytes(length 
-                - buffer.getVarNumericLength<int>(zinc_safe_cast<size_t, int>(dataLength))));
-            ByteBuffer buffer = ZLibUtil::uncompress(tmpBuffer.getBytes(), dataLength);
-            tmpBuffer.clear();
-            packetId = buffer.readVarNumeric<int>();
-            dataBuffer.writeBytes(buffer.readBytes(dataLength - buffer.getVarNumericLength<int>(packetId)));
-        } else {
-            packetId = buffer.readVarNumeric<int>();
-            dataBuffer.writeBytes(buffer.readBytes(length - (buffer.getVarNumericLength<int>(packetId) + 1))); // 1 = size of varint(0)
+            int offloadThreshold = g_zincConfig.m_core.m_optimizations.m_offloadInflateThreshold;
+            if (offloadThreshold > 0 && dataLength >= offloadThreshold) {
+                packet.setId(INFLATE_PENDING);
+                packet.getData().m_internalBuffer.write((const char*) frame, frameLength);
+            } else packet = inflate((const char*) frame, frameLength);
+            evbuffer_drain(m_frame, evbuffer_get_length(m_frame));
+            return packet;
         }
-    } else {
-        packetId = buffer.readVarNumeric<int>();
-        dataBuffer.writeBytes(buffer.readBytes(length - buffer.getVarNumericLength<int>(packetId)));
+        frame += varIntLength;
+        frameLength -= zinc_safe_cast<int, size_t>(varIntLength);
+    }
+    varIntLength = TCPUtil::peekVarInt(frame, frameLength, packetId);
+    if (varIntLength <= 0) {
+        evbuffer_drain(m_frame, evbuffer_get_length(m_frame));
+        return ZincPacket(-2);
+    }
+    packet.setId(packetId);
+    packet.getData().m_internalBuffer.write((const char*) frame + varIntLength, frameLength - zinc_safe_cast<int, size_t>(varIntLength));
+    evbuffer_drain(m_frame, evbuffer_get_length(m_frame));
+    return packet;
+}
+ZincPacket ZincConnection::inflate(const char* frame, const size_t& length) {
+    int dataLength = 0, packetId = -1;
+    int varIntLength = TCPUtil::peekVarInt((const unsigned char*) frame, length, dataLength);
+    if (varIntLength <= 0 || dataLength <= 0 || dataLength > MAX_DECOMPRESSED_LENGTH) return ZincPacket(-2);
+    std::vector<char> uncompressed (zinc_safe_cast<int, size_t>(dataLength));
+    if (!ZLibContext::getThreadLocal().uncompress((const uint8_t*) frame + varIntLength, length - zinc_safe_cast<int, size_t>(varIntLength),
+                                                  (uint8_t*) uncompressed.data(), uncompressed.size())) return ZincPacket(-2);
+    varIntLength = TCPUtil::peekVarInt((const unsigned char*) uncompressed.data(), uncompressed.size(), packetId);
+    if (varIntLength <= 0) return ZincPacket(-2);
+    ZincPacket packet (packetId);
+    packet.getData().m_internalBuffer.write(uncompressed.data() + varIntLength, uncompressed.size() - zinc_safe_cast<int, size_t>(varIntLength));
+    return packet;
+}
+bool ZincConnection::hasPendingWork() const {
+    return m_pendingAuth || m_offloadCompleted != m_offloadSequence;
+}
+bool ZincConnection::hasBufferedInput() {
+    if (!m_tcpConnection.getStream()) return false;
+    return evbuffer_get_length(m_tcpConnection.getStream()->getInput()) || evbuffer_get_length(m_decryptedInput);
+}
+bool ZincConnection::writeFrame(evbuffer* output, const ZincPacket& packet, const bool& isCompressed) {
+    // the packet id goes in front of the data, which is handed over as is instead of being joined with it first
+    unsigned char id[ByteBuffer::varNumericMaxSize<int>()];
+    size_t idLength = TCPUtil::writeVarInt(id, packet.getId());
+    const size_t length = packet.getData().size(), dataLength = idLength + length;
+    unsigned char header[3 * ByteBuffer::varNumericMaxSize<int>()]; // frame length, data length and packet id at most
+    size_t headerLength = 0;
+    if (isCompressed && dataLength >= zinc_safe_cast<int, size_t>(g_zincConfig.m_core.m_network.m_threshold)) {
+        // deflate straight into the output buffer, leaving room for the largest possible header
+        ZLibContext& zlib = ZLibContext::getThreadLocal();
+        zlib.setLevel(g_zincConfig.m_core.m_network.m_compressionLevel);
+        size_t bound = ZLibContext::compressBound(dataLength);
+        evbuffer_iovec chunk;
+        if (evbuffer_reserve_space(output, zinc_safe_cast<size_t, ev_ssize_t>(sizeof(header) + bound), &chunk, 1) != 1) return false;
+        unsigned char* out = (unsigned char*) chunk.iov_base;
+        size_t compressedLength = zlib.compress(id, idLength, (const uint8_t*) packet.getData().data(), length, out + sizeof(header), bound);
+        if (!compressedLength) return false;
+        int innerLength = zinc_safe_cast<size_t, int>(dataLength);
+        headerLength = TCPUtil::writeVarInt(header, zinc_safe_cast<size_t, int>(ByteBuffer::getVarNumericLength<int>(innerLength) + compressedLength));
+        headerLength += TCPUtil::writeVarInt(header + headerLength, innerLength);
+        std::memmove(out + headerLength, out + sizeof(header), compressedLength);
+        std::memcpy(out, header, headerLength);
+        chunk.iov_len = headerLength + compressedLength;
+        evbuffer_commit_space(output, &chunk, 1);
+        return true;
     }
-    buffer.clear();
-    return ZincPacket(packetId, dataBuffer);
+    if (isCompressed) {
+        headerLength = TCPUtil::writeVarInt(header, zinc_safe_cast<size_t, int>(dataLength + 1)); // 1 = size of varint(0)
+        header[headerLength++] = 0;
+    } else headerLength = TCPUtil::writeVarInt(header, zinc_safe_cast<size_t, int>(dataLength));
+    std::memcpy(header + headerLength, id, idLength);
+    return !evbuffer_add(output, header, headerLength + idLength) && !evbuffer_add(output, packet.getData().data(), length);
 }
 void ZincConnection::send(const ZincPacket& packet) {
-    ByteBuffer tmpData, data;
-    int dataLength = zinc_safe_cast<size_t, int>(tmpData.getVarNumericLength<int>(packet.getId()) + packet.getData().size());
-    if (m_isCompressed) {
-        if (dataLength < g_zincConfig.m_core.m_network.m_threshold) {
-            tmpData.writeVarNumeric<int>(1 + dataLength); // size of varint(0) + dataLength
-            tmpData.writeVarNumeric<int>(0);
-            tmpData.writeVarNumeric<int>(packet.getId());
-            tmpData.writeBytes(packet.getData().getBytes());
-        } else {
-            tmpData.writeVarNumeric<int>(packet.getId());
-            tmpData.writeBytes(packet.getData().getBytes());
-            ByteBuffer compressedData = ZLibUtil::compress(tmpData.getBytes());
-            tmpData.clear();
-            tmpData.writeVarNumeric<int>(zinc_safe_cast<size_t, int>(tmpData.getVarNumericLength<int>(dataLength) 
-                + compressedData.size()));
-            tmpData.writeVarNumeric<int>(dataLength);
-            tmpData.writeByteArray(compressedData.getBytes());
-            compressedData.clear();
+    std::lock_guard lock(m_mutex);
+    if (!checkHardCap(packet.getData().size())) return;
+    if (!writeFrame(m_outbound, packet, m_isCompressed)) return;
+    scheduleFlush();
+    Logger("ZincConnection").debug("Sent packet with id " + std::to_string(packet.getId()));
+}
+void ZincConnection::send(const SharedPacket& packet) {
+    std::lock_guard lock(m_mutex);
+    // copied, the outbound buffer is encrypted in place on flush
+    const std::vector<char>* frame = packet.getFrame(m_isCompressed);
+    if (!frame || !checkHardCap(frame->size())) return;
+    evbuffer_add(m_outbound, frame->data(), frame->size());
+    scheduleFlush();
+}
+void ZincConnection::sendFrames(const char* frames, const size_t& length) {
+    std::lock_guard lock(m_mutex);
+    if (!checkHardCap(length)) return;
+    evbuffer_add(m_outbound, frames, length);
+    scheduleFlush();
+}
+bool ZincConnection::checkHardCap(const size_t& length) {
+    if (m_isOverCap) return false;
+    if (evbuffer_get_length(m_outbound) + m_outputLength + length <= zinc_safe_cast<int, size_t>(g_zincConfig.m_core.m_network.m_outboundHardCap))
+        return true;
+    // nothing more is buffered for a client that stopped reading, the next flush drops it
+    m_isOverCap = true;
+    scheduleFlush();
+    return false;
+}
+void ZincConnection::setCongested(const bool& isCongested) {
+    if (m_isCongested == isCongested) return;
+    m_isCongested = isCongested;
+    for (const auto& listener : g_zincCongestionListeners) listener(this, isCongested);
+}
+void ZincConnection::scheduleFlush() {
+    if (m_isFlushScheduled) return;
+    m_isFlushScheduled = true;
+    // runs after the callbacks already active in this loop iteration, so a burst of sends leaves in one write
+    ConnectionHandle handle = m_handle;
+    g_zincServer.post(m_reactorId, [handle]() {
+        ZincConnection* connection = g_zincServer.getClient(handle);
+        if (connection) connection->flush();
+    });
+}
+void ZincConnection::flush() {
+    m_mutex.lock();
+    m_isFlushScheduled = false;
+    if (!m_tcpConnection.getStream()) {
+        m_mutex.unlock();
+        return;
+    }
+    evbuffer* output = m_tcpConnection.getStream()->getOutput();
+    if (evbuffer_get_length(m_outbound) && !m_isOverCap) {
+        if (m_isEncrypted) {
+            int chunkCount = evbuffer_peek(m_outbound, -1, nullptr, nullptr, 0);
+            std::vector<evbuffer_iovec> chunks (zinc_safe_cast<int, size_t>(chunkCount));
+            evbuffer_peek(m_outbound, -1, nullptr, chunks.data(), chunkCount);
+            for (const evbuffer_iovec& chunk : chunks) m_encrypt.update((uint8_t*) chunk.iov_base, chunk.iov_len);
         }
-    } else {
-        tmpData.writeVarNumeric<int>(dataLength);
-        tmpData.writeVarNumeric<int>(packet.getId());
-        tmpData.writeBytes(packet.getData().getBytes());
+        evbuffer_add_buffer(output, m_outbound);
     }
-    if (m_isEncrypted) {
-        data.writeArray<unsigned char>(
-            m_encrypt.encryptCFB8(tmpData.readArray<unsigned char>(&ByteBuffer::readUnsignedByte, tmpData.size())),
-            &ByteBuffer::writeUnsignedByte
-        );
-    } else data.writeBytes(tmpData.getBytes());
-    tmpData.clear();
-    m_mutex.lock();
-    m_tcpConnection.send(data);
+    m_outputLength = m_tcpConnection.getStream()->getOutputLength();
+    bool isOverCap = m_isOverCap;
     m_mutex.unlock();
-    Logger("ZincConnection").debug("Sent packet with id " + std::to_string(packet.getId()));
+    if (isOverCap) {
+        Logger("ZincConnection").info("Client [" + m_tcpConnection.getIP() + "] exceeded the outbound buffer cap");
+        ConnectionHandle handle = m_handle;
+        g_zincServer.post(m_reactorId, [handle]() { g_zincServer.removeClient(handle); });
+        return;
+    }
+    if (m_outputLength >= zinc_safe_cast<int, size_t>(g_zincConfig.m_core.m_network.m_outboundHighWatermark)) setCongested(true);
+}
+void ZincConnection::onOutputDrained() {
+    if (!m_tcpConnection.getStream()) return;
+    m_outputLength = m_tcpConnection.getStream()->getOutputLength();
+    if (m_outputLength <= zinc_safe_cast<int, size_t>(g_zincConfig.m_core.m_network.m_outboundLowWatermark)) setCongested(false);
+}
+bool ZincConnection::isCongested() const {
+    return m_isCongested;
+}
+size_t ZincConnection::getQueuedBytes() {
+    std::lock_guard lock(m_mutex);
+    return evbuffer_get_length(m_outbound) + m_outputLength;
 }
 ByteBuffer ZincConnection::extractCookieData(ByteBuffer& cookieRawData) {
     ByteBuffer cookieData;
     ByteBuffer errorBuffer;
         errorBuffer.writeByte(false);
-    std::string stringPayload = cookieRawData.readString();
+    std::string_view stringPayload = cookieRawData.readStringView();
     try {
-        nlohmann::json JSON = nlohmann::json::parse(stringPayload);
+        nlohmann::json JSON = nlohmann::json::parse(stringPayload.begin(), stringPayload.end());
         if (JSON.contains("signature") && JSON.contains("lifetime") && JSON.contains("nonce") && JSON.contains("data")) {
             if (JSON["lifetime"] < time(nullptr)) return errorBuffer;
             ByteBuffer totalDataToVerify;
@@ -177,16 +284,24 @@ ByteBuffer ZincConnection::extractCookieData(ByteBuffer& cookieRawData) {
         return errorBuffer;
     }
 }
+void ZincConnection::sendKeepAlive(const long& id) {
+    KeepAlivePacket packet;
+    packet.m_id = id;
+    switch (m_state) {
+    case State::Config: send(encodePacket(4, packet)); break;
+    case State::Play: send(encodePacket(0x26, packet)); break;
+    default: return;
+    }
+}
 void ZincConnection::sendCookieRequest(const Identifier& cookieId) {
-    ZincPacket packet;
+    CookieRequestPacket packet;
+    packet.m_key = cookieId;
     switch (m_state) {
-    case State::Login: packet.setId(5); break;
-    case State::Config: packet.setId(0); break;
-    case State::Play: packet.setId(0x15); break;
+    case State::Login: send(encodePacket(5, packet)); break;
+    case State::Config: send(encodePacket(0, packet)); break;
+    case State::Play: send(encodePacket(0x15, packet)); break;
     default: return;
     }
-    packet.getData().writeIdentifier(cookieId);
-    send(packet);
 }
 void ZincConnection::storeCookie(const Identifier& cookieId, const std::vector<char>& payload, long lifetime) {
     ZincPacket packet;
@@ -195,7 +310,12 @@ void ZincConnection::storeCookie(const Identifier& cookieId, const std::vector<c
     case State::Play: packet.setId(0x71); break;
     default: return;
     }
-    packet.getData().writeIdentifier(cookieId);
+    // signed inline, so the cookie goes out before anything the caller sends next
+    writeCookie(packet.getData(), cookieId, payload, lifetime);
+    send(packet);
+}
+void ZincConnection::writeCookie(ByteBuffer& buffer, const Identifier& cookieId, const std::vector<char>& payload, const long& lifetime) {
+    buffer.writeIdentifier(cookieId);
     std::string nonce = Base64::encode(RandomUtil::randomBytes(32));
     std::string payloadString = Base64::encode(g_zincServer.m_cookieRSA.encrypt(std::vector<uint8_t>(payload.begin(), payload.end())));
     long lifetimeResult = time(nullptr) + lifetime;
@@ -210,27 +330,28 @@ void ZincConnection::storeCookie(const Identifier& cookieId, const std::vector<c
             &ByteBuffer::readUnsignedByte, dataToSign.size()))) },
         { "nonce", nonce }
     };
-    packet.getData().writeString(JSON.dump());
-    send(packet);
+    buffer.writeString(JSON.dump());
 }
 void ZincConnection::storeCookie(const Identifier& cookieId, const ByteBuffer& payload, long lifetime) {
     storeCookie(cookieId, payload.getBytes(), lifetime);
 }
 void ZincConnection::sendPluginMessage(const Identifier& pluginChannel, const std::vector<char>& data) {
-    ZincPacket packet;
+    PluginMessagePacket message;
+    message.m_channel = pluginChannel;
+    message.m_data = data;
     switch (m_state) {
     case State::Login: {
-        packet.setId(4);
+        // the login plugin request carries the message id in front of the channel
+        ZincPacket packet (4);
         packet.getData().writeVarNumeric<int>(openLoginPluginChannel(pluginChannel.toString()));
+        encodePacket(message, packet.getData());
+        send(packet);
         break;
     }
-    case State::Config: packet.setId(1); break;
-    case State::Play: packet.setId(0x18); break;
+    case State::Config: send(encodePacket(1, message)); break;
+    case State::Play: send(encodePacket(0x18, message)); break;
     default: return;
     }
-    packet.getData().writeIdentifier(pluginChannel);
-    packet.getData().writeByteArray(data);
-    send(packet);
 }
 void ZincConnection::sendPluginMessage(const Identifier& pluginChannel, const ByteBuffer& data) {
     sendPluginMessage(pluginChannel, data.getBytes());
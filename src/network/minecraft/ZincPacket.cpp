@@ -11,21 +11,21 @@ int ZincPacket::getId() const {
 ByteBuffer& ZincPacket::getData() {
     return m_data;
 }
-ByteBuffer ZincPacket::getData() const {
-    ByteBuffer data;
-    data.m_isBigEndian = m_data.m_isBigEndian;
-    data.m_internalBuffer.write(m_data.getBytes().data(), m_data.size());
-    data.m_internalBuffer.toggleBlockRecycle(m_data.m_internalBuffer.areBlocksRecycled());
-    return data;
+const ByteBuffer& ZincPacket::getData() const {
+    return m_data;
 }
 void ZincPacket::setId(const int& id) {
     m_id = id;
 }
 void ZincPacket::setData(const ByteBuffer& data) {
     m_data.m_isBigEndian = data.m_isBigEndian;
-    m_data.m_internalBuffer.write(data.getBytes().data(), data.size());
+    m_data.m_internalBuffer.clear();
+    m_data.m_internalBuffer.write(data.data(), data.size());
     m_data.m_internalBuffer.toggleBlockRecycle(data.m_internalBuffer.areBlocksRecycled());
 }
+void ZincPacket::setData(ByteBuffer&& data) {
+    m_data = std::move(data);
+}
 bool ZincPacket::operator==(const ZincPacket& packet) const {
     return m_data == packet.getData() && m_id == packet.getId();
 }
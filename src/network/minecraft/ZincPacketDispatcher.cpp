@@ -0,0 +1,63 @@
+#include <network/minecraft/ZincPacketDispatcher.h>
+#include <util/Logger.h>
+#include <ZincConfig.h>
+#include <chrono>
+
+namespace zinc {
+
+Logger m_zincPacketDispatcherLogger = Logger("ZincPacketDispatcher");
+
+bool ZincPacketDispatcher::registerHandler(const ZincConnection::State& state, const int& id, const ZincPacketHandler& handler) {
+    if ((size_t) state >= STATE_COUNT || id < 0 || id >= MAX_PACKET_ID) {
+        m_zincPacketDispatcherLogger.error("Attempted to register handler for invalid packet id " + std::to_string(id));
+        return false;
+    }
+    m_entries[(size_t) state][(size_t) id].m_handler = handler;
+    return true;
+}
+bool ZincPacketDispatcher::hasHandler(const ZincConnection::State& state, const int& id) const {
+    if ((size_t) state >= STATE_COUNT || id < 0 || id >= MAX_PACKET_ID) return false;
+    return (bool) m_entries[(size_t) state][(size_t) id].m_handler;
+}
+bool ZincPacketDispatcher::dispatch(ZincConnection* connection, ZincPacket& packet) {
+    size_t state = (size_t) connection->getState();
+    if (state >= STATE_COUNT || packet.getId() < 0 || packet.getId() >= MAX_PACKET_ID || !m_entries[state][(size_t) packet.getId()].m_handler) {
+        m_unhandled.fetch_add(1, std::memory_order_relaxed);
+        m_zincPacketDispatcherLogger.debug("No handler for packet " + std::to_string(packet.getId()) + " in state " + std::to_string(state));
+        return true;
+    }
+    Entry& entry = m_entries[state][(size_t) packet.getId()];
+    if (!g_zincConfig.m_core.m_optimizations.m_packetMetrics) return entry.m_handler(connection, packet);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool result = entry.m_handler(connection, packet);
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    entry.m_calls.fetch_add(1, std::memory_order_relaxed);
+    entry.m_nanoseconds.fetch_add(zinc_safe_cast<int64_t, uint64_t>(elapsed), std::memory_order_relaxed);
+    return result;
+}
+std::vector<ZincPacketStats> ZincPacketDispatcher::getStats() const {
+    std::vector<ZincPacketStats> stats;
+    for (size_t state = 0; state < STATE_COUNT; state++) {
+        for (size_t id = 0; id < (size_t) MAX_PACKET_ID; id++) {
+            const Entry& entry = m_entries[state][id];
+            uint64_t calls = entry.m_calls.load(std::memory_order_relaxed);
+            if (!calls) continue;
+            stats.push_back({ (ZincConnection::State) state, (int) id, calls, entry.m_nanoseconds.load(std::memory_order_relaxed) });
+        }
+    }
+    return stats;
+}
+uint64_t ZincPacketDispatcher::getUnhandledCount() const {
+    return m_unhandled.load(std::memory_order_relaxed);
+}
+void ZincPacketDispatcher::resetStats() {
+    for (auto& handlers : m_entries) {
+        for (Entry& entry : handlers) {
+            entry.m_calls = 0;
+            entry.m_nanoseconds = 0;
+        }
+    }
+    m_unhandled = 0;
+}
+
+}
@@ -1,13 +1,16 @@
 #include <network/minecraft/ZincServer.h>
+#include <network/ProxyProtocol.h>
+#include <network/minecraft/ZincAuthService.h>
+#include <network/minecraft/ZincStatusCache.h>
+#include <network/minecraft/ZincPackets.h>
 #include <network/minecraft/channels/BrandChannel.h>
 #include <registry/DefaultRegistries.h>
+#include <registry/RegistryPacketCache.h>
 #include <external/JSON.h>
 #include <util/Logger.h>
 #include <util/crypto/Random.h>
 #include <util/crypto/MCSHA1.h>
 #include <curlpp/cURLpp.hpp>
-#include <curlpp/Easy.hpp>
-#include <curlpp/Options.hpp>
 #include <ZincConstants.h>
 #include <ZincConfig.h>
 
@@ -19,14 +22,47 @@ ZincServer g_zincServer;
 
 void ZincServer::start() {
     m_rsa.generateKeys(1024);
+    m_trustedProxies.clear();
+    for (const std::string& proxy : g_zincConfig.m_core.m_security.m_trustedProxies) {
+        sockaddr_storage addr {};
+        if (inet_pton(AF_INET, proxy.c_str(), &((sockaddr_in*) &addr)->sin_addr) == 1) addr.ss_family = AF_INET;
+        else if (inet_pton(AF_INET6, proxy.c_str(), &((sockaddr_in6*) &addr)->sin6_addr) == 1) addr.ss_family = AF_INET6;
+        else {
+            m_zincLogger.error("Invalid trusted proxy address " + proxy);
+            continue;
+        }
+        m_trustedProxies.push_back(ZincAddressKey((const struct sockaddr*) &addr));
+    }
     m_zincLogger.info("Zinc listening on port " + std::to_string(m_port));
     m_started = true;
     cURLpp::initialize();
+    g_zincAuthService.start(zinc_safe_cast<int, size_t>(std::max(g_zincConfig.m_core.m_network.m_authThreads, 1)));
+    m_workers.start(zinc_safe_cast<int, size_t>(std::max(g_zincConfig.m_core.m_network.m_workerThreads, 0)));
+    std::vector<TCPBindEndpoint> endpoints;
+    for (const ZincConfig::CoreConfig::Network::BindAddress& bindAddress : g_zincConfig.m_core.m_network.m_bindAddresses) {
+        TCPBindEndpoint endpoint;
+        endpoint.m_address = bindAddress.m_address;
+        endpoint.m_port = zinc_safe_cast<int, unsigned short>(bindAddress.m_port);
+        endpoint.m_interface = bindAddress.m_interface;
+        endpoint.m_backlog = bindAddress.m_backlog;
+        endpoint.m_noDelay = bindAddress.m_noDelay;
+        endpoint.m_ipv6Only = bindAddress.m_ipv6Only;
+        endpoint.m_deferAccept = bindAddress.m_deferAccept;
+        endpoint.m_receiveBuffer = bindAddress.m_receiveBuffer;
+        endpoint.m_sendBuffer = bindAddress.m_sendBuffer;
+        endpoint.m_fastOpenQueue = bindAddress.m_fastOpenQueue;
+        endpoints.push_back(endpoint);
+    }
+    m_server.setEndpoints(endpoints);
+    if (g_zincConfig.m_core.m_network.m_transport == "io_uring") m_server.setTransport(TCPTransport::IOUring);
+    else if (g_zincConfig.m_core.m_network.m_transport != "libevent") m_zincLogger.warning("Unknown transport " + g_zincConfig.m_core.m_network.m_transport + ", using libevent");
     m_server.start();
 }
 void ZincServer::stop() {
     if (!m_started) return;
     m_zincLogger.info("Zinc stopped");
+    g_zincAuthService.stop();
+    m_workers.stop();
     cURLpp::terminate();
     m_server.stop();
 }
@@ -34,356 +70,589 @@ void ZincServer::setPort(const int& port) {
     m_port = port;
     m_server.setPort(zinc_safe_cast<int, unsigned short>(port));
 }
+void ZincServer::setReactorCount(const size_t& reactorCount) {
+    if (m_started) return;
+    m_server.setReactorCount(reactorCount);
+}
+void ZincServer::post(const size_t& reactorId, const std::function<void()>& task) {
+    m_server.post(reactorId, task);
+}
+TimerWheel::TimerId ZincServer::schedule(const size_t& reactorId, const uint64_t& delayMilliseconds, const std::function<void()>& callback) {
+    return m_server.schedule(reactorId, delayMilliseconds, callback);
+}
+bool ZincServer::cancel(const size_t& reactorId, TimerWheel::TimerId& id) {
+    return m_server.cancel(reactorId, id);
+}
+void ZincServer::offload(ZincConnection* connection, const OffloadStage& stage, const std::function<void()>& work,
+                         const std::function<void(ZincConnection*)>& completion) {
+    uint64_t sequence = connection->m_offloadSequence++;
+    size_t reactorId = connection->m_reactorId;
+    ConnectionHandle handle = connection->m_handle;
+    m_workers.submit((size_t) stage, [work, completion, sequence, reactorId, handle]() {
+        work();
+        g_zincServer.post(reactorId, [completion, sequence, handle]() {
+            ZincConnection* connection = g_zincServer.getClient(handle);
+            if (!connection) return;
+            connection->m_offloadCompletions.emplace(sequence, completion);
+            // a job that finished early waits until every job submitted before it completed
+            while (!connection->m_offloadCompletions.empty() && connection->m_offloadCompletions.begin()->first == connection->m_offloadCompleted) {
+                std::function<void(ZincConnection*)> next = std::move(connection->m_offloadCompletions.begin()->second);
+                connection->m_offloadCompletions.erase(connection->m_offloadCompletions.begin());
+                connection->m_offloadCompleted++;
+                next(connection);
+                if (!g_zincServer.isConnected(handle)) return;
+            }
+            resumeRead(connection);
+        });
+    });
+}
+WorkerStageStats ZincServer::getOffloadStats(const OffloadStage& stage) const {
+    return m_workers.getStats((size_t) stage);
+}
+void ZincServer::setTimeout(ZincConnection* connection, const int& seconds, const std::string& reason) {
+    ConnectionHandle handle = connection->m_handle;
+    g_zincServer.cancel(connection->m_reactorId, connection->m_timeout);
+    connection->m_timeout = g_zincServer.schedule(connection->m_reactorId, zinc_safe_cast<int, uint64_t>(seconds) * 1000, [handle, reason]() {
+        ZincConnection* connection = g_zincServer.getClient(handle);
+        if (!connection) return;
+        connection->m_timeout = TimerWheel::TimerId();
+        m_zincLogger.info("Client [" + connection->getTCPConnection().getIP() + "] " + reason);
+        g_zincServer.removeClient(handle);
+    });
+}
+static long getKeepAliveTime() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+void ZincServer::scheduleKeepAlive(ZincConnection* connection, const uint64_t& delayMilliseconds) {
+    ConnectionHandle handle = connection->m_handle;
+    g_zincServer.cancel(connection->m_reactorId, connection->m_keepAliveTimer);
+    connection->m_keepAliveTimer = g_zincServer.schedule(connection->m_reactorId, delayMilliseconds, [handle]() {
+        ZincConnection* connection = g_zincServer.getClient(handle);
+        if (!connection) return;
+        connection->m_keepAliveTimer = TimerWheel::TimerId();
+        long timeout = g_zincConfig.m_core.m_network.m_keepAliveTimeout * 1000L;
+        if (connection->m_info.m_networkInfo.m_lastKeepAlive != -1) {
+            // the keep alive id is the time it was sent
+            long waited = getKeepAliveTime() - connection->m_info.m_networkInfo.m_lastKeepAlive;
+            if (waited >= timeout) {
+                m_zincLogger.info("Client [" + connection->getTCPConnection().getIP() + "] timed out!");
+                g_zincServer.removeClient(handle);
+            } else scheduleKeepAlive(connection, zinc_safe_cast<long, uint64_t>(timeout - waited));
+            return;
+        }
+        sendKeepAlive(connection);
+        scheduleKeepAlive(connection, zinc_safe_cast<int, uint64_t>(g_zincConfig.m_core.m_network.m_keepAliveInterval) * 1000);
+    });
+}
+void ZincServer::sendKeepAlive(ZincConnection* connection) {
+    if (connection->m_info.m_networkInfo.m_lastKeepAlive != -1) return; // the previous one is still unanswered
+    connection->m_info.m_networkInfo.m_lastKeepAlive = getKeepAliveTime();
+    connection->sendKeepAlive(connection->m_info.m_networkInfo.m_lastKeepAlive);
+}
+void ZincServer::handleKeepAlive(ZincConnection* connection, const int64_t& keepAlive) {
+    if (connection->m_info.m_networkInfo.m_lastKeepAlive != keepAlive) connection->sendLoginError("Server received invalid keep alive packet");
+    else connection->m_info.m_networkInfo.m_lastKeepAlive = -1;
+}
+void ZincServer::completeLogin(ZincConnection* connection) {
+    if (g_zincCookieRequests.contains(ZincConnection::State::Login)) 
+        for (const std::string& cookieRequest : g_zincCookieRequests[ZincConnection::State::Login]) 
+            connection->sendCookieRequest(cookieRequest);
+    if (g_zincServerInitPluginChannels.contains(ZincConnection::State::Login)) 
+        for (const auto& pluginRequest : g_zincServerInitPluginChannels[ZincConnection::State::Login]) 
+            connection->sendPluginMessage(Identifier(pluginRequest.first), pluginRequest.second(connection));
+    LoginSuccessPacket loginSuccess;
+    loginSuccess.m_playerUUID = connection->m_info.m_playerInfo.m_playerUUID;
+    loginSuccess.m_playerName = connection->m_info.m_playerInfo.m_playerName;
+    loginSuccess.m_properties = connection->m_info.m_playerInfo.m_properties;
+    connection->send(encodePacket(loginSuccess));
+}
 RSAWrapper& ZincServer::getRSA() {
     return m_rsa;
 }
 RSAWrapper ZincServer::getRSA() const {
     return m_rsa;
 }
-void ZincServer::addClient(ZincConnection* client) {
-    if (!isConnected(client->getTCPConnection().getFd())) {
-        std::lock_guard lock(m_mutex);
-        std::string ip = client->getTCPConnection().getIP();
-        if (m_rateLimiterData.contains(ip)) {
-            if (m_rateLimiterData[ip] + g_zincConfig.m_core.m_security.m_rateLimit < time(nullptr)) m_rateLimiterData[ip] = time(nullptr);
-            else client->m_kickAtLogin = 1;
-        } else m_rateLimiterData.insert({ ip, time(nullptr) });
-        if (m_concurrentAccounts.contains(ip)) m_concurrentAccounts[ip]++;
-        else m_concurrentAccounts.insert({ ip, 1 });
-        if (m_concurrentAccounts[ip] > g_zincConfig.m_core.m_security.m_maxConcurrentAccount) client->m_kickAtLogin = 2;
-        m_clients.insert({ client->getTCPConnection().getFd(), client });
-    }
+ZincPacketDispatcher& ZincServer::getPacketDispatcher() {
+    return m_dispatcher;
 }
-bool ZincServer::isConnected(evutil_socket_t fd) const {
-    return m_clients.contains(fd);
-}
-void ZincServer::removeClient(evutil_socket_t fd) {
-    if (isConnected(fd)) {
-        std::lock_guard lock(m_mutex);
-        std::string ip = m_clients[fd]->getTCPConnection().getIP();
-        if (m_concurrentAccounts[ip]) m_concurrentAccounts[ip]--;
-        if (!m_concurrentAccounts[ip]) m_concurrentAccounts.erase(ip);
-        if (m_clients[fd]->m_loginFinished) m_onlinePlayers--;
-        m_clients[fd]->getTCPConnection().close();
-        delete m_clients[fd];
-        m_clients.erase(fd);
-    }
+ConnectionHandle ZincServer::addClient(ZincConnection* client) {
+    client->m_handle = m_clients.insert(client);
+    return client->m_handle;
+}
+bool ZincServer::isConnected(const ConnectionHandle& handle) const {
+    return m_clients.get(handle) != nullptr;
+}
+ZincConnection* ZincServer::getClient(const ConnectionHandle& handle) const {
+    return m_clients.get(handle);
+}
+size_t ZincServer::getClientCount() const {
+    return m_clients.size();
+}
+void ZincServer::removeClient(const ConnectionHandle& handle) {
+    ZincConnection* client = m_clients.erase(handle);
+    if (!client) return;
+    g_zincAdmissionController.release(client->m_addressKey);
+    cancel(client->m_reactorId, client->m_timeout);
+    cancel(client->m_reactorId, client->m_keepAliveTimer);
+    if (client->m_loginFinished) m_onlinePlayers--;
+    client->getTCPConnection().close();
+    g_epochReclaimer.retire([client]() { delete client; });
+}
+void ZincServer::broadcast(const SharedPacket& packet, const std::function<bool(ZincConnection*)>& filter) {
+    EpochReclaimer::Guard guard = g_epochReclaimer.pin();
+    m_clients.forEach([&packet, &filter](const ConnectionHandle&, ZincConnection* connection) {
+        if (connection->getState() != ZincConnection::State::Play) return;
+        if (filter && !filter(connection)) return;
+        connection->send(packet);
+    });
 }
-ZincConnection* ZincServer::getClient(evutil_socket_t fd) {
-    if (!isConnected(fd)) m_zincLogger.error("Attempted to get unknown client", true); 
-    return m_clients[fd];
+bool ZincServer::expectsProxyHeader(const ZincAddressKey& peer) const {
+    if (!g_zincConfig.m_core.m_security.m_proxyProtocol) return false;
+    return m_trustedProxies.empty() || std::find(m_trustedProxies.begin(), m_trustedProxies.end(), peer) != m_trustedProxies.end();
 }
-void ZincServer::onAccept(evconnlistener*, evutil_socket_t fd, struct sockaddr* addr, int, void* ptr) {
-    bufferevent* bev = bufferevent_socket_new((event_base*) ptr, fd, BEV_OPT_CLOSE_ON_FREE);
-    if (!bev) {
-        m_zincLogger.error("Failed to create bufferevent");
+void ZincServer::onAccept(evconnlistener*, evutil_socket_t fd, struct sockaddr* addr, int socklen, void* ptr) {
+    TCPReactor* reactor = (TCPReactor*) ptr;
+    ZincAddressKey addressKey (addr);
+    // behind a proxy the accept address is the balancer, admission runs once the header named the client
+    bool awaitingProxyHeader = g_zincServer.expectsProxyHeader(addressKey);
+    if (!awaitingProxyHeader && !g_zincAdmissionController.admit(addressKey)) {
+        // refused before anything is allocated for the socket
+        evutil_closesocket(fd);
         return;
     }
+    TCPStream* stream = TCPServer::createStream(reactor, fd);
+    if (!stream) {
+        m_zincLogger.error("Failed to create stream");
+        evutil_closesocket(fd);
+        if (!awaitingProxyHeader) g_zincAdmissionController.release(addressKey);
+        return;
+    }
+    if (awaitingProxyHeader || g_zincConfig.m_core.m_optimizations.m_statusFastPath) {
+        // the ZincConnection is only created once the handshake asks for something other than Status
+        ZincPendingConnection* pending = new ZincPendingConnection();
+        pending->m_reactor = reactor;
+        pending->m_addressKey = addressKey;
+        pending->m_awaitingProxyHeader = awaitingProxyHeader;
+        std::memcpy(&pending->m_addr, addr, std::min(zinc_safe_cast<int, size_t>(socklen), sizeof(pending->m_addr)));
+        pending->m_timeout = g_zincServer.schedule(reactor->m_id, zinc_safe_cast<int, uint64_t>(g_zincConfig.m_core.m_network.m_handshakeTimeout) * 1000,
+                                                   [stream, pending]() {
+            pending->m_timeout = TimerWheel::TimerId();
+            closePending(stream, pending);
+        });
+        stream->setCallbacks(onPendingRead, onPendingWrite, onPendingEvent, pending);
+        stream->enableRead();
+        return;
+    }
+    acceptConnection(stream, reactor, addr, addressKey);
+    stream->enableRead();
+}
+ZincConnection* ZincServer::acceptConnection(TCPStream* stream, TCPReactor* reactor, struct sockaddr* addr, const ZincAddressKey& addressKey) {
     ZincConnection* connection = new ZincConnection();
+    connection->m_reactorId = reactor->m_id;
+    connection->m_addressKey = addressKey;
     connection->getTCPConnection().setAddr(addr);
-    connection->getTCPConnection().setFd(fd);
-    connection->getTCPConnection().setBuffer(bev);
+    connection->getTCPConnection().setFd(stream->getFd());
+    connection->getTCPConnection().setStream(stream);
     g_zincServer.addClient(connection);
     m_zincLogger.debug("Client [" + connection->getTCPConnection().getIP() + "] connected!"); 
-    bufferevent_setcb(bev, onRead, nullptr, onEvent, ptr);
-    bufferevent_enable(bev, EV_READ);
-}
-void ZincServer::onRead(bufferevent* bev, void* _arg1) {
-    if (!g_zincServer.isConnected(bufferevent_getfd(bev))) return;
-    ZincConnection* connection = g_zincServer.getClient(bufferevent_getfd(bev));
-    ZincPacket packet = connection->read();
-    ZincPacket replyPacket;
-    if (packet.getId() < 0) {
-        if (packet.getId() != -1) {
-            // send error
+    // the stream is closed together with the slot, so its callbacks never see a removed connection
+    stream->setCallbacks(onRead, onWrite, onEvent, connection);
+    setTimeout(connection, g_zincConfig.m_core.m_network.m_handshakeTimeout, "did not finish the handshake in time");
+    stream->setWriteLowWatermark(zinc_safe_cast<int, size_t>(g_zincConfig.m_core.m_network.m_outboundLowWatermark));
+    return connection;
+}
+void ZincServer::closePending(TCPStream* stream, ZincPendingConnection* pending) {
+    g_zincServer.cancel(pending->m_reactor->m_id, pending->m_timeout);
+    if (!pending->m_awaitingProxyHeader) g_zincAdmissionController.release(pending->m_addressKey);
+    stream->close();
+    delete pending;
+}
+void ZincServer::promotePending(TCPStream* stream, ZincPendingConnection* pending) {
+    // login and transfer take the regular path with the handshake still buffered
+    TCPReactor* reactor = pending->m_reactor;
+    g_zincServer.cancel(reactor->m_id, pending->m_timeout);
+    ZincConnection* connection = acceptConnection(stream, reactor, (struct sockaddr*) &pending->m_addr, pending->m_addressKey);
+    delete pending;
+    onRead(stream, connection);
+}
+void ZincServer::onPendingRead(TCPStream* stream, void* ptr) {
+    ZincPendingConnection* pending = (ZincPendingConnection*) ptr;
+    evbuffer* input = stream->getInput();
+    if (pending->m_awaitingProxyHeader) {
+        ProxyHeader header;
+        int headerLength = ProxyProtocol::read(input, header);
+        if (!headerLength) return;
+        if (headerLength < 0) {
+            m_zincLogger.debug("Closing connection without a valid PROXY protocol header");
+            return closePending(stream, pending);
         }
-        return;
+        if (!header.m_isLocal) {
+            pending->m_addr = header.m_source;
+            pending->m_addressKey = ZincAddressKey((const struct sockaddr*) &header.m_source);
+        }
+        if (!g_zincAdmissionController.admit(pending->m_addressKey)) return closePending(stream, pending);
+        pending->m_awaitingProxyHeader = false;
+        if (!g_zincConfig.m_core.m_optimizations.m_statusFastPath) return promotePending(stream, pending);
     }
-    m_zincLogger.info("Got packet with id " + std::to_string(packet.getId()) + " and data size " + std::to_string(packet.getData().size()));
-    switch (connection->getState()) {
-    case ZincConnection::State::Handshake: {
-        if (!packet.getId()) {
-            connection->m_info.m_networkInfo.m_protocolVersion = packet.getData().readVarNumeric<int>();
-            connection->m_info.m_networkInfo.m_serverAddr = packet.getData().readString();
-            connection->m_info.m_networkInfo.m_serverPort = packet.getData().readNumeric<unsigned short>();
-            connection->setState((ZincConnection::State) packet.getData().readVarNumeric<int>());
-            if (connection->getState() != ZincConnection::State::Status &&
-                connection->getState() != ZincConnection::State::Login &&
-                connection->getState() != ZincConnection::State::Transfer) connection->setState(ZincConnection::State::Status);
-            connection->m_shouldContinue = true;
+    while (true) {
+        size_t available = evbuffer_get_length(input);
+        size_t prefixLength = std::min<size_t>(available, 5);
+        const unsigned char* data = evbuffer_pullup(input, zinc_safe_cast<size_t, ev_ssize_t>(prefixLength));
+        int length = 0;
+        int varIntLength = TCPUtil::peekVarInt(data, prefixLength, length);
+        if (varIntLength < 0 || (varIntLength && (length <= 0 || length > MAX_PENDING_FRAME_LENGTH))) return closePending(stream, pending);
+        if (!varIntLength) return;
+        size_t frameLength = zinc_safe_cast<int, size_t>(varIntLength + length);
+        if (available < frameLength) return;
+        data = evbuffer_pullup(input, zinc_safe_cast<size_t, ev_ssize_t>(frameLength));
+        const unsigned char* payload = data + varIntLength;
+        size_t payloadLength = zinc_safe_cast<int, size_t>(length), offset = 0;
+        auto readVarInt = [&](int& value) {
+            int size = TCPUtil::peekVarInt(payload + offset, payloadLength - offset, value);
+            if (size <= 0) return false;
+            offset += zinc_safe_cast<int, size_t>(size);
+            return true;
+        };
+        int id = 0;
+        if (!readVarInt(id)) return closePending(stream, pending);
+        if (!pending->m_isStatus) {
+            int protocolVersion = 0, addressLength = 0, nextState = 0;
+            if (id || !readVarInt(protocolVersion) || !readVarInt(addressLength) || addressLength < 0) return closePending(stream, pending);
+            offset += zinc_safe_cast<int, size_t>(addressLength) + sizeof(unsigned short);
+            if (offset > payloadLength || !readVarInt(nextState)) return closePending(stream, pending);
+            if (nextState != (int) ZincConnection::State::Status) return promotePending(stream, pending);
+            pending->m_isStatus = true;
+        } else if (!pending->m_statusAnswered) {
+            // like vanilla exactly one empty status request is answered, anything else ends the connection
+            if (id || offset != payloadLength) return closePending(stream, pending);
+            pending->m_statusAnswered = true;
+            std::shared_ptr<const std::vector<char>> statusFrame = g_zincStatusCache.getFrame();
+            if (statusFrame && !writePending(stream, statusFrame->data(), statusFrame->size())) return closePending(stream, pending);
+        } else {
+            // the ping request is echoed back once as the pong, the connection closes after it was sent
+            if (pending->m_pingAnswered || id != 1 || offset + sizeof(int64_t) != payloadLength) return closePending(stream, pending);
+            pending->m_pingAnswered = true;
+            if (!writePending(stream, data, frameLength)) return closePending(stream, pending);
         }
-        break;
+        evbuffer_drain(input, frameLength);
+    }
+}
+bool ZincServer::writePending(TCPStream* stream, const void* data, const size_t& length) {
+    // a client that never reads is dropped instead of buffered, same cap as for ZincConnection
+    if (stream->getOutputLength() + length > zinc_safe_cast<int, size_t>(g_zincConfig.m_core.m_network.m_outboundHardCap)) return false;
+    stream->write(data, length);
+    return true;
+}
+void ZincServer::onPendingWrite(TCPStream* stream, void* ptr) {
+    ZincPendingConnection* pending = (ZincPendingConnection*) ptr;
+    if (pending->m_pingAnswered && !stream->getOutputLength()) closePending(stream, pending);
+}
+void ZincServer::onPendingEvent(TCPStream* stream, short events, void* ptr) {
+    if (events & (BEV_EVENT_EOF | BEV_EVENT_ERROR | BEV_EVENT_TIMEOUT)) closePending(stream, (ZincPendingConnection*) ptr);
+}
+void ZincServer::registerDefaultHandlers() {
+    typedef ZincConnection::State State;
+    m_dispatcher.registerHandler(State::Handshake, 0, handleHandshake);
+    m_dispatcher.registerHandler(State::Status, 0, handleStatusRequest);
+    m_dispatcher.registerHandler(State::Status, 1, handlePingRequest);
+    m_dispatcher.registerHandler(State::Login, 0, handleLoginStart);
+    m_dispatcher.registerHandler(State::Login, 1, handleEncryptionResponse);
+    m_dispatcher.registerHandler(State::Login, 2, handleLoginPluginResponse);
+    m_dispatcher.registerHandler(State::Login, 3, handleLoginAcknowledged);
+    m_dispatcher.registerHandler(State::Login, 4, handleCookieResponse);
+    m_dispatcher.registerHandler(State::Config, 0, handleClientInformation);
+    m_dispatcher.registerHandler(State::Config, 1, handleCookieResponse);
+    m_dispatcher.registerHandler(State::Config, 2, handlePluginMessage);
+    m_dispatcher.registerHandler(State::Config, 3, handleConfigAcknowledged);
+    m_dispatcher.registerHandler(State::Config, 4, handleKeepAlivePacket);
+    m_dispatcher.registerHandler(State::Config, 5, handleConfigPong);
+    m_dispatcher.registerHandler(State::Play, 0x1A, handleKeepAlivePacket);
+}
+bool ZincServer::handleHandshake(ZincConnection* connection, ZincPacket& packet) {
+    HandshakePacket handshake;
+    if (!decodePacket(packet, handshake)) return true;
+    connection->m_info.m_networkInfo.m_protocolVersion = handshake.m_protocolVersion;
+    connection->m_info.m_networkInfo.m_serverAddr = handshake.m_serverAddr;
+    connection->m_info.m_networkInfo.m_serverPort = handshake.m_serverPort;
+    connection->setState((ZincConnection::State) handshake.m_nextState);
+    if (connection->getState() != ZincConnection::State::Status &&
+        connection->getState() != ZincConnection::State::Login &&
+        connection->getState() != ZincConnection::State::Transfer) connection->setState(ZincConnection::State::Status);
+    return true;
+}
+bool ZincServer::handleStatusRequest(ZincConnection* connection, ZincPacket&) {
+    if (std::shared_ptr<const std::vector<char>> statusFrame = g_zincStatusCache.getFrame())
+        connection->sendFrames(statusFrame->data(), statusFrame->size());
+    return true;
+}
+bool ZincServer::handlePingRequest(ZincConnection* connection, ZincPacket& packet) {
+    connection->send(packet);
+    return true;
+}
+bool ZincServer::handleLoginStart(ZincConnection* connection, ZincPacket& packet) {
+    if (g_zincServer.m_onlinePlayers >= g_zincConfig.m_core.m_network.m_maxPlayerCount) {
+        connection->sendLoginError("Server is full");
+        return false;
     }
-    case ZincConnection::State::Status: {
-        if (packet.getId()) connection->send(packet);
+    if (connection->m_info.m_networkInfo.m_protocolVersion < LATEST_MINECRAFT_VERSION_PROTOCOL) {
+        connection->sendLoginError("You are using outdated version");
+    } else if (connection->m_info.m_networkInfo.m_protocolVersion > LATEST_MINECRAFT_VERSION_PROTOCOL) {
+        connection->sendLoginError("Server is using outdated version");
+    } else {
+        LoginStartPacket loginStart;
+        if (!decodePacket(packet, loginStart)) connection->sendLoginError("Server received invalid login start");
+        else if (loginStart.m_playerName.size() > 16) connection->sendLoginError("Player name can't be longer than 16 characters");
         else {
-            replyPacket.setId(0);
-            replyPacket.getData().writeString(nlohmann::json{
-                { "version", {
-                    { "name", LATEST_MINECRAFT_VERSION },
-                    { "protocol", LATEST_MINECRAFT_VERSION_PROTOCOL }
-                } },
-                { "players", {
-                    { "max", g_zincConfig.m_core.m_network.m_maxPlayerCount },
-                    { "online", g_zincServer.m_onlinePlayers },
-                    { "sample", nlohmann::json::array() }
-                } },
-                { "description", {
-                    { "text", g_zincConfig.m_core.m_network.m_motd }
-                } },
-                { "favicon", "data:image/png;base64," + g_zincConfig.m_core.m_network.m_iconBase64 },
-                { "enforcesSecureChat", true },
-            }.dump());
-            connection->send(replyPacket);
+            connection->m_info.m_playerInfo.m_playerName = loginStart.m_playerName;
+            connection->m_info.m_playerInfo.m_playerUUID = loginStart.m_playerUUID;
+            setTimeout(connection, g_zincConfig.m_core.m_network.m_loginTimeout, "did not finish logging in in time");
+            if (g_zincConfig.m_core.m_network.m_threshold > 0) connection->setupCompression();
+            connection->m_info.m_networkInfo.m_verifyToken = RandomUtil::randomBytes(64);
+            EncryptionRequestPacket encryptionRequest;
+            encryptionRequest.m_publicKey = g_zincServer.getRSA().getPublicKeyDER();
+            encryptionRequest.m_verifyToken = connection->m_info.m_networkInfo.m_verifyToken;
+            encryptionRequest.m_shouldAuthenticate = g_zincConfig.m_core.m_security.m_onlineMode;
+            connection->send(encodePacket(encryptionRequest));
         }
-        break;
     }
-    case ZincConnection::State::Login: {
-        switch(packet.getId()) {
-        /* LOGIN START */ case 0: {
-            if (connection->m_kickAtLogin) {
-                switch (connection->m_kickAtLogin) {
-                case 1: connection->sendLoginError("You have been rate limited. Try again later"); return;
-                case 2: connection->sendLoginError("You have reached a maximum amount of concurrent account"); return;
-                default: connection->sendLoginError("Unknown error"); return;
-                }
-            }
-            if (g_zincServer.m_onlinePlayers >= g_zincConfig.m_core.m_network.m_maxPlayerCount) {
-                connection->sendLoginError("Server is full");
+    return true;
+}
+bool ZincServer::handleEncryptionResponse(ZincConnection* connection, ZincPacket& packet) {
+    std::shared_ptr<EncryptionResponsePacket> encryptionResponse = std::make_shared<EncryptionResponsePacket>();
+    if (!decodePacket(packet, *encryptionResponse)) {
+        connection->sendLoginError("Server received invalid encryption response");
+        return true;
+    }
+    // both private key operations run on the worker pool, the verify token is checked there too
+    std::shared_ptr<bool> isValid = std::make_shared<bool>(false);
+    std::vector<unsigned char> verifyToken = connection->m_info.m_networkInfo.m_verifyToken;
+    g_zincServer.offload(connection, OffloadStage::RSA, [encryptionResponse, isValid, verifyToken]() {
+        *isValid = g_zincServer.getRSA().decrypt(encryptionResponse->m_verifyToken) == verifyToken;
+        if (*isValid) encryptionResponse->m_sharedSecret = g_zincServer.getRSA().decrypt(encryptionResponse->m_sharedSecret);
+    }, [encryptionResponse, isValid](ZincConnection* connection) {
+        if (!*isValid) connection->sendLoginError("Server received invalid encryption response");
+        else completeEncryption(connection, encryptionResponse->m_sharedSecret);
+    });
+    return true;
+}
+void ZincServer::completeEncryption(ZincConnection* connection, const std::vector<unsigned char>& sharedSecret) {
+    connection->m_info.m_networkInfo.m_verifyToken.clear();
+    connection->setupEncryption(sharedSecret);
+    if (!g_zincConfig.m_core.m_security.m_onlineMode) {
+        completeLogin(connection);
+        return;
+    }
+    MCSHA1 sha;
+    sha.update(std::vector<char>({}));
+    sha.update(sharedSecret);
+    sha.update(g_zincServer.getRSA().getPublicKeyDER());
+    sha.final();
+    // the session server round-trip happens on an auth worker, login resumes on this reactor
+    connection->m_pendingAuth = true;
+    size_t reactorId = connection->m_reactorId;
+    ConnectionHandle handle = connection->m_handle;
+    ZincAuthRequest request;
+    request.m_playerName = connection->m_info.m_playerInfo.m_playerName;
+    request.m_serverId = sha.digestJava();
+    request.m_callback = [reactorId, handle](const ZincAuthResult& result) {
+        g_zincServer.post(reactorId, [handle, result]() {
+            ZincConnection* connection = g_zincServer.getClient(handle);
+            if (!connection) return;
+            connection->m_pendingAuth = false;
+            if (!result.m_success) {
+                if (result.m_unreachable) connection->sendLoginError("Server is unable to access mojang session servers");
+                else connection->sendLoginError("Failed to verify username");
                 return;
             }
-            if (connection->m_info.m_networkInfo.m_protocolVersion < LATEST_MINECRAFT_VERSION_PROTOCOL) {
-                connection->sendLoginError("You are using outdated version");
-            } else if (connection->m_info.m_networkInfo.m_protocolVersion > LATEST_MINECRAFT_VERSION_PROTOCOL) {
-                connection->sendLoginError("Server is using outdated version");
-            } else {
-                connection->m_info.m_playerInfo.m_playerName = packet.getData().readString();
-                connection->m_info.m_playerInfo.m_playerUUID = packet.getData().readUUID();
-                if (connection->m_info.m_playerInfo.m_playerName.size() > 16) connection->sendLoginError("Player name can't be longer than 16 characters");
-                else {
-                    if (g_zincConfig.m_core.m_network.m_threshold > 0) connection->setupCompression();
-                    replyPacket.setId(1);
-                    replyPacket.getData().writeString("");
-                    replyPacket.getData().writePrefixedArray<unsigned char>(g_zincServer.getRSA().getPublicKeyDER(), &ByteBuffer::writeUnsignedByte);
-                    connection->m_info.m_networkInfo.m_verifyToken = RandomUtil::randomBytes(64);
-                    replyPacket.getData().writePrefixedArray<unsigned char>(connection->m_info.m_networkInfo.m_verifyToken, &ByteBuffer::writeUnsignedByte);
-                    replyPacket.getData().writeByte(g_zincConfig.m_core.m_security.m_onlineMode);
-                    connection->send(replyPacket);
-                }
-            }
-            break;
-        }
-        /* ENCRYPTION RESPONSE */ case 1: {
-            std::vector<unsigned char> sharedSecret = packet.getData().readPrefixedArray<unsigned char>(&ByteBuffer::readUnsignedByte);
-            std::vector<unsigned char> verifyToken = packet.getData().readPrefixedArray<unsigned char>(&ByteBuffer::readUnsignedByte);
-            sharedSecret = g_zincServer.getRSA().decrypt(sharedSecret);
-            if (g_zincServer.getRSA().decrypt(verifyToken) == connection->m_info.m_networkInfo.m_verifyToken) {
-                connection->m_info.m_networkInfo.m_verifyToken.clear();
-                connection->setupEncryption(sharedSecret);
-                if (g_zincConfig.m_core.m_security.m_onlineMode) {
-                    MCSHA1 sha;
-                    sha.update(std::vector<char>({}));
-                    sha.update(sharedSecret);
-                    sha.update(g_zincServer.getRSA().getPublicKeyDER());
-                    sha.final();
-                    std::string url = "https://sessionserver.mojang.com/session/minecraft/hasJoined?username=" + 
-                                    connection->m_info.m_playerInfo.m_playerName + "&serverId=" + sha.digestJava();
-                    bool gotData = false;
-                    for (int i = 0; i < 10; i++) {
-                        try {
-                            std::stringstream ss;
-                            ss << curlpp::options::Url(url);
-                            nlohmann::json JSON = nlohmann::json::parse(ss.str());
-                            ss.clear();
-                            connection->m_info.m_playerInfo.m_playerUUID = uuids::uuid::from_string(std::string(JSON["id"])).value();
-                            connection->m_info.m_playerInfo.m_playerName = JSON["name"];
-                            for (auto const& propertyJSON : JSON["properties"]) {
-                                ZincConnectionProperty property;
-                                    property.m_name = propertyJSON["name"];
-                                    property.m_value = propertyJSON["value"];
-                                if (propertyJSON.contains("signature"))
-                                    property.m_signature = propertyJSON["signature"];
-                                connection->m_info.m_playerInfo.m_properties.push_back(property);
-                            }
-                            gotData = true;
-                        } catch (std::exception& e) {
-                            m_zincLogger.error(e.what());
-                            continue; 
-                        }
-                    }
-                    if (!gotData) {
-                        connection->sendLoginError("Server is unable to access mojang session servers");
-                        return;
-                    }
-                }
-                if (g_zincCookieRequests.contains(ZincConnection::State::Login)) 
-                    for (const std::string& cookieRequest : g_zincCookieRequests[ZincConnection::State::Login]) 
-                        connection->sendCookieRequest(cookieRequest);
-                if (g_zincServerInitPluginChannels.contains(ZincConnection::State::Login)) 
-                    for (const auto& pluginRequest : g_zincServerInitPluginChannels[ZincConnection::State::Login]) 
-                        connection->sendPluginMessage(Identifier(pluginRequest.first), pluginRequest.second(connection));
-                replyPacket.setId(2);
-                replyPacket.getData().writeUUID(connection->m_info.m_playerInfo.m_playerUUID);
-                replyPacket.getData().writeString(connection->m_info.m_playerInfo.m_playerName);
-                replyPacket.getData().writePrefixedArray<ZincConnectionProperty>(connection->m_info.m_playerInfo.m_properties, &writeZincConnectionProperty);
-                connection->send(replyPacket);
-            } else {
-                connection->sendLoginError("Server received invalid encryption response");
-            }
-            break;
-        }
-        /* LOGIN PLUGIN RESPONSE */ case 2: {
-            std::vector<unsigned char> id = packet.getData().readArray<unsigned char>(&ByteBuffer::readUnsignedByte, 4);
-            if (connection->isLoginPluginChannelOpened(id)) {
-                g_zincServerPluginChannels[connection->getLoginPluginChannel(id)](packet.getData(), connection);
-                connection->closeLoginPluginChannel(id);
-            } else {
-                connection->sendLoginError("Server received invalid login plugin channel id");
-            }
-            break;
-        }
-        /* LOGIN ACK */ case 3: {
-            connection->setState(ZincConnection::State::Config);
-            connection->m_mutex.lock();
-            connection->m_loginFinished = true;
-            connection->m_mutex.unlock();
-            std::lock_guard lock (g_zincServer.m_mutex);
-            g_zincServer.m_onlinePlayers++;
-            break;
-        }
-        /* COOKIE RESPONSE */ case 4: {
-            Identifier cookieId = packet.getData().readIdentifier();
-            std::optional<std::vector<char>> bytes = packet.getData().readPrefixedOptional(&ByteBuffer::readPrefixedByteArray);
-            if (bytes.has_value()) {
-                ByteBuffer cookieRawData = bytes.value();
-                std::optional<std::vector<char>> cookieData = connection->extractCookieData(cookieRawData)
-                    .readPrefixedOptional<std::vector<char>>(&ByteBuffer::readPrefixedByteArray);
-                g_zincCookieResponseParsers[cookieId.toString()](cookieData, connection);
-            } else g_zincCookieResponseParsers[cookieId.toString()](bytes, connection);
-            break;
-        }
-        default: break;
-        }
-        break;
+            connection->m_info.m_playerInfo.m_playerUUID = result.m_playerUUID;
+            connection->m_info.m_playerInfo.m_playerName = result.m_playerName;
+            connection->m_info.m_playerInfo.m_properties = result.m_properties;
+            completeLogin(connection);
+            resumeRead(connection);
+        });
+    };
+    if (!g_zincAuthService.submit(request)) {
+        connection->m_pendingAuth = false;
+        connection->sendLoginError("Server is busy, try again later");
     }
-    case ZincConnection::State::Config: {
-        switch (packet.getId()) {
-        /* CONFIG INFO */ case 0: {
-            g_zincConfig.m_banMutex.lock();
-            std::optional<BanData> matchedBan;
-            for (const BanData& banData : g_zincConfig.m_bans) {
-                if (
-                    (connection->m_info.m_playerInfo.m_playerName == banData.m_playerName && !g_zincConfig.m_core.m_security.m_onlineMode) ||
-                    (connection->m_info.m_playerInfo.m_playerUUID == banData.m_playerUUID && g_zincConfig.m_core.m_security.m_onlineMode) ||
-                    (connection->getTCPConnection().getIP() == banData.m_playerIp && banData.m_isIpBan)
-                ) {
-                    matchedBan = banData;
-                    break;
-                }
-            }
-            g_zincConfig.m_banMutex.unlock();
-            if (matchedBan.has_value()) {
-                if (connection->sendBanMessage(matchedBan.value())) return;
-            }
-            connection->m_info.m_settingsInfo.m_locale = packet.getData().readString();
-            connection->m_info.m_settingsInfo.m_renderDistance = packet.getData().readUnsignedByte();
-            connection->m_info.m_settingsInfo.m_chatMode = (ZincConnectionInfo::SettingsInfo::ChatMode) packet.getData().readVarNumeric<int>();
-            connection->m_info.m_settingsInfo.m_enableChatColors = packet.getData().readByte();
-            connection->m_info.m_settingsInfo.m_skinParts = packet.getData().readUnsignedByte();
-            connection->m_info.m_settingsInfo.m_mainHand = (ZincConnectionInfo::SettingsInfo::MainHand) packet.getData().readVarNumeric<int>();
-            connection->m_info.m_settingsInfo.m_enableTextFiltering = packet.getData().readByte();
-            connection->m_info.m_settingsInfo.m_idkWhyIEvenListItHereButOk__enableServerListing = packet.getData().readByte();
-            connection->m_info.m_settingsInfo.m_particleStatus = (ZincConnectionInfo::SettingsInfo::ParticleStatus) packet.getData().readVarNumeric<int>();
-            if (connection->m_info.m_settingsInfo.m_renderDistance > g_zincConfig.m_core.m_optimizations.m_viewDistance)
-                connection->m_info.m_settingsInfo.m_renderDistance 
-                    = zinc_safe_cast<int, unsigned char>(g_zincConfig.m_core.m_optimizations.m_viewDistance);
-            replyPacket.setId(6);
-            connection->send(replyPacket);
-            replyPacket.setId(4);
-            connection->m_info.m_networkInfo.m_lastKeepAlive = time(nullptr);
-            connection->m_info.m_networkInfo.m_verifyToken = RandomUtil::randomBytes(4);
-            replyPacket.getData().writeNumeric<int64_t>(connection->m_info.m_networkInfo.m_lastKeepAlive);
-            connection->send(replyPacket);
-            replyPacket.getData().clear();
-            replyPacket.setId(5);
-            replyPacket.getData().writeArray<unsigned char>(connection->m_info.m_networkInfo.m_verifyToken, &ByteBuffer::writeUnsignedByte);
-            connection->send(replyPacket);
-            replyPacket.getData().clear();
-            replyPacket.setId(12);
-            replyPacket.getData().writePrefixedArray<Identifier>({ Identifier("minecraft", "vanilla") }, &ByteBuffer::writeIdentifier);
-            connection->send(replyPacket);
-            replyPacket.getData().clear();
-            if (g_zincCookieRequests.contains(ZincConnection::State::Config)) 
-                for (const std::string& cookieRequest : g_zincCookieRequests[ZincConnection::State::Config]) 
-                    connection->sendCookieRequest(cookieRequest);
-            if (g_zincServerInitPluginChannels.contains(ZincConnection::State::Config)) 
-                for (const auto& pluginMessage : g_zincServerInitPluginChannels[ZincConnection::State::Config]) 
-                    connection->sendPluginMessage(Identifier(pluginMessage.first), pluginMessage.second(connection));
-            replyPacket.setId(7);
-            for (const auto& registry : g_registries) {
-                replyPacket.getData().clear();
-                replyPacket.setData(getNetworkRegistry(registry.second, Identifier("minecraft:" + registry.first)));
-                m_zincLogger.debug("Sending minecraft:" + registry.first + " (" + std::to_string(replyPacket.getData().size()) + ")");
-                connection->send(replyPacket);
-            }
-            connection->sendDisconnect(TextComponentBuilder().text("Currently WIP").build());
-            break;
+}
+bool ZincServer::handleLoginPluginResponse(ZincConnection* connection, ZincPacket& packet) {
+    LoginPluginResponsePacket response;
+    if (decodePacket(packet, response) && connection->isLoginPluginChannelOpened(response.m_messageId)) {
+        auto channel = g_zincServerPluginChannels.find(connection->getLoginPluginChannel(response.m_messageId));
+        if (channel != g_zincServerPluginChannels.end()) {
+            ByteBuffer data (response.m_data);
+            ConnectionHandle handle = connection->m_handle;
+            channel->second(data, connection);
+            // the plugin may have kicked the player
+            if (!g_zincServer.isConnected(handle)) return false;
         }
-        /* COOKIE RESPONSE */ case 1: {
-            Identifier cookieId = packet.getData().readIdentifier();
-            std::optional<std::vector<char>> bytes = packet.getData().readPrefixedOptional(&ByteBuffer::readPrefixedByteArray);
-            if (bytes.has_value()) {
-                ByteBuffer cookieRawData = bytes.value();
-                std::optional<std::vector<char>> cookieData = connection->extractCookieData(cookieRawData)
-                    .readPrefixedOptional<std::vector<char>>(&ByteBuffer::readPrefixedByteArray);
-                g_zincCookieResponseParsers[cookieId.toString()](cookieData, connection);
-            } else g_zincCookieResponseParsers[cookieId.toString()](bytes, connection);
+        connection->closeLoginPluginChannel(response.m_messageId);
+    } else {
+        connection->sendLoginError("Server received invalid login plugin channel id");
+    }
+    return true;
+}
+bool ZincServer::handleLoginAcknowledged(ZincConnection* connection, ZincPacket&) {
+    connection->setState(ZincConnection::State::Config);
+    g_zincServer.cancel(connection->m_reactorId, connection->m_timeout);
+    scheduleKeepAlive(connection, zinc_safe_cast<int, uint64_t>(g_zincConfig.m_core.m_network.m_keepAliveInterval) * 1000);
+    connection->m_mutex.lock();
+    connection->m_loginFinished = true;
+    connection->m_mutex.unlock();
+    g_zincServer.m_onlinePlayers++;
+    return true;
+}
+bool ZincServer::handleCookieResponse(ZincConnection* connection, ZincPacket& packet) {
+    CookieResponsePacket response;
+    if (!decodePacket(packet, response)) return true;
+    // the key comes from the client, cookies nobody asked for are dropped
+    if (!g_zincCookieResponseParsers.contains(response.m_key.toString())) return true;
+    if (response.m_payload.has_value()) {
+        // signature check and payload decryption run on the worker pool
+        std::shared_ptr<std::optional<std::vector<char>>> cookieData = std::make_shared<std::optional<std::vector<char>>>(std::move(response.m_payload));
+        std::string key = response.m_key.toString();
+        g_zincServer.offload(connection, OffloadStage::Cookie, [cookieData]() {
+            ByteBuffer cookieRawData = cookieData->value();
+            *cookieData = ZincConnection::extractCookieData(cookieRawData).readPrefixedOptional<std::vector<char>>(&ByteBuffer::readPrefixedByteArray);
+        }, [cookieData, key](ZincConnection* connection) {
+            g_zincCookieResponseParsers.at(key)(*cookieData, connection);
+        });
+    } else g_zincCookieResponseParsers.at(response.m_key.toString())(response.m_payload, connection);
+    return true;
+}
+bool ZincServer::handleClientInformation(ZincConnection* connection, ZincPacket& packet) {
+    g_zincConfig.m_banMutex.lock();
+    std::optional<BanData> matchedBan;
+    for (const BanData& banData : g_zincConfig.m_bans) {
+        if (
+            (connection->m_info.m_playerInfo.m_playerName == banData.m_playerName && !g_zincConfig.m_core.m_security.m_onlineMode) ||
+            (connection->m_info.m_playerInfo.m_playerUUID == banData.m_playerUUID && g_zincConfig.m_core.m_security.m_onlineMode) ||
+            (connection->getTCPConnection().getIP() == banData.m_playerIp && banData.m_isIpBan)
+        ) {
+            matchedBan = banData;
             break;
         }
-        /* PLUGIN MESSAGE C2S */ case 2: {
-            g_zincServerPluginChannels[packet.getData().readIdentifier().toString()](packet.getData(), connection);
-            break;
+    }
+    g_zincConfig.m_banMutex.unlock();
+    if (matchedBan.has_value()) {
+        if (connection->sendBanMessage(matchedBan.value())) return false;
+    }
+    ClientInformationPacket clientInformation;
+    if (!decodePacket(packet, clientInformation)) {
+        connection->sendLoginError("Server received invalid client information");
+        return false;
+    }
+    connection->m_info.m_settingsInfo = clientInformation.m_settings;
+    if (connection->m_info.m_settingsInfo.m_renderDistance > g_zincConfig.m_core.m_optimizations.m_viewDistance)
+        connection->m_info.m_settingsInfo.m_renderDistance 
+            = zinc_safe_cast<int, unsigned char>(g_zincConfig.m_core.m_optimizations.m_viewDistance);
+    connection->send(ZincPacket(6));
+    sendKeepAlive(connection);
+    connection->m_info.m_networkInfo.m_verifyToken = RandomUtil::randomBytes(4);
+    ConfigPingPacket ping;
+    ping.m_id = connection->m_info.m_networkInfo.m_verifyToken;
+    connection->send(encodePacket(ping));
+    KnownPacksPacket knownPacks;
+    knownPacks.m_packs = { Identifier("minecraft", "vanilla") };
+    connection->send(encodePacket(knownPacks));
+    if (g_zincCookieRequests.contains(ZincConnection::State::Config)) 
+        for (const std::string& cookieRequest : g_zincCookieRequests[ZincConnection::State::Config]) 
+            connection->sendCookieRequest(cookieRequest);
+    if (g_zincServerInitPluginChannels.contains(ZincConnection::State::Config)) 
+        for (const auto& pluginMessage : g_zincServerInitPluginChannels[ZincConnection::State::Config]) 
+            connection->sendPluginMessage(Identifier(pluginMessage.first), pluginMessage.second(connection));
+    if (std::shared_ptr<const std::vector<char>> registryFrames = g_registryPacketCache.getFrames(connection->getIsCompressed())) {
+        m_zincLogger.debug("Sending " + std::to_string(g_registries.size()) + " registries (" + std::to_string(registryFrames->size()) + ")");
+        connection->sendFrames(registryFrames->data(), registryFrames->size());
+    }
+    connection->sendDisconnect(TextComponentBuilder().text("Currently WIP").build());
+    return true;
+}
+bool ZincServer::handlePluginMessage(ZincConnection* connection, ZincPacket& packet) {
+    PluginMessagePacket message;
+    if (!decodePacket(packet, message)) return true;
+    // unknown channels are ignored like the vanilla server does
+    auto channel = g_zincServerPluginChannels.find(message.m_channel.toString());
+    if (channel == g_zincServerPluginChannels.end()) return true;
+    ByteBuffer data (message.m_data);
+    channel->second(data, connection);
+    return true;
+}
+bool ZincServer::handleConfigAcknowledged(ZincConnection* connection, ZincPacket&) {
+    connection->setState(ZincConnection::State::Play);
+    return true;
+}
+bool ZincServer::handleKeepAlivePacket(ZincConnection* connection, ZincPacket& packet) {
+    KeepAlivePacket keepAlive;
+    if (decodePacket(packet, keepAlive)) handleKeepAlive(connection, keepAlive.m_id);
+    return true;
+}
+bool ZincServer::handleConfigPong(ZincConnection* connection, ZincPacket& packet) {
+    ConfigPongPacket pong;
+    if (!decodePacket(packet, pong) || connection->m_info.m_networkInfo.m_verifyToken != pong.m_id) connection->sendLoginError("Server received invalid ping packet");
+    return true;
+}
+void ZincServer::resumeRead(ZincConnection* connection) {
+    if (connection->hasPendingWork()) return;
+    TCPStream* stream = connection->getTCPConnection().getStream();
+    stream->enableRead();
+    if (connection->hasBufferedInput()) onRead(stream, connection);
+}
+void ZincServer::onRead(TCPStream* stream, void* _arg1) {
+    ZincConnection* connection = (ZincConnection*) _arg1;
+    // reactor threads aren't pinned, so a handler that removes the connection frees it before dispatch returns
+    ConnectionHandle handle = connection->m_handle;
+    // handle every complete frame in this callback instead of recursing per packet
+    while (true) {
+        if (connection->hasPendingWork()) {
+            // the socket isn't read until offloaded work and the session server answered, so the input can't pile up meanwhile
+            stream->disableRead();
+            return;
         }
-        /* CONFIG ACK */ case 3: {
-            connection->setState(ZincConnection::State::Play);
-            break;
+        ZincPacket packet = connection->read();
+        if (packet.getId() == ZincConnection::INFLATE_PENDING) {
+            std::shared_ptr<ZincPacket> inflated = std::make_shared<ZincPacket>(std::move(packet));
+            g_zincServer.offload(connection, OffloadStage::Inflate, [inflated]() {
+                *inflated = ZincConnection::inflate(inflated->getData().data(), inflated->getData().size());
+            }, [inflated](ZincConnection* connection) {
+                if (inflated->getId() < 0) {
+                    m_zincLogger.info("Client [" + connection->getTCPConnection().getIP() + "] sent a malformed compressed packet");
+                    g_zincServer.removeClient(connection->m_handle);
+                    return;
+                }
+                m_zincLogger.info("Got packet with id " + std::to_string(inflated->getId()) + " and data size " + std::to_string(inflated->getData().size()));
+                g_zincServer.m_dispatcher.dispatch(connection, *inflated);
+            });
+            continue;
         }
-        /* KEEP ALIVE */ case 4: {
-            int64_t keepAlive = packet.getData().readNumeric<int64_t>();
-            if (connection->m_info.m_networkInfo.m_lastKeepAlive != keepAlive) connection->sendLoginError("Server received invalid keep alive packet");
-            else {
-                connection->m_info.m_networkInfo.m_lastKeepAlive = -1;
+        if (packet.getId() < 0) {
+            // the bad frame is still buffered and would be parsed again on every read, so the client is dropped
+            if (packet.getId() != -1) {
+                m_zincLogger.info("Client [" + connection->getTCPConnection().getIP() + "] sent a malformed packet");
+                g_zincServer.removeClient(connection->m_handle);
             }
-            break;
+            return;
         }
-        /* PING */ case 5: {
-            std::vector<unsigned char> ping = packet.getData().readArray<unsigned char>(&ByteBuffer::readUnsignedByte, 4);
-            if (connection->m_info.m_networkInfo.m_verifyToken != ping) connection->sendLoginError("Server received invalid ping packet");
-            break;
-        }
-        default: break;
-        }
-        break;
+        m_zincLogger.info("Got packet with id " + std::to_string(packet.getId()) + " and data size " + std::to_string(packet.getData().size()));
+        if (!g_zincServer.m_dispatcher.dispatch(connection, packet) || !g_zincServer.isConnected(handle)) return;
     }
-    default: break;
-    }
-    if (connection->getTCPConnection().read().size() && connection->m_shouldContinue) onRead(bev, _arg1);
-    connection->m_shouldContinue = true;
-}
-void ZincServer::onEvent(bufferevent *bev, short events, void*) {
-    int fd = bufferevent_getfd(bev);
-    m_zincLogger.debug("Event triggered: " + std::to_string(events) + " on fd " + std::to_string(fd));
-    if (!g_zincServer.isConnected(bufferevent_getfd(bev))) return;
-    ZincConnection* connection = g_zincServer.getClient(bufferevent_getfd(bev));
+}
+void ZincServer::onWrite(TCPStream*, void* ptr) {
+    ((ZincConnection*) ptr)->onOutputDrained();
+}
+void ZincServer::onEvent(TCPStream* stream, short events, void* ptr) {
+    ZincConnection* connection = (ZincConnection*) ptr;
+    m_zincLogger.debug("Event triggered: " + std::to_string(events) + " on fd " + std::to_string(stream->getFd()));
     if (events & BEV_EVENT_EOF) {
         m_zincLogger.info("Client [" + connection->getTCPConnection().getIP() + "] disconnected!"); 
-        g_zincServer.removeClient(fd);
+        g_zincServer.removeClient(connection->m_handle);
     } else if (events & BEV_EVENT_ERROR) {
-        m_zincLogger.error("Client [" + connection->getTCPConnection().getIP() + "] encountered libevent error!"); 
-        g_zincServer.removeClient(fd);
+        m_zincLogger.error("Client [" + connection->getTCPConnection().getIP() + "] encountered a socket error!"); 
+        g_zincServer.removeClient(connection->m_handle);
     } else if (events & BEV_EVENT_TIMEOUT) {
         m_zincLogger.info("Client [" + connection->getTCPConnection().getIP() + "] timed out!"); 
-        g_zincServer.removeClient(fd);
+        g_zincServer.removeClient(connection->m_handle);
     }
 }
 
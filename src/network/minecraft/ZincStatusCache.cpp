@@ -0,0 +1,66 @@
+#include <network/minecraft/ZincStatusCache.h>
+#include <network/minecraft/ZincServer.h>
+#include <network/minecraft/ZincPackets.h>
+#include <external/JSON.h>
+#include <ZincConstants.h>
+#include <ZincConfig.h>
+
+namespace zinc {
+
+ZincStatusCache g_zincStatusCache;
+
+std::shared_ptr<const std::vector<char>> ZincStatusCache::build() {
+    StatusResponsePacket response;
+    response.m_response = nlohmann::json{
+        { "version", {
+            { "name", LATEST_MINECRAFT_VERSION },
+            { "protocol", LATEST_MINECRAFT_VERSION_PROTOCOL }
+        } },
+        { "players", {
+            { "max", m_maxPlayerCount },
+            { "online", m_onlinePlayers },
+            { "sample", nlohmann::json::array() }
+        } },
+        { "description", {
+            { "text", g_zincConfig.m_core.m_network.m_motd }
+        } },
+        { "favicon", "data:image/png;base64," + g_zincConfig.m_core.m_network.m_iconBase64 },
+        { "enforcesSecureChat", true },
+    }.dump();
+    ZincPacket packet = encodePacket(response);
+    evbuffer* output = evbuffer_new();
+    if (!ZincConnection::writeFrame(output, packet, false)) {
+        evbuffer_free(output);
+        return nullptr;
+    }
+    std::shared_ptr<std::vector<char>> frame = std::make_shared<std::vector<char>>(evbuffer_get_length(output));
+    evbuffer_remove(output, frame->data(), frame->size());
+    evbuffer_free(output);
+    return frame;
+}
+std::shared_ptr<const std::vector<char>> ZincStatusCache::getFrame() {
+    int onlinePlayers = g_zincServer.m_onlinePlayers.load();
+    std::lock_guard lock(m_mutex);
+    if (!m_frame || m_onlinePlayers != onlinePlayers || m_maxPlayerCount != g_zincConfig.m_core.m_network.m_maxPlayerCount) {
+        m_onlinePlayers = onlinePlayers;
+        m_maxPlayerCount = g_zincConfig.m_core.m_network.m_maxPlayerCount;
+        m_frame = build();
+    }
+    return m_frame;
+}
+void ZincStatusCache::setMotd(const std::string& motd) {
+    std::lock_guard lock(m_mutex);
+    g_zincConfig.m_core.m_network.m_motd = motd;
+    m_frame.reset();
+}
+void ZincStatusCache::setIcon(const std::string& iconBase64) {
+    std::lock_guard lock(m_mutex);
+    g_zincConfig.m_core.m_network.m_iconBase64 = iconBase64;
+    m_frame.reset();
+}
+void ZincStatusCache::invalidate() {
+    std::lock_guard lock(m_mutex);
+    m_frame.reset();
+}
+
+}
@@ -39,30 +39,30 @@ SrvCtlConnection* SrvCtlServer::getClient(evutil_socket_t fd) {
     return m_clients[fd];
 }
 void SrvCtlServer::onAccept(evconnlistener*, evutil_socket_t fd, struct sockaddr* addr, int, void* ptr) {
-    bufferevent* bev = bufferevent_socket_new((event_base*) ptr, fd, BEV_OPT_CLOSE_ON_FREE);
-    if (!bev) {
-        m_srvCtlLogger.error("Failed to create bufferevent");
+    TCPStream* stream = TCPServer::createStream((TCPReactor*) ptr, fd);
+    if (!stream) {
+        m_srvCtlLogger.error("Failed to create stream");
         return;
     }
     SrvCtlConnection* connection = new SrvCtlConnection();
     connection->getTCPConnection().setAddr(addr);
     connection->getTCPConnection().setFd(fd);
-    connection->getTCPConnection().setBuffer(bev);
+    connection->getTCPConnection().setStream(stream);
     g_srvCtlServer.addClient(connection);
     m_srvCtlLogger.debug("Client [" + connection->getTCPConnection().getIP() + "] connected!"); 
-    bufferevent_setcb(bev, onRead, nullptr, onEvent, ptr);
-    bufferevent_enable(bev, EV_READ);
+    stream->setCallbacks(onRead, nullptr, onEvent, ptr);
+    stream->enableRead();
 }
-void SrvCtlServer::onRead(bufferevent* bev, void*) {
-    if (!g_srvCtlServer.isConnected(bufferevent_getfd(bev))) return;
-    SrvCtlConnection* connection = g_srvCtlServer.getClient(bufferevent_getfd(bev));
+void SrvCtlServer::onRead(TCPStream* stream, void*) {
+    if (!g_srvCtlServer.isConnected(stream->getFd())) return;
+    SrvCtlConnection* connection = g_srvCtlServer.getClient(stream->getFd());
     ByteBuffer buffer = connection->getTCPConnection().read();
     ByteBuffer resultBuffer;
     if (buffer.size() < 9) {
         resultBuffer.writeNumeric<unsigned long>(1 + resultBuffer.getVarNumericLength<int>(-1));
         resultBuffer.writeVarNumeric<int>(-1);   // status s2c
         resultBuffer.writeByte(-1);     // state: error -1 (invalid packet)
-        TCPUtil::drain(bev, buffer.size());
+        TCPUtil::drain(stream, buffer.size());
         connection->getTCPConnection().send(resultBuffer);
         return;
     }
@@ -71,12 +71,12 @@ void SrvCtlServer::onRead(bufferevent* bev, void*) {
         resultBuffer.writeNumeric<unsigned long>(1 + resultBuffer.getVarNumericLength<int>(-1));
         resultBuffer.writeVarNumeric<int>(-1);   // status s2c
         resultBuffer.writeByte(-1);     // state: error -1 (invalid packet)
-        TCPUtil::drain(bev, buffer.size());
+        TCPUtil::drain(stream, buffer.size());
         connection->getTCPConnection().send(resultBuffer);
         return;
     }
     int packetId = buffer.readVarNumeric<int>();
-    TCPUtil::drain(bev, 8 + length);
+    TCPUtil::drain(stream, 8 + length);
     switch (connection->getState()) {
     case SrvCtlConnection::State::Handshake: {
         // don't check packet id. it's useless now
@@ -111,16 +111,16 @@ void SrvCtlServer::onRead(bufferevent* bev, void*) {
     }
     }
 }
-void SrvCtlServer::onEvent(bufferevent *bev, short events, void *) {
-    int fd = bufferevent_getfd(bev);
+void SrvCtlServer::onEvent(TCPStream* stream, short events, void *) {
+    int fd = stream->getFd();
     m_srvCtlLogger.debug("Event triggered: " + std::to_string(events) + " on fd " + std::to_string(fd));
-    if (!g_srvCtlServer.isConnected(bufferevent_getfd(bev))) return;
-    SrvCtlConnection* connection = g_srvCtlServer.getClient(bufferevent_getfd(bev));
+    if (!g_srvCtlServer.isConnected(stream->getFd())) return;
+    SrvCtlConnection* connection = g_srvCtlServer.getClient(stream->getFd());
     if (events & BEV_EVENT_EOF) {
         m_srvCtlLogger.info("Client [" + connection->getTCPConnection().getIP() + "] disconnected!"); 
         g_srvCtlServer.removeClient(fd);
     } else if (events & BEV_EVENT_ERROR) {
-        m_srvCtlLogger.error("Client [" + connection->getTCPConnection().getIP() + "] encountered libevent error!"); 
+        m_srvCtlLogger.error("Client [" + connection->getTCPConnection().getIP() + "] encountered a socket error!"); 
         g_srvCtlServer.removeClient(fd);
     } else if (events & BEV_EVENT_TIMEOUT) {
         m_srvCtlLogger.info("Client [" + connection->getTCPConnection().getIP() + "] timed out!"); 
@@ -3196,18 +3196,16 @@ Registry<ConsumeEffectData> g_consumeEffectRegistry = Registry<ConsumeEffectData
     { "minecraft:apply_effects", 0 }, { "minecraft:remove_effects", 1 }, { "minecraft:clear_effects", 2 }, 
     { "minecraft:teleport_randomly", 3 }, { "minecraft:play_sound", 4 } 
 }, {
-    { "minecraft:apply_effects", [](const ConsumeEffectData& data) {
-        ByteBuffer buffer;
-        for (const PotionEffect& effect : data.m_effects) buffer.writeByteArray(effect.toBytes());
+    { "minecraft:apply_effects", [](const ConsumeEffectData& data, ByteBuffer& buffer) {
+        for (const PotionEffect& effect : data.m_effects) buffer.writePotionEffect(effect);
         buffer.writeNumeric<float>(data.m_probability);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:remove_effects", [](const ConsumeEffectData& data) 
-        { ByteBuffer buffer; buffer.writeIDSet(data.m_effectsRemove); return buffer.getBytes(); } }, 
-    { "minecraft:clear_effects", [](const ConsumeEffectData&) { return ByteBuffer().getBytes(); } }, 
-    { "minecraft:teleport_randomly", [](const ConsumeEffectData& data) 
-        { ByteBuffer buffer; buffer.writeNumeric<float>(data.m_diameter); return buffer.getBytes(); } }, 
-    { "minecraft:play_sound", [](const ConsumeEffectData& data) { ByteBuffer buffer; buffer.writeSoundEvent(data.m_sound); return buffer.getBytes(); } } 
+    { "minecraft:remove_effects", [](const ConsumeEffectData& data, ByteBuffer& buffer) 
+        { buffer.writeIDSet(data.m_effectsRemove); } }, 
+    { "minecraft:clear_effects", [](const ConsumeEffectData&, ByteBuffer&) {} }, 
+    { "minecraft:teleport_randomly", [](const ConsumeEffectData& data, ByteBuffer& buffer) 
+        { buffer.writeNumeric<float>(data.m_diameter); } }, 
+    { "minecraft:play_sound", [](const ConsumeEffectData& data, ByteBuffer& buffer) { buffer.writeSoundEvent(data.m_sound); } } 
 }, {
     { "minecraft:apply_effects", [](ByteBuffer&) { return ConsumeEffectData(); } }, 
     { "minecraft:remove_effects", [](ByteBuffer& data) { ConsumeEffectData result; result.m_effectsRemove = data.readIDSet(); return result; } }, 
@@ -3219,24 +3217,19 @@ Registry<RecipeDisplayData> g_recipeDisplayRegistry = Registry<RecipeDisplayData
     { "minecraft:crafting_shapeless", 0 }, { "minecraft:crafting_shaped", 1 }, { "minecraft:furnace", 2 },
     { "minecraft:stonecutter", 3 },        { "minecraft:smithing", 4 }
 }, {
-    { "minecraft:crafting_shapeless", [](const RecipeDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:crafting_shapeless", [](const RecipeDisplayData& data, ByteBuffer& buffer) {
         buffer.writePrefixedArray<SlotDisplay>(data.m_ingredients, &ByteBuffer::writeSlotDisplay);
         buffer.writeSlotDisplay(data.m_result);
         buffer.writeSlotDisplay(data.m_craftingStation);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:crafting_shaped", [](const RecipeDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:crafting_shaped", [](const RecipeDisplayData& data, ByteBuffer& buffer) {
         buffer.writeVarNumeric<int>(data.m_width);
         buffer.writeVarNumeric<int>(data.m_height);
         buffer.writePrefixedArray<SlotDisplay>(data.m_ingredients, &ByteBuffer::writeSlotDisplay);
         buffer.writeSlotDisplay(data.m_result);
         buffer.writeSlotDisplay(data.m_craftingStation);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:furnace", [](const RecipeDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:furnace", [](const RecipeDisplayData& data, ByteBuffer& buffer) {
         if (data.m_ingredients.size() != 1) {
             buffer.writeSlotDisplay(SlotDisplay());
         } else buffer.writeSlotDisplay(data.m_ingredients[0]);
@@ -3245,19 +3238,15 @@ Registry<RecipeDisplayData> g_recipeDisplayRegistry = Registry<RecipeDisplayData
         buffer.writeSlotDisplay(data.m_craftingStation);
         buffer.writeVarNumeric<int>(data.m_cookingTime);
         buffer.writeNumeric<float>(data.m_experience);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:stonecutter", [](const RecipeDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:stonecutter", [](const RecipeDisplayData& data, ByteBuffer& buffer) {
         if (data.m_ingredients.size() != 1) {
             buffer.writeSlotDisplay(SlotDisplay());
         } else buffer.writeSlotDisplay(data.m_ingredients[0]);
         buffer.writeSlotDisplay(data.m_result);
         buffer.writeSlotDisplay(data.m_craftingStation);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:smithing", [](const RecipeDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:smithing", [](const RecipeDisplayData& data, ByteBuffer& buffer) {
         if (data.m_ingredients.size() != 3) {
             buffer.writeSlotDisplay(SlotDisplay());
             buffer.writeSlotDisplay(SlotDisplay());
@@ -3269,7 +3258,6 @@ Registry<RecipeDisplayData> g_recipeDisplayRegistry = Registry<RecipeDisplayData
         }
         buffer.writeSlotDisplay(data.m_result);
         buffer.writeSlotDisplay(data.m_craftingStation);
-        return buffer.getBytes();
     } }, 
 }, {
     { "minecraft:crafting_shapeless", [](ByteBuffer& buffer) {
@@ -3319,51 +3307,39 @@ Registry<SlotDisplayData> g_slotDisplayRegistry = Registry<SlotDisplayData>({
     { "minecraft:empty", 0 }, { "minecraft:any_fuel", 1 },      { "minecraft:item", 2 },           { "minecraft:item_stack", 3 },
     { "minecraft:tag", 4 },   { "minecraft:smithing_trim", 5 }, { "minecraft:with_remainder", 6 }, { "minecraft:composite", 7 }
 }, {
-    { "minecraft:empty", [](const SlotDisplayData&) { return ByteBuffer().getBytes(); } },
-    { "minecraft:any_fuel", [](const SlotDisplayData&) { return ByteBuffer().getBytes(); } },
-    { "minecraft:item", [](const SlotDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:empty", [](const SlotDisplayData&, ByteBuffer&) {} },
+    { "minecraft:any_fuel", [](const SlotDisplayData&, ByteBuffer&) {} },
+    { "minecraft:item", [](const SlotDisplayData& data, ByteBuffer& buffer) {
         buffer.writeVarNumeric<int>(data.m_itemType);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:item_stack", [](const SlotDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:item_stack", [](const SlotDisplayData& data, ByteBuffer& buffer) {
         buffer.writeSlot(data.m_itemStack);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:tag", [](const SlotDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:tag", [](const SlotDisplayData& data, ByteBuffer& buffer) {
         buffer.writeIdentifier(data.m_tag);
-        return buffer.getBytes();
     } }, 
-    { "minecraft:smithing_trim", [](const SlotDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:smithing_trim", [](const SlotDisplayData& data, ByteBuffer& buffer) {
         if (data.m_children.size() != 3) {
-            buffer.writeByteArray(SlotDisplay().toBytes());
-            buffer.writeByteArray(SlotDisplay().toBytes());
-            buffer.writeByteArray(SlotDisplay().toBytes());
+            buffer.writeSlotDisplay(SlotDisplay());
+            buffer.writeSlotDisplay(SlotDisplay());
+            buffer.writeSlotDisplay(SlotDisplay());
         } else {
-            buffer.writeByteArray(data.m_children[0].toBytes());
-            buffer.writeByteArray(data.m_children[1].toBytes());
-            buffer.writeByteArray(data.m_children[2].toBytes());
+            buffer.writeSlotDisplay(data.m_children[0]);
+            buffer.writeSlotDisplay(data.m_children[1]);
+            buffer.writeSlotDisplay(data.m_children[2]);
         }
-        return buffer.getBytes();
     } }, 
-    { "minecraft:with_remainder", [](const SlotDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:with_remainder", [](const SlotDisplayData& data, ByteBuffer& buffer) {
         if (data.m_children.size() != 2) {
-            buffer.writeByteArray(SlotDisplay().toBytes());
-            buffer.writeByteArray(SlotDisplay().toBytes());
+            buffer.writeSlotDisplay(SlotDisplay());
+            buffer.writeSlotDisplay(SlotDisplay());
         } else {
-            buffer.writeByteArray(data.m_children[0].toBytes());
-            buffer.writeByteArray(data.m_children[1].toBytes());
+            buffer.writeSlotDisplay(data.m_children[0]);
+            buffer.writeSlotDisplay(data.m_children[1]);
         }
-        return buffer.getBytes();
     } }, 
-    { "minecraft:composite", [](const SlotDisplayData& data) {
-        ByteBuffer buffer;
+    { "minecraft:composite", [](const SlotDisplayData& data, ByteBuffer& buffer) {
         buffer.writePrefixedArray<SlotDisplay>(data.m_children, &ByteBuffer::writeSlotDisplay);
-        return buffer.getBytes();
     } },
 }, {
     { "minecraft:empty", [](ByteBuffer&) { return SlotDisplayData(); } },
@@ -3411,5 +3387,6 @@ std::unordered_map<ZincConnection::State, std::unordered_map<std::string, std::f
     { ZincConnection::State::Config, {} },
     { ZincConnection::State::Play, {} }
 };
+std::vector<std::function<void(ZincConnection*, const bool&)>> g_zincCongestionListeners;
 
 }
\ No newline at end of file
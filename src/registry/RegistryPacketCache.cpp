@@ -0,0 +1,57 @@
+#include <registry/RegistryPacketCache.h>
+#include <registry/DefaultRegistries.h>
+#include <network/minecraft/ZincConnection.h>
+#include <ZincConfig.h>
+
+namespace zinc {
+
+RegistryPacketCache g_registryPacketCache;
+
+std::vector<size_t> RegistryPacketCache::takeSnapshot() const {
+    std::vector<size_t> snapshot;
+    snapshot.reserve(g_registries.size() + 1);
+    snapshot.push_back(g_registries.size());
+    for (const auto& registry : g_registries) snapshot.push_back(registry.second.size());
+    return snapshot;
+}
+std::shared_ptr<const std::vector<char>> RegistryPacketCache::build(const bool& isCompressed) {
+    evbuffer* output = evbuffer_new();
+    ZincPacket packet;
+    packet.setId(7);
+    for (const auto& registry : g_registries) {
+        packet.setData(getNetworkRegistry(registry.second, Identifier("minecraft:" + registry.first)));
+        m_logger.debug("Serialized minecraft:" + registry.first + " (" + std::to_string(packet.getData().size()) + ")");
+        if (!ZincConnection::writeFrame(output, packet, isCompressed)) {
+            m_logger.error("Failed to frame minecraft:" + registry.first);
+            evbuffer_free(output);
+            return nullptr;
+        }
+    }
+    std::shared_ptr<std::vector<char>> frames = std::make_shared<std::vector<char>>(evbuffer_get_length(output));
+    evbuffer_remove(output, frames->data(), frames->size());
+    evbuffer_free(output);
+    return frames;
+}
+std::shared_ptr<const std::vector<char>> RegistryPacketCache::getFrames(const bool& isCompressed) {
+    std::lock_guard lock(m_mutex);
+    std::vector<size_t> snapshot = takeSnapshot();
+    if (snapshot != m_snapshot || m_threshold != g_zincConfig.m_core.m_network.m_threshold
+     || m_compressionLevel != g_zincConfig.m_core.m_network.m_compressionLevel) {
+        m_frames[0].reset();
+        m_frames[1].reset();
+        m_snapshot = snapshot;
+        m_threshold = g_zincConfig.m_core.m_network.m_threshold;
+        m_compressionLevel = g_zincConfig.m_core.m_network.m_compressionLevel;
+    }
+    std::shared_ptr<const std::vector<char>>& frames = m_frames[isCompressed ? 1 : 0];
+    if (!frames) frames = build(isCompressed);
+    return frames;
+}
+void RegistryPacketCache::invalidate() {
+    std::lock_guard lock(m_mutex);
+    m_frames[0].reset();
+    m_frames[1].reset();
+    m_snapshot.clear();
+}
+
+}
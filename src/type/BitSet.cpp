@@ -1,5 +1,6 @@
 #include <type/BitSet.h>
 #include <util/Memory.h>
+#include <util/VarInt.h>
 
 namespace zinc {
 
@@ -116,9 +117,15 @@ bool BitSet::operator!=(const BitSet& other) const {
     return !operator==(other);
 }
 
+size_t BitSet::longCount() const {
+    if (m_highestSet == NPOS) return 0;
+    return m_highestSet / 64 + 1;
+}
+size_t BitSet::encodedSize() const {
+    return VarInt::size(zinc_safe_cast<size_t, int>(longCount())) + longCount() * sizeof(unsigned long);
+}
 std::vector<unsigned long> BitSet::toLongArray() const {
-    if (m_highestSet == NPOS) return {};
-    return std::vector<unsigned long>(m_data.begin(), m_data.begin() + zinc_safe_cast<size_t, long>(m_highestSet / 64) + 1);
+    return std::vector<unsigned long>(m_data.begin(), m_data.begin() + zinc_safe_cast<size_t, long>(longCount()));
 }
 std::vector<unsigned char> BitSet::toByteArray() const {
     if (m_highestSet == NPOS) return {};
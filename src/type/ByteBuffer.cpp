@@ -4,73 +4,154 @@
 
 namespace zinc {
 
-ByteBuffer::InternalByteBuffer::InternalByteBuffer() {
-    m_blocks.emplace_back(BLOCK_SIZE);
+Logger m_byteBufferLogger = Logger("InternalByteBuffer");
+
+// power-of-two slabs from 256 B to 64 KiB are cached per thread and handed back out on the next grow
+struct ByteBufferArena {
+    static constexpr size_t MIN_SLAB_SIZE = 256;
+    static constexpr size_t SLAB_CLASSES = 9;
+    static constexpr size_t MAX_CACHED_SLABS = 32;
+
+    std::array<std::vector<char*>, SLAB_CLASSES> m_freeSlabs;
+
+    ByteBufferArena();
+    ~ByteBufferArena();
+
+    static size_t getSlabClass(const size_t& capacity) {
+        size_t slabClass = 0;
+        while ((MIN_SLAB_SIZE << slabClass) < capacity) slabClass++;
+        return slabClass;
+    }
+    char* allocate(size_t& capacity) {
+        size_t slabClass = getSlabClass(capacity);
+        capacity = MIN_SLAB_SIZE << slabClass;
+        if (slabClass < SLAB_CLASSES && !m_freeSlabs[slabClass].empty()) {
+            char* slab = m_freeSlabs[slabClass].back();
+            m_freeSlabs[slabClass].pop_back();
+            return slab;
+        }
+        return new char[capacity];
+    }
+    void release(char* slab, const size_t& capacity);
+};
+enum class ArenaState : unsigned char { Unused, Alive, Destroyed };
+thread_local ArenaState t_arenaState = ArenaState::Unused; // buffers can outlive the arena during thread/static teardown
+thread_local ByteBufferArena t_arena;
+
+ByteBufferArena::ByteBufferArena() {
+    t_arenaState = ArenaState::Alive;
+}
+ByteBufferArena::~ByteBufferArena() {
+    t_arenaState = ArenaState::Destroyed;
+    for (std::vector<char*>& slabs : m_freeSlabs)
+        for (char* slab : slabs) delete[] slab;
+}
+void ByteBufferArena::release(char* slab, const size_t& capacity) {
+    size_t slabClass = getSlabClass(capacity);
+    if (slabClass < SLAB_CLASSES && (MIN_SLAB_SIZE << slabClass) == capacity && m_freeSlabs[slabClass].size() < MAX_CACHED_SLABS) 
+        m_freeSlabs[slabClass].push_back(slab);
+    else delete[] slab;
+}
+static char* allocateSlab(size_t& capacity) {
+    if (t_arenaState == ArenaState::Destroyed) return new char[capacity];
+    return t_arena.allocate(capacity);
+}
+static void releaseSlab(char* slab, const size_t& capacity) {
+    if (t_arenaState == ArenaState::Alive) t_arena.release(slab, capacity);
+    else delete[] slab;
+}
+
+bool ByteBuffer::InternalByteBuffer::isInline() const {
+    return m_data == m_inline.data();
+}
+void ByteBuffer::InternalByteBuffer::release() noexcept {
+    if (isInline()) return;
+    releaseSlab(m_data, m_capacity);
+    m_data = m_inline.data();
+    m_capacity = INLINE_SIZE;
+}
+ByteBuffer::InternalByteBuffer::InternalByteBuffer(InternalByteBuffer&& buffer) noexcept {
+    *this = std::move(buffer);
+}
+ByteBuffer::InternalByteBuffer& ByteBuffer::InternalByteBuffer::operator=(InternalByteBuffer&& buffer) noexcept {
+    if (this == &buffer) return *this;
+    release();
+    if (buffer.isInline()) std::copy(buffer.m_inline.begin(), buffer.m_inline.begin() + zinc_safe_cast<size_t, long>(buffer.m_writeOffset), m_inline.begin());
+    else {
+        m_data = buffer.m_data;
+        m_capacity = buffer.m_capacity;
+        buffer.m_data = buffer.m_inline.data();
+        buffer.m_capacity = INLINE_SIZE;
+    }
+    m_writeOffset = buffer.m_writeOffset;
+    m_readOffset = buffer.m_readOffset;
+    m_enableBlockRecycle = buffer.m_enableBlockRecycle;
+    m_readFailed = buffer.m_readFailed;
+    buffer.m_writeOffset = 0;
+    buffer.m_readOffset = 0;
+    return *this;
 }
 ByteBuffer::InternalByteBuffer::~InternalByteBuffer() {
-    clear();
+    release();
 }
 void ByteBuffer::InternalByteBuffer::clear() noexcept {
-    std::lock_guard lock(m_mutex);
-    m_blocks.clear();
-    m_blocks.emplace_back(BLOCK_SIZE);
-    m_writeBlock = 0;
-    m_readBlock = 0;
     m_writeOffset = 0;
     m_readOffset = 0;
+    m_readFailed = false;
+}
+void ByteBuffer::InternalByteBuffer::reserve(const size_t& capacity) {
+    if (capacity <= m_capacity) return;
+    size_t newCapacity = std::max(capacity, m_capacity * 2);
+    char* newData = allocateSlab(newCapacity);
+    std::copy(m_data, m_data + m_writeOffset, newData);
+    release();
+    m_data = newData;
+    m_capacity = newCapacity;
+}
+void ByteBuffer::InternalByteBuffer::grow(const size_t& length) {
+    if (m_enableBlockRecycle && m_readOffset) {
+        std::copy(m_data + m_readOffset, m_data + m_writeOffset, m_data);
+        m_writeOffset -= m_readOffset;
+        m_readOffset = 0;
+        if (m_writeOffset + length <= m_capacity) return;
+    }
+    reserve(m_writeOffset + length);
 }
 void ByteBuffer::InternalByteBuffer::write(const char* data, const size_t& length) {
-    std::lock_guard lock(m_mutex);
-    size_t remaining = length;
-    char *l_data = (char*) data;
-    while (remaining) {
-        const size_t spaceLeft = (BLOCK_SIZE - m_writeOffset);
-        const size_t toCopy = std::min(remaining, spaceLeft);
-        std::vector<char>& block = m_blocks[m_writeBlock];
-        std::copy(l_data, l_data + toCopy, block.data() + m_writeOffset);
-        m_writeOffset += toCopy;
-        l_data += toCopy;
-        remaining -= toCopy;
-        if (m_writeOffset == BLOCK_SIZE) {
-            m_writeBlock++;
-            m_writeOffset = 0;
-            m_blocks.emplace_back(BLOCK_SIZE);
-        }
-    }
+    if (m_writeOffset + length > m_capacity) grow(length);
+    std::copy(data, data + length, m_data + m_writeOffset);
+    m_writeOffset += length;
 }
 std::vector<char> ByteBuffer::InternalByteBuffer::read(const size_t& length) {
-    std::lock_guard lock(m_mutex);
-    std::vector<char> result;
-    result.reserve(length);
-    size_t remaining = length;
-    while (remaining) {
-        if (m_readBlock >= m_blocks.size()) {
-            m_logger.error(std::out_of_range("Not enough data to read").what());
-            return result;
-        }
-        const std::vector<char>& block = m_blocks[m_readBlock];
-        const size_t available = (BLOCK_SIZE - m_readOffset);
-        const size_t toCopy = std::min(remaining, available);
-        
-        result.insert(
-            result.end(), 
-            block.begin() + zinc_safe_cast<size_t, long>(m_readOffset), 
-            block.begin() + zinc_safe_cast<size_t, long>(m_readOffset + toCopy)
-        );
-        m_readOffset += toCopy;
-        remaining -= toCopy;
-        if (m_readOffset == BLOCK_SIZE) {
-            m_readBlock++;
-            m_readOffset = 0;
-            if (m_enableBlockRecycle) {
-                m_readBlock--;
-                if (m_writeBlock) m_writeBlock--;
-                m_blocks.pop_front();
-            }
-        }
+    size_t available = std::min(length, m_writeOffset - m_readOffset);
+    if (available < length) {
+        m_byteBufferLogger.error(std::out_of_range("Not enough data to read").what());
+        m_readFailed = true;
+    }
+    std::vector<char> result (m_data + m_readOffset, m_data + m_readOffset + available);
+    m_readOffset += available;
+    return result;
+}
+const char* ByteBuffer::InternalByteBuffer::consume(const size_t& length) {
+    if (m_writeOffset - m_readOffset < length) {
+        m_byteBufferLogger.error(std::out_of_range("Not enough data to read").what());
+        m_readOffset = m_writeOffset;
+        m_readFailed = true;
+        return nullptr;
     }
+    const char* result = m_data + m_readOffset;
+    m_readOffset += length;
     return result;
 }
+char* ByteBuffer::InternalByteBuffer::data() {
+    return m_data;
+}
+const char* ByteBuffer::InternalByteBuffer::data() const {
+    return m_data;
+}
+size_t ByteBuffer::InternalByteBuffer::capacity() const {
+    return m_capacity;
+}
 bool& ByteBuffer::InternalByteBuffer::areBlocksRecycled() {
     return m_enableBlockRecycle;
 }
@@ -81,46 +162,31 @@ void ByteBuffer::InternalByteBuffer::toggleBlockRecycle(const bool& state) {
     m_enableBlockRecycle = state;
 }
 std::vector<char> ByteBuffer::InternalByteBuffer::getBytes() const {
-    std::vector<char> result;
-    size_t totalSize = 0;
-    for (size_t i = 0; i < m_blocks.size(); ++i) {
-        if (i < m_writeBlock) {
-            totalSize += BLOCK_SIZE;
-        } else if (i == m_writeBlock) {
-            totalSize += m_writeOffset;
-        }
-    }
-    result.reserve(totalSize);
-    for (size_t i = 0; i < m_blocks.size(); ++i) {
-        if (i < m_writeBlock) {
-            result.insert(result.end(), m_blocks[i].begin(), m_blocks[i].end());
-        } else if (i == m_writeBlock) {
-            result.insert(result.end(), m_blocks[i].begin(), m_blocks[i].begin() + zinc_safe_cast<size_t, long>(m_writeOffset));
-            break;
-        } else {
-            break;
-        }
-    }
-    result.shrink_to_fit();
-    return result;
+    return std::vector<char>(m_data, m_data + m_writeOffset);
+}
+bool ByteBuffer::InternalByteBuffer::hasReadFailed() const {
+    return m_readFailed;
 }
-std::pair<size_t, size_t> ByteBuffer::InternalByteBuffer::getReader() const {
-    return std::make_pair(m_readBlock, m_readOffset);
+size_t ByteBuffer::InternalByteBuffer::getReader() const {
+    return m_readOffset;
 }
-std::pair<size_t, size_t> ByteBuffer::InternalByteBuffer::getWriter() const {
-    return std::make_pair(m_writeBlock, m_writeOffset);
+size_t ByteBuffer::InternalByteBuffer::getWriter() const {
+    return m_writeOffset;
 }
-void ByteBuffer::InternalByteBuffer::setReader(const std::pair<size_t, size_t>& reader) {
-    m_readBlock = reader.first;
-    m_readOffset = reader.second;
+void ByteBuffer::InternalByteBuffer::setReader(const size_t& reader) {
+    m_readOffset = std::min(reader, m_writeOffset);
 }
-void ByteBuffer::InternalByteBuffer::setWriter(const std::pair<size_t, size_t>& writer) {
-    m_writeBlock = writer.first;
-    m_writeOffset = writer.second;
+void ByteBuffer::InternalByteBuffer::setWriter(const size_t& writer) {
+    reserve(writer);
+    m_writeOffset = writer;
+    m_readOffset = std::min(m_readOffset, m_writeOffset);
+}
+void ByteBuffer::InternalByteBuffer::setReadFailed(const bool& readFailed) {
+    m_readFailed = readFailed;
 }
 bool ByteBuffer::InternalByteBuffer::operator==(const InternalByteBuffer& buffer) const {
-    return getReader() == buffer.getReader() && getWriter() == buffer.getWriter() && getBytes() == buffer.getBytes() 
-        && areBlocksRecycled() == buffer.areBlocksRecycled();
+    return getReader() == buffer.getReader() && getWriter() == buffer.getWriter() 
+        && std::equal(m_data, m_data + m_writeOffset, buffer.data()) && areBlocksRecycled() == buffer.areBlocksRecycled();
 }
 bool ByteBuffer::InternalByteBuffer::operator!=(const InternalByteBuffer& buffer) const {
     return !operator==(buffer);
@@ -134,27 +200,59 @@ std::vector<char> ByteBuffer::getBytes() const {
     return m_internalBuffer.getBytes();
 }
 size_t ByteBuffer::size() const {
-    std::pair<size_t, size_t> writer = m_internalBuffer.getWriter();
-    return (writer.first * InternalByteBuffer::BLOCK_SIZE) + writer.second;
+    return m_internalBuffer.getWriter();
 }
 size_t ByteBuffer::getReaderPointer() const {
-    std::pair<size_t, size_t> reader = m_internalBuffer.getReader();
-    return (reader.first * InternalByteBuffer::BLOCK_SIZE) + reader.second;
+    return m_internalBuffer.getReader();
+}
+char* ByteBuffer::data() {
+    return m_internalBuffer.data();
+}
+const char* ByteBuffer::data() const {
+    return m_internalBuffer.data();
+}
+std::span<const char> ByteBuffer::getSpan() const {
+    return std::span<const char>(m_internalBuffer.data(), m_internalBuffer.getWriter());
 }
 
 void ByteBuffer::writeBytes(const std::vector<char>& bytes) {
     m_internalBuffer.write(bytes.data(), bytes.size());
 }
+void ByteBuffer::writeBytes(std::span<const char> bytes) {
+    m_internalBuffer.write(bytes.data(), bytes.size());
+}
+void ByteBuffer::reserveWrite(const size_t& length) {
+    m_internalBuffer.reserve(m_internalBuffer.getWriter() + length);
+}
 std::vector<char> ByteBuffer::readBytes(const size_t& length) {
     return m_internalBuffer.read(length);
 }
 
+bool ByteBuffer::readInto(std::span<char> out) {
+    const char* bytes = m_internalBuffer.consume(out.size());
+    if (!bytes) return false;
+    std::copy(bytes, bytes + out.size(), out.begin());
+    return true;
+}
+std::span<const char> ByteBuffer::readSpan(const size_t& length) {
+    const char* bytes = m_internalBuffer.consume(length);
+    if (!bytes) return {};
+    return std::span<const char>(bytes, length);
+}
+std::string_view ByteBuffer::readStringView() {
+    std::span<const char> bytes = readSpan(zinc_safe_cast<int, size_t>(readVarNumeric<int>()));
+    return std::string_view(bytes.data(), bytes.size());
+}
+bool ByteBuffer::hasReadFailed() const {
+    return m_internalBuffer.hasReadFailed();
+}
+
 void ByteBuffer::writeByte(const char& c) {
     m_internalBuffer.write(&c, 1);
 }
 char ByteBuffer::readByte() {
-    std::vector<char> readBytes = m_internalBuffer.read(1);
-    return readBytes[0];
+    const char* byte = m_internalBuffer.consume(1);
+    return byte ? *byte : 0;
 }
 void ByteBuffer::writeUnsignedByte(const unsigned char& c) {
     writeByte((const char&)c);
@@ -165,17 +263,22 @@ unsigned char ByteBuffer::readUnsignedByte() {
 
 void ByteBuffer::writeString(const std::string& value) {
     writeVarNumeric<int>(zinc_safe_cast<size_t, int>(value.size()));
-    writeBytes(std::vector<char>(value.begin(), value.end()));
+    m_internalBuffer.write(value.data(), value.size());
 }
 std::string ByteBuffer::readString() {
-    std::vector<char> bytes = readBytes(zinc_safe_cast<int, size_t>(readVarNumeric<int>()));
-    return std::string(bytes.begin(), bytes.end());
+    return std::string(readStringView());
 }
 void ByteBuffer::writeIdentifier(const Identifier& value) {
     writeString(value.toString());
 }
 Identifier ByteBuffer::readIdentifier() {
-    return Identifier(readString());
+    std::string_view value = readStringView();
+    size_t separator = value.find(':');
+    if (separator == std::string_view::npos) {
+        m_internalBuffer.setReadFailed(true);
+        return Identifier();
+    }
+    return Identifier(std::string(value.substr(0, separator)), std::string(value.substr(separator + 1)));
 }
 
 void ByteBuffer::writePosition(const Vector3i& value) {
@@ -200,12 +303,12 @@ float ByteBuffer::readAngle() {
 }
 
 void ByteBuffer::writeUUID(const uuids::uuid& uuid) {
-    for (const std::byte& c : uuid.as_bytes()) writeUnsignedByte((unsigned char) c);
+    m_internalBuffer.write((const char*) uuid.as_bytes().data(), 16);
 }
 uuids::uuid ByteBuffer::readUUID() {
-    std::vector<char> bytes = readBytes(16);
-    std::array<unsigned char, 16> bytesArr;
-    std::copy(bytes.begin(), bytes.end(), bytesArr.begin());
+    const char* bytes = m_internalBuffer.consume(16);
+    std::array<unsigned char, 16> bytesArr {};
+    if (bytes) std::copy(bytes, bytes + 16, bytesArr.begin());
     return uuids::uuid(bytesArr);
 }
 
@@ -223,15 +326,49 @@ std::vector<char> ByteBuffer::readPrefixedByteArray() {
     return readBytes(zinc_safe_cast<int, size_t>(readVarNumeric<int>()));
 }
 
+void ByteBuffer::writeVarIntArray(std::span<const int> values) {
+    // encoded straight into the tail, the writer only moves past what was actually written
+    const size_t writer = m_internalBuffer.getWriter();
+    m_internalBuffer.reserve(writer + values.size() * varNumericMaxSize<int>());
+    m_internalBuffer.setWriter(writer + VarInt::encodeArray(m_internalBuffer.data() + writer, values));
+}
+std::vector<int> ByteBuffer::readVarIntArray(const size_t& count) {
+    const size_t reader = m_internalBuffer.getReader(), available = m_internalBuffer.getWriter() - reader;
+    // every VarInt takes at least one byte, a larger count can only come from a malformed or hostile length
+    if (count > available) {
+        m_logger.error("Not enough data to read VarInt array");
+        m_internalBuffer.setReadFailed(true);
+        m_internalBuffer.setReader(m_internalBuffer.getWriter());
+        return {};
+    }
+    std::vector<int> result (count);
+    const long length = VarInt::decodeArray(m_internalBuffer.data() + reader, available, result);
+    if (length < 0) {
+        m_logger.error("Malformed VarInt array");
+        m_internalBuffer.setReadFailed(true);
+        m_internalBuffer.setReader(m_internalBuffer.getWriter());
+        return {};
+    }
+    m_internalBuffer.setReader(reader + zinc_safe_cast<long, size_t>(length));
+    return result;
+}
+void ByteBuffer::writePrefixedVarIntArray(std::span<const int> values) {
+    writeVarNumeric<int>(zinc_safe_cast<size_t, int>(values.size()));
+    writeVarIntArray(values);
+}
+std::vector<int> ByteBuffer::readPrefixedVarIntArray() {
+    return readVarIntArray(zinc_safe_cast<int, size_t>(readVarNumeric<int>()));
+}
+
 void ByteBuffer::writeIDSet(const IDSet& idSet) {
     writeVarNumeric<int>(idSet.getType());
     if (!idSet.getType()) writeIdentifier(idSet.getIdentifier());
-    else writeArray<int>(idSet.getIDs(), &ByteBuffer::writeVarNumeric<int>);
+    else writeVarIntArray(idSet.getIDs());
 }
 IDSet ByteBuffer::readIDSet() {
     IDSet result;
     result.setType(readVarNumeric<int>());
-    if (result.getType()) result.setIDs(readArray<int>(&ByteBuffer::readVarNumeric<int>, zinc_safe_cast<int, size_t>(result.getType() - 1)));
+    if (result.getType()) result.setIDs(readVarIntArray(zinc_safe_cast<int, size_t>(result.getType() - 1)));
     else result.setIdentifier(readIdentifier());
     return result;
 }
@@ -287,16 +424,16 @@ SoundEvent ByteBuffer::readSoundEvent() {
 }
 
 void ByteBuffer::writeBitSet(const BitSet& bitSet) {
-    writePrefixedArray<unsigned long>(bitSet.toLongArray(), &ByteBuffer::writeNumeric<unsigned long>);
+    writePrefixedNumericArray<unsigned long>(std::span<const unsigned long>(bitSet.m_data.data(), bitSet.longCount()));
 }
 BitSet ByteBuffer::readBitSet() {
-    return BitSet::fromLongArray(readPrefixedArray<unsigned long>(&ByteBuffer::readNumeric<unsigned long>));
+    return BitSet::fromLongArray(readPrefixedNumericArray<unsigned long>());
 }
 void ByteBuffer::writeFixedBitSet(const BitSet& bitSet) {
-    writeArray<unsigned char>(bitSet.toByteArray(), &ByteBuffer::writeUnsignedByte);
+    writeNumericArray<unsigned char>(bitSet.toByteArray());
 }
 BitSet ByteBuffer::readFixedBitSet(const size_t& length) {
-    return BitSet::fromByteArray(readArray<unsigned char>(&ByteBuffer::readUnsignedByte, length));
+    return BitSet::fromByteArray(readNumericArray<unsigned char>(length));
 }
 
 void ByteBuffer::writeTeleportFlags(const TeleportFlags& teleportFlags) {
@@ -307,11 +444,10 @@ TeleportFlags ByteBuffer::readTeleportFlags() {
 }
 
 void ByteBuffer::writeNBTElement(const NBTElement& nbtElement) {
-    NBTElement element = nbtElement;
     NBTSettings settings;
     settings.m_isNetwork = true;
-    element.m_settings = settings;
-    element.encode(*this);
+    reserveWrite(nbtElement.encodedSize(m_isBigEndian, settings));
+    nbtElement.encode(*this, settings);
 }
 NBTElement ByteBuffer::readNBTElement() {
     NBTSettings settings;
@@ -332,37 +468,38 @@ void ByteBuffer::writeChatType(const ChatType& chatType) {
     writeString(chatType.m_chat.m_translationKey);
     std::vector<int> paramInt;
     for (const auto& param : chatType.m_chat.m_parameters) paramInt.push_back((int) param);
-    writePrefixedArray<int>(paramInt, &ByteBuffer::writeVarNumeric<int>);
+    writePrefixedVarIntArray(paramInt);
     writeNBTElement(chatType.m_chat.m_style);
     writeString(chatType.m_narration.m_translationKey);
     paramInt = {};
     for (const auto& param : chatType.m_chat.m_parameters) paramInt.push_back((int) param);
-    writePrefixedArray<int>(paramInt, &ByteBuffer::writeVarNumeric<int>);
+    writePrefixedVarIntArray(paramInt);
     writeNBTElement(chatType.m_narration.m_style);
 }
 ChatType ByteBuffer::readChatType() {
     ChatType chatType;
     chatType.m_chat.m_translationKey = readString();
     std::vector<int> paramInt;
-    paramInt = readPrefixedArray<int>(&ByteBuffer::readVarNumeric<int>);
+    paramInt = readPrefixedVarIntArray();
     for (const int& param : paramInt) chatType.m_chat.m_parameters.push_back((ChatTypeDecoration::Parameter) param);
     chatType.m_chat.m_style = readNBTElement();
     chatType.m_narration.m_translationKey = readString();
-    paramInt = readPrefixedArray<int>(&ByteBuffer::readVarNumeric<int>);
+    paramInt = readPrefixedVarIntArray();
     for (const int& param : paramInt) chatType.m_narration.m_parameters.push_back((ChatTypeDecoration::Parameter) param);
     chatType.m_narration.m_style = readNBTElement();
     return chatType;
 }
 
 void ByteBuffer::writeSlot(const Slot& slot) {
-    writeByteArray(slot.toBytes());
+    reserveWrite(slot.encodedSize());
+    slot.encode(*this);
 }
 void ByteBuffer::writeHashedSlot(const Slot& slot) {
-    writeByteArray(slot.toBytesHashed());
+    slot.encodeHashed(*this);
 }
 
 void ByteBuffer::writeSlotDisplay(const SlotDisplay& display) {
-    writeByteArray(display.toBytes());
+    display.encode(*this);
 }
 SlotDisplay ByteBuffer::readSlotDisplay() {
     SlotDisplay display;
@@ -377,7 +514,7 @@ SlotDisplay ByteBuffer::readSlotDisplay() {
 }
 
 void ByteBuffer::writeRecipeDisplay(const RecipeDisplay& display) {
-    writeByteArray(display.toBytes());
+    display.encode(*this);
 }
 RecipeDisplay ByteBuffer::readRecipeDisplay() {
     RecipeDisplay display;
@@ -426,8 +563,8 @@ void ByteBuffer::writeFireworkExplosion(const FireworkExplosion& fireworkExplosi
 FireworkExplosion ByteBuffer::readFireworkExplosion() {
     FireworkExplosion fireworkExplosion;
     fireworkExplosion.m_shape = g_fireworkExplosionShapesRegistry.getIdentifierFromValue(readVarNumeric<int>());
-    fireworkExplosion.m_colors = readPrefixedArray<int>(&ByteBuffer::readNumeric<int>);
-    fireworkExplosion.m_fadeColors = readPrefixedArray<int>(&ByteBuffer::readNumeric<int>);
+    fireworkExplosion.m_colors = readPrefixedNumericArray<int>();
+    fireworkExplosion.m_fadeColors = readPrefixedNumericArray<int>();
     fireworkExplosion.m_hasTrail = readByte();
     fireworkExplosion.m_hasTwinkle = readByte();
     return fireworkExplosion;
@@ -531,7 +668,8 @@ void ByteBuffer::writeBlockPredicate(const BlockPredicate& predicate) {
 }
 
 void ByteBuffer::writeLightData(const LightData& data) {
-    writeByteArray(data.toBytes());
+    reserveWrite(data.encodedSize());
+    data.encode(*this);
 }
 LightData ByteBuffer::readLightData() {
     LightData data;
@@ -548,7 +686,7 @@ void ByteBuffer::writeChunkData(const ChunkData& data) {
     writeVarNumeric<int>(zinc_safe_cast<size_t, int>(data.m_heightMaps.size()));
     for (const ChunkDataHeightMap& heightMap : data.m_heightMaps) {
         writeVarNumeric<int>(heightMap.m_type);
-        writePrefixedArray<long>(heightMap.m_data, &ByteBuffer::writeNumeric<long>);
+        writePrefixedNumericArray<long>(heightMap.m_data);
     }
     writePrefixedByteArray(data.m_data);
     writeVarNumeric<int>(zinc_safe_cast<size_t, int>(data.m_blockEntities.size()));
@@ -565,7 +703,7 @@ ChunkData ByteBuffer::readChunkData() {
     for (int i = 0; i < heightMapsLength; i++) {
         ChunkDataHeightMap heightMap;
         heightMap.m_type = readVarNumeric<int>();
-        heightMap.m_data = readPrefixedArray<long>(&ByteBuffer::readNumeric<long>);
+        heightMap.m_data = readPrefixedNumericArray<long>();
         data.m_heightMaps.push_back(heightMap);
     }
     data.m_data = readPrefixedByteArray();
@@ -41,8 +41,8 @@ std::vector<char> FireworkExplosion::toBytes() const {
     if (g_fireworkExplosionShapesRegistry.m_registryData.contains(m_shape.toString())) 
         buffer.writeVarNumeric<int>(g_fireworkExplosionShapesRegistry.m_registryData[m_shape.toString()]);
     else buffer.writeVarNumeric<int>(0);
-    buffer.writePrefixedArray<int>(m_colors, &ByteBuffer::writeNumeric<int>);
-    buffer.writePrefixedArray<int>(m_fadeColors, &ByteBuffer::writeNumeric<int>);
+    buffer.writePrefixedNumericArray<int>(m_colors);
+    buffer.writePrefixedNumericArray<int>(m_fadeColors);
     buffer.writeByte(m_hasTrail);
     buffer.writeByte(m_hasTwinkle);
     return buffer.getBytes();
@@ -129,7 +129,7 @@ std::vector<char> ConsumeEffect::toBytes() const {
     args.m_probability = m_probability;
     args.m_diameter = m_diameter;
     buffer.writeVarNumeric<int>(g_consumeEffectRegistry.m_registryData[m_type.toString()]);
-    buffer.writeByteArray(g_consumeEffectRegistry.m_writers[m_type.toString()](args));
+    g_consumeEffectRegistry.m_writers[m_type.toString()](args, buffer);
     return buffer.getBytes();
 }
 bool ConsumeEffect::operator==(const ConsumeEffect& effect) const {
@@ -1,17 +1,30 @@
 #include <type/LightData.h>
 #include <type/ByteBuffer.h>
+#include <util/VarInt.h>
 
 namespace zinc {
 
 std::vector<char> LightData::toBytes() const {
     ByteBuffer buffer;
+    buffer.reserveWrite(encodedSize());
+    encode(buffer);
+    return buffer.getBytes();
+}
+size_t LightData::encodedSize() const {
+    size_t size = m_skyLightMask.encodedSize() + m_blockLightMask.encodedSize() + m_emptySkyLightMask.encodedSize() + m_emptyBlockLightMask.encodedSize();
+    for (const auto* arrays : { &m_skyLightArrays, &m_blockLightArrays }) {
+        size += VarInt::size(zinc_safe_cast<size_t, int>(arrays->size()));
+        for (const std::vector<char>& array : *arrays) size += VarInt::size(zinc_safe_cast<size_t, int>(array.size())) + array.size();
+    }
+    return size;
+}
+void LightData::encode(ByteBuffer& buffer) const {
     buffer.writeBitSet(m_skyLightMask);
     buffer.writeBitSet(m_blockLightMask);
     buffer.writeBitSet(m_emptySkyLightMask);
     buffer.writeBitSet(m_emptyBlockLightMask);
     buffer.writePrefixedArray<std::vector<char>>(m_skyLightArrays, &ByteBuffer::writePrefixedByteArray);
     buffer.writePrefixedArray<std::vector<char>>(m_blockLightArrays, &ByteBuffer::writePrefixedByteArray);
-    return buffer.getBytes();
 }
 bool LightData::operator==(const LightData& data) const {
     return data.toBytes() == toBytes();
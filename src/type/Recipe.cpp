@@ -6,6 +6,10 @@ namespace zinc {
 
 std::vector<char> SlotDisplay::toBytes() const {
     ByteBuffer buffer;
+    encode(buffer);
+    return buffer.getBytes();
+}
+void SlotDisplay::encode(ByteBuffer& buffer) const {
     buffer.writeVarNumeric<int>(g_slotDisplayRegistry.m_registryData[m_type.toString()]);
     SlotDisplayData data;
     data.m_itemType = m_itemType;
@@ -13,8 +17,7 @@ std::vector<char> SlotDisplay::toBytes() const {
     data.m_tag = m_tag;
     data.m_children = m_children;
     data.m_customData = m_customData;
-    buffer.writeByteArray(g_slotDisplayRegistry.m_writers[m_type.toString()](data));
-    return buffer.getBytes();
+    g_slotDisplayRegistry.m_writers[m_type.toString()](data, buffer);
 }
 bool SlotDisplay::operator==(const SlotDisplay& slotDisplay) const {
     return slotDisplay.toBytes() == toBytes();
@@ -25,6 +28,10 @@ bool SlotDisplay::operator!=(const SlotDisplay& slotDisplay) const {
 
 std::vector<char> RecipeDisplay::toBytes() const {
     ByteBuffer buffer;
+    encode(buffer);
+    return buffer.getBytes();
+}
+void RecipeDisplay::encode(ByteBuffer& buffer) const {
     RecipeDisplayData data;
     data.m_width = m_width;
     data.m_height = m_height;
@@ -36,8 +43,7 @@ std::vector<char> RecipeDisplay::toBytes() const {
     data.m_experience = m_experience;
     data.m_customData = m_customData;
     buffer.writeVarNumeric<int>(g_recipeDisplayRegistry.m_registryData[m_type.toString()]);
-    buffer.writeByteArray(g_recipeDisplayRegistry.m_writers[m_type.toString()](data));
-    return buffer.getBytes();
+    g_recipeDisplayRegistry.m_writers[m_type.toString()](data, buffer);
 }
 bool RecipeDisplay::operator==(const RecipeDisplay& recipeDisplay) const {
     return toBytes() == recipeDisplay.toBytes();
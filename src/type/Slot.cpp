@@ -1,6 +1,7 @@
 #include <type/Slot.h>
 #include <util/crypto/CRC32.h>
 #include <type/ByteBuffer.h>
+#include <util/VarInt.h>
 
 namespace zinc {
 
@@ -13,6 +14,27 @@ bool ComponentWrapper::operator!=(const ComponentWrapper& component) const {
 
 std::vector<char> Slot::toBytes() const {
     ByteBuffer buffer;
+    buffer.reserveWrite(encodedSize());
+    encode(buffer);
+    return buffer.getBytes();
+}
+std::vector<char> Slot::toBytesHashed() const {
+    ByteBuffer buffer;
+    encodeHashed(buffer);
+    return buffer.getBytes();
+}
+size_t Slot::encodedSize() const {
+    size_t size = VarInt::size(m_itemCount);
+    if (m_itemCount > 0) {
+        size += VarInt::size(m_itemId);
+        size += VarInt::size(zinc_safe_cast<size_t, int>(m_componentsToAdd.size()));
+        size += VarInt::size(zinc_safe_cast<size_t, int>(m_componentsToRemove.size()));
+        for (const ComponentWrapper& component : m_componentsToAdd) size += component.m_dataAndType.size();
+        for (const int& component : m_componentsToRemove) size += VarInt::size(component);
+    }
+    return size;
+}
+void Slot::encode(ByteBuffer& buffer) const {
     buffer.writeVarNumeric<int>(m_itemCount);
     if (m_itemCount > 0) {
         buffer.writeVarNumeric<int>(m_itemId);
@@ -21,12 +43,10 @@ std::vector<char> Slot::toBytes() const {
         for (const ComponentWrapper& component : m_componentsToAdd) {
             buffer.writeByteArray(component.m_dataAndType);
         }
-        for (const int& component : m_componentsToRemove) buffer.writeVarNumeric<int>(component);
+        buffer.writeVarIntArray(m_componentsToRemove);
     }
-    return buffer.getBytes();
 }
-std::vector<char> Slot::toBytesHashed() const {
-    ByteBuffer buffer;
+void Slot::encodeHashed(ByteBuffer& buffer) const {
     buffer.writeByte(m_itemCount > 0);
     if (m_itemCount > 0) {
         buffer.writeVarNumeric<int>(m_itemId);
@@ -37,9 +57,8 @@ std::vector<char> Slot::toBytesHashed() const {
             buffer.writeNumeric<unsigned>(crc32((unsigned char*) component.m_dataAndType.data(), component.m_dataAndType.size()));
         }
         buffer.writeVarNumeric<int>(zinc_safe_cast<size_t, int>(m_componentsToRemove.size()));
-        for (const int& component : m_componentsToRemove) buffer.writeVarNumeric<int>(component);
+        buffer.writeVarIntArray(m_componentsToRemove);
     }
-    return buffer.getBytes();
 }
 bool Slot::operator==(const Slot& slot) const {
     return slot.m_itemId == m_itemId && slot.m_itemCount == m_itemCount && slot.m_componentsToAdd == m_componentsToAdd && 
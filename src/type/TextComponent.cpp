@@ -251,6 +251,11 @@ void TextComponent::encodeJSON(ByteBuffer& buffer) const {
 void TextComponent::encode(ByteBuffer& buffer) const {
     buffer.writeNBTElement(encode());
 }
+size_t TextComponent::encodedSize(const bool& isBigEndian) const {
+    NBTSettings settings;
+    settings.m_isNetwork = true;
+    return encode().encodedSize(isBigEndian, settings);
+}
 void TextComponent::decode(ByteBuffer& buffer) {
     decode(buffer.readNBTElement());
 }
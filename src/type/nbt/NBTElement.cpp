@@ -12,19 +12,23 @@ std::vector<char> NBTElement::encode() const {
     return buffer.getBytes();
 }
 void NBTElement::encode(ByteBuffer& byteBuffer) const {
+    encode(byteBuffer, m_settings);
+}
+// settings are passed down instead of copied into every child, so nested elements are encoded without copying the tree
+void NBTElement::encode(ByteBuffer& byteBuffer, const NBTSettings& settings) const {
     NBTElementType type = m_type;
-    if (m_settings.m_type != NBTElementType::End) type = m_settings.m_type;
-    if (!m_settings.m_isInArray) byteBuffer.writeByte((char) type);
-    if (type != NBTElementType::End && !m_settings.m_isInArray) {
+    if (settings.m_type != NBTElementType::End) type = settings.m_type;
+    if (!settings.m_isInArray) byteBuffer.writeByte((char) type);
+    if (type != NBTElementType::End && !settings.m_isInArray) {
         if (!byteBuffer.m_isBigEndian) {
-            if (!m_settings.m_isNetwork) {
+            if (!settings.m_isNetwork) {
                 byteBuffer.writeNumeric<unsigned short>(zinc_safe_cast<size_t, uint16_t>(m_tag.size()));
-                byteBuffer.writeBytes(std::vector<char>(m_tag.begin(), m_tag.end()));
+                byteBuffer.writeBytes(std::span<const char>(m_tag));
             } else byteBuffer.writeString(m_tag);
         } else {
-            if (!(m_tag.empty() && m_settings.m_isNetwork)) {
+            if (!(m_tag.empty() && settings.m_isNetwork)) {
                 byteBuffer.writeNumeric<unsigned short>(zinc_safe_cast<size_t, uint16_t>(m_tag.size()));
-                byteBuffer.writeBytes(std::vector<char>(m_tag.begin(), m_tag.end()));
+                byteBuffer.writeBytes(std::span<const char>(m_tag));
             }
         }
     }
@@ -40,7 +44,7 @@ void NBTElement::encode(ByteBuffer& byteBuffer) const {
     case NBTElementType::Int: {
         if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<int>(m_intValue);
         else {
-            if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(m_intValue);
+            if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(m_intValue);
             else byteBuffer.writeNumeric<int>(m_intValue);
         }
         break;
@@ -48,7 +52,7 @@ void NBTElement::encode(ByteBuffer& byteBuffer) const {
     case NBTElementType::Long: {
         if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<long>(m_longValue);
         else {
-            if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<long>(m_longValue);
+            if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<long>(m_longValue);
             else byteBuffer.writeNumeric<long>(m_longValue);
         }
         break;
@@ -64,7 +68,7 @@ void NBTElement::encode(ByteBuffer& byteBuffer) const {
     case NBTElementType::ByteArray: {
         if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_byteArrayValue.size()));
         else {
-            if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_byteArrayValue.size()));
+            if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_byteArrayValue.size()));
             else byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_byteArrayValue.size()));
         }
         byteBuffer.writeByteArray(m_byteArrayValue);
@@ -73,19 +77,19 @@ void NBTElement::encode(ByteBuffer& byteBuffer) const {
     case NBTElementType::IntArray: {
         if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_intArrayValue.size()));
         else {
-            if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_intArrayValue.size()));
+            if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_intArrayValue.size()));
             else byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_intArrayValue.size()));
         }
-        byteBuffer.writeArray<int>(m_intArrayValue, &ByteBuffer::writeNumeric<int>);
+        byteBuffer.writeNumericArray<int>(m_intArrayValue);
         break;
     }
     case NBTElementType::LongArray: {
         if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_longArrayValue.size()));
         else {
-            if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_longArrayValue.size()));
+            if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_longArrayValue.size()));
             else byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_longArrayValue.size()));
         }
-        byteBuffer.writeArray<long>(m_longArrayValue, &ByteBuffer::writeNumeric<long>);
+        byteBuffer.writeNumericArray<long>(m_longArrayValue);
         break;
     }
     case NBTElementType::List: {
@@ -93,7 +97,7 @@ void NBTElement::encode(ByteBuffer& byteBuffer) const {
             byteBuffer.writeByte(0);
             if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<unsigned int>(0);
             else {
-                if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(0);
+                if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(0);
                 else byteBuffer.writeNumeric<unsigned int>(0);
             }
         } else {
@@ -103,70 +107,114 @@ void NBTElement::encode(ByteBuffer& byteBuffer) const {
                 byteBuffer.writeByte(0);
                 if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<unsigned int>(0);
                 else {
-                    if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(0);
+                    if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(0);
                     else byteBuffer.writeNumeric<unsigned int>(0);
                 }
                 return;
             }
-            NBTSettings settings = m_settings;
-            settings.m_type = elementType;
-            settings.m_isInArray = true;
-            settings.m_isNetwork = false;
+            NBTSettings elementSettings = settings;
+            elementSettings.m_type = elementType;
+            elementSettings.m_isInArray = true;
+            elementSettings.m_isNetwork = false;
             byteBuffer.writeByte((char) elementType);
             if (byteBuffer.m_isBigEndian) byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_childElements.size()));
             else {
-                if (m_settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_childElements.size()));
+                if (settings.m_isNetwork) byteBuffer.writeZigZagVarNumeric<int>(zinc_safe_cast<size_t, int>(m_childElements.size()));
                 else byteBuffer.writeNumeric<unsigned int>(zinc_safe_cast<size_t, unsigned>(m_childElements.size()));
             }
-            for (const NBTElement& element : m_childElements) {
-                NBTElement arrayElement = element;
-                arrayElement.m_settings = settings;
-                arrayElement.encode(byteBuffer);
-            }
+            for (const NBTElement& element : m_childElements) element.encode(byteBuffer, elementSettings);
         }
         break;
     }
     case NBTElementType::String: {
         if (byteBuffer.m_isBigEndian) {
             byteBuffer.writeNumeric<unsigned short>(zinc_safe_cast<size_t, uint16_t>(m_stringValue.size()));
-            byteBuffer.writeBytes(std::vector<char>(m_stringValue.begin(), m_stringValue.end()));
+            byteBuffer.writeBytes(std::span<const char>(m_stringValue));
         } else {
-            if (!m_settings.m_isNetwork) {
+            if (!settings.m_isNetwork) {
                 byteBuffer.writeNumeric<unsigned short>(zinc_safe_cast<size_t, uint16_t>(m_stringValue.size()));
-                byteBuffer.writeBytes(std::vector<char>(m_stringValue.begin(), m_stringValue.end()));
+                byteBuffer.writeBytes(std::span<const char>(m_stringValue));
             } else byteBuffer.writeString(m_stringValue);
         }
         break;
     }
     case NBTElementType::Compound: {
-        NBTSettings settings;
-        settings.m_type = NBTElementType::End;
-        settings.m_isInArray = false;
-        settings.m_isNetwork = false;
-        for (const NBTElement& element : m_childElements) {
-            NBTElement childElement = element;
-            childElement.m_settings = settings;
-            childElement.encode(byteBuffer);
-        }
+        for (const NBTElement& element : m_childElements) element.encode(byteBuffer, NBTSettings());
         byteBuffer.writeByte(0);
         break;
     }
     default: break;
     }
 }
+size_t NBTElement::encodedSize(const bool& isBigEndian) const {
+    return encodedSize(isBigEndian, m_settings);
+}
+// mirrors encode(byteBuffer, settings) branch for branch
+size_t NBTElement::encodedSize(const bool& isBigEndian, const NBTSettings& settings) const {
+    NBTElementType type = m_type;
+    if (settings.m_type != NBTElementType::End) type = settings.m_type;
+    // array and list lengths: 4 bytes, or a ZigZag VarInt for little endian network NBT
+    auto lengthSize = [&](const size_t& length) {
+        if (isBigEndian || !settings.m_isNetwork) return sizeof(unsigned int);
+        return ByteBuffer::getZigZagVarNumericLength<int>(zinc_safe_cast<size_t, int>(length));
+    };
+    auto stringSize = [&](const std::string& value) {
+        if (isBigEndian || !settings.m_isNetwork) return sizeof(unsigned short) + value.size();
+        return ByteBuffer::getVarNumericLength<int>(zinc_safe_cast<size_t, int>(value.size())) + value.size();
+    };
+    size_t size = 0;
+    if (!settings.m_isInArray) size++;
+    if (type != NBTElementType::End && !settings.m_isInArray && !(isBigEndian && m_tag.empty() && settings.m_isNetwork)) size += stringSize(m_tag);
+    switch (type) {
+    case NBTElementType::Byte: return size + 1;
+    case NBTElementType::Short: return size + sizeof(short);
+    case NBTElementType::Int: {
+        if (!isBigEndian && settings.m_isNetwork) return size + ByteBuffer::getZigZagVarNumericLength<int>(m_intValue);
+        return size + sizeof(int);
+    }
+    case NBTElementType::Long: {
+        if (!isBigEndian && settings.m_isNetwork) return size + ByteBuffer::getZigZagVarNumericLength<long>(m_longValue);
+        return size + sizeof(long);
+    }
+    case NBTElementType::Float: return size + sizeof(float);
+    case NBTElementType::Double: return size + sizeof(double);
+    case NBTElementType::ByteArray: return size + lengthSize(m_byteArrayValue.size()) + m_byteArrayValue.size();
+    case NBTElementType::IntArray: return size + lengthSize(m_intArrayValue.size()) + m_intArrayValue.size() * sizeof(int);
+    case NBTElementType::LongArray: return size + lengthSize(m_longArrayValue.size()) + m_longArrayValue.size() * sizeof(long);
+    case NBTElementType::List: {
+        size++;
+        if (m_childElements.empty()) return size + lengthSize(0);
+        NBTElementType elementType = m_childElements[0].m_type;
+        for (const NBTElement& element : m_childElements) if (elementType != element.m_type) return size + lengthSize(0);
+        NBTSettings elementSettings = settings;
+        elementSettings.m_type = elementType;
+        elementSettings.m_isInArray = true;
+        elementSettings.m_isNetwork = false;
+        size += lengthSize(m_childElements.size());
+        for (const NBTElement& element : m_childElements) size += element.encodedSize(isBigEndian, elementSettings);
+        return size;
+    }
+    case NBTElementType::String: return size + stringSize(m_stringValue);
+    case NBTElementType::Compound: {
+        for (const NBTElement& element : m_childElements) size += element.encodedSize(isBigEndian, NBTSettings());
+        return size + 1;
+    }
+    default: return size;
+    }
+}
 void NBTElement::decode(ByteBuffer& byteBuffer) {
     if (m_settings.m_type != NBTElementType::End) m_type = m_settings.m_type;
     if (!m_settings.m_isInArray) m_type = (NBTElementType) byteBuffer.readByte();
     if (m_type != NBTElementType::End && !m_settings.m_isInArray) {
         if (!byteBuffer.m_isBigEndian) {
             if (!m_settings.m_isNetwork) {
-                std::vector<char> bytes = byteBuffer.readBytes(byteBuffer.readNumeric<unsigned short>());
-                m_tag = std::string(bytes.begin(), bytes.end());
+                std::span<const char> bytes = byteBuffer.readSpan(byteBuffer.readNumeric<unsigned short>());
+                m_tag.assign(bytes.begin(), bytes.end());
             } else m_tag = byteBuffer.readString();
         } else {
             if (!m_settings.m_isNetwork) {
-                std::vector<char> bytes = byteBuffer.readBytes(byteBuffer.readNumeric<unsigned short>());
-                m_tag = std::string(bytes.begin(), bytes.end());
+                std::span<const char> bytes = byteBuffer.readSpan(byteBuffer.readNumeric<unsigned short>());
+                m_tag.assign(bytes.begin(), bytes.end());
             }
         }
     }
@@ -220,7 +268,7 @@ void NBTElement::decode(ByteBuffer& byteBuffer) {
             if (m_settings.m_isNetwork) length = zinc_safe_cast<int, unsigned>(byteBuffer.readZigZagVarNumeric<int>());
             else length = byteBuffer.readNumeric<unsigned int>();
         }
-        m_intArrayValue = byteBuffer.readArray<int>(&ByteBuffer::readNumeric<int>, length);
+        m_intArrayValue = byteBuffer.readNumericArray<int>(length);
         break;
     }
     case NBTElementType::LongArray: {
@@ -230,20 +278,20 @@ void NBTElement::decode(ByteBuffer& byteBuffer) {
             if (m_settings.m_isNetwork) length = zinc_safe_cast<int, unsigned>(byteBuffer.readZigZagVarNumeric<int>());
             else length = byteBuffer.readNumeric<unsigned int>();
         }
-        m_longArrayValue = byteBuffer.readArray<long>(&ByteBuffer::readNumeric<long>, length);
+        m_longArrayValue = byteBuffer.readNumericArray<long>(length);
         break;
     }
     case NBTElementType::String: {
         unsigned short length = 0;
         if (byteBuffer.m_isBigEndian) {
             length = byteBuffer.readNumeric<unsigned short>();
-            std::vector<char> bytes = byteBuffer.readBytes(length);
-            m_stringValue = std::string(bytes.begin(), bytes.end());
+            std::span<const char> bytes = byteBuffer.readSpan(length);
+            m_stringValue.assign(bytes.begin(), bytes.end());
         } else {
             if (!m_settings.m_isNetwork) {
                 length = byteBuffer.readNumeric<unsigned short>();
-                std::vector<char> bytes = byteBuffer.readBytes(length);
-                m_stringValue = std::string(bytes.begin(), bytes.end());
+                std::span<const char> bytes = byteBuffer.readSpan(length);
+                m_stringValue.assign(bytes.begin(), bytes.end());
             } else m_stringValue = byteBuffer.readString();
         }
         break;        
@@ -275,7 +323,7 @@ void NBTElement::decode(ByteBuffer& byteBuffer) {
         settings.m_isNetwork = !byteBuffer.m_isBigEndian && settings.m_isNetwork;
         settings.m_type = NBTElementType::End;
         while (byteBuffer.getReaderPointer() < byteBuffer.size()) {
-            if (!byteBuffer.getBytes()[byteBuffer.getReaderPointer()]) {
+            if (!byteBuffer.data()[byteBuffer.getReaderPointer()]) {
                 byteBuffer.readByte();
                 break;
             }
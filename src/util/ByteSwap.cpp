@@ -0,0 +1,57 @@
+#include <util/ByteSwap.h>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace zinc {
+
+namespace {
+
+template<typename T> T swapBytes(const T& value) {
+    if constexpr (sizeof(T) == 2) return __builtin_bswap16(value);
+    else if constexpr (sizeof(T) == 4) return __builtin_bswap32(value);
+    else return __builtin_bswap64(value);
+}
+template<typename T> void copySwapped(char* out, const char* in, const size_t& count) {
+    size_t offset = 0;
+    const size_t length = count * sizeof(T);
+#if defined(__SSSE3__) || defined(__AVX2__)
+    // byte i of every element comes from byte width - 1 - i
+    alignas(16) char shuffle[16];
+    for (size_t i = 0; i < 16; i++) shuffle[i] = static_cast<char>(i - i % sizeof(T) + sizeof(T) - 1 - i % sizeof(T));
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle));
+#if defined(__AVX2__)
+    const __m256i wideMask = _mm256_broadcastsi128_si256(mask);
+    for (; offset + 32 <= length; offset += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + offset), _mm256_shuffle_epi8(bytes, wideMask));
+    }
+#endif
+    for (; offset + 16 <= length; offset += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm_shuffle_epi8(bytes, mask));
+    }
+#endif
+    for (; offset < length; offset += sizeof(T)) {
+        T value;
+        std::memcpy(&value, in + offset, sizeof(T));
+        value = swapBytes(value);
+        std::memcpy(out + offset, &value, sizeof(T));
+    }
+}
+
+}
+
+void ByteSwap::copy(char* out, const char* in, const size_t& count, const size_t& width) noexcept {
+    switch (width) {
+    case 1: std::memcpy(out, in, count); break;
+    case 2: copySwapped<uint16_t>(out, in, count); break;
+    case 4: copySwapped<uint32_t>(out, in, count); break;
+    case 8: copySwapped<uint64_t>(out, in, count); break;
+    default: break;
+    }
+}
+
+}
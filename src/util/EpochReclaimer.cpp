@@ -0,0 +1,53 @@
+#include <util/EpochReclaimer.h>
+#include <thread>
+#include <vector>
+
+namespace zinc {
+
+EpochReclaimer g_epochReclaimer;
+
+size_t EpochReclaimer::enter() {
+    thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+    while (true) {
+        for (size_t i = 0; i < m_participants.size(); i++) {
+            size_t participant = (hint + i) % m_participants.size();
+            uint64_t expected = IDLE;
+            if (m_participants[participant].m_epoch.compare_exchange_strong(expected, m_globalEpoch.load())) {
+                hint = participant;
+                return participant;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+void EpochReclaimer::exit(const size_t& participant) {
+    m_participants[participant].m_epoch.store(IDLE);
+}
+EpochReclaimer::Guard EpochReclaimer::pin() {
+    return Guard(*this);
+}
+void EpochReclaimer::retire(const std::function<void()>& deleter) {
+    m_mutex.lock();
+    m_retired.push_back({ deleter, m_globalEpoch.load() });
+    m_mutex.unlock();
+    collect();
+}
+void EpochReclaimer::collect() {
+    uint64_t minimum = m_globalEpoch.fetch_add(1) + 1;
+    for (const Participant& participant : m_participants) minimum = std::min(minimum, participant.m_epoch.load());
+    std::vector<std::function<void()>> deleters;
+    m_mutex.lock();
+    // retired in epoch order, so everything below the oldest active epoch is unreachable
+    while (m_retired.size() && m_retired.front().m_epoch < minimum) {
+        deleters.push_back(std::move(m_retired.front().m_deleter));
+        m_retired.pop_front();
+    }
+    m_mutex.unlock();
+    for (const std::function<void()>& deleter : deleters) deleter();
+}
+size_t EpochReclaimer::getRetiredCount() {
+    std::lock_guard lock(m_mutex);
+    return m_retired.size();
+}
+
+}
@@ -1,27 +1,50 @@
 #include <util/TCPUtil.h>
+#include <util/VarInt.h>
 #include <event2/buffer.h>
 
 namespace zinc {
 
-size_t TCPUtil::read(bufferevent* bev, ByteBuffer& buffer) {
-    evbuffer* input = bufferevent_get_input(bev);
+size_t TCPUtil::read(TCPStream* stream, ByteBuffer& buffer) {
+    evbuffer* input = stream->getInput();
     size_t length = evbuffer_get_length(input);
     std::vector<char> data (length);
     evbuffer_copyout(input, data.data(), length);
     buffer.writeBytes(data);
     return length;
 }
-ByteBuffer TCPUtil::read(bufferevent* bev) {
+ByteBuffer TCPUtil::read(TCPStream* stream) {
     ByteBuffer buffer;
-    read(bev, buffer);
+    read(stream, buffer);
     return buffer;
 }
-void TCPUtil::send(bufferevent* bev, const ByteBuffer& buffer) {
-    bufferevent_write(bev, buffer.getBytes().data(), buffer.size());
+void TCPUtil::send(TCPStream* stream, const ByteBuffer& buffer) {
+    stream->write(buffer.data(), buffer.size());
 }
-void TCPUtil::drain(bufferevent* bev, const size_t& length) {
-    evbuffer* input = bufferevent_get_input(bev);
+void TCPUtil::drain(TCPStream* stream, const size_t& length) {
+    evbuffer* input = stream->getInput();
     evbuffer_drain(input, length);
 }
+int TCPUtil::peekVarInt(const unsigned char* data, const size_t& length, int& value) {
+    return VarInt::decode(reinterpret_cast<const char*>(data), length, value);
+}
+size_t TCPUtil::writeVarInt(unsigned char* out, const int& value) {
+    return VarInt::encode(reinterpret_cast<char*>(out), value);
+}
+int TCPUtil::readFrame(evbuffer* input, evbuffer* frame) {
+    size_t available = evbuffer_get_length(input);
+    if (!available) return 0;
+    // only the prefix is made contiguous, the payload is moved chain by chain
+    size_t prefixLength = std::min<size_t>(available, 5);
+    const unsigned char* prefix = evbuffer_pullup(input, zinc_safe_cast<size_t, ev_ssize_t>(prefixLength));
+    int length = 0;
+    int varIntLength = peekVarInt(prefix, prefixLength, length);
+    if (varIntLength < 0 || length < 0 || length > MAX_FRAME_LENGTH) return -1;
+    if (!varIntLength) return 0;
+    size_t frameLength = zinc_safe_cast<int, size_t>(length), headerLength = zinc_safe_cast<int, size_t>(varIntLength);
+    if (available < headerLength + frameLength) return 0;
+    evbuffer_drain(input, headerLength);
+    evbuffer_remove_buffer(input, frame, frameLength);
+    return 1;
+}
 
 }
\ No newline at end of file
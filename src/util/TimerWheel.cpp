@@ -0,0 +1,94 @@
+#include <util/TimerWheel.h>
+#include <util/Memory.h>
+
+namespace zinc {
+
+void TimerWheel::link(const uint32_t& index) {
+    Timer& timer = m_timers[index];
+    uint64_t delay = timer.m_expiry - m_tick, expiry = timer.m_expiry;
+    size_t level = 0;
+    while (level < LEVELS - 1 && delay >= (1ULL << (SLOT_BITS * (level + 1)))) level++;
+    if (delay > MAX_DELAY) expiry = m_tick + MAX_DELAY;
+    uint32_t slot = zinc_safe_cast<uint64_t, uint32_t>(level * SLOTS + ((expiry >> (SLOT_BITS * level)) & (SLOTS - 1)));
+    timer.m_slot = slot;
+    timer.m_prev = NIL;
+    timer.m_next = m_slots[slot];
+    if (timer.m_next != NIL) m_timers[timer.m_next].m_prev = index;
+    m_slots[slot] = index;
+}
+void TimerWheel::unlink(const uint32_t& index) {
+    Timer& timer = m_timers[index];
+    if (timer.m_prev != NIL) m_timers[timer.m_prev].m_next = timer.m_next;
+    else m_slots[timer.m_slot] = timer.m_next;
+    if (timer.m_next != NIL) m_timers[timer.m_next].m_prev = timer.m_prev;
+    timer.m_prev = timer.m_next = timer.m_slot = NIL;
+}
+void TimerWheel::release(const uint32_t& index) {
+    m_timers[index].m_generation++;
+    m_freeTimers.push_back(index);
+    m_size--;
+}
+void TimerWheel::cascade(const size_t& level) {
+    uint32_t slot = zinc_safe_cast<uint64_t, uint32_t>(level * SLOTS + ((m_tick >> (SLOT_BITS * level)) & (SLOTS - 1)));
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = NIL;
+    while (index != NIL) {
+        uint32_t next = m_timers[index].m_next;
+        link(index);
+        index = next;
+    }
+}
+TimerWheel::TimerId TimerWheel::schedule(const uint64_t& delay, const std::function<void()>& callback) {
+    uint32_t index;
+    if (m_freeTimers.size()) {
+        index = m_freeTimers.back();
+        m_freeTimers.pop_back();
+    } else {
+        index = zinc_safe_cast<size_t, uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+    Timer& timer = m_timers[index];
+    timer.m_callback = callback;
+    timer.m_expiry = m_tick + std::max<uint64_t>(delay, 1);
+    link(index);
+    m_size++;
+    return { index, timer.m_generation };
+}
+bool TimerWheel::cancel(TimerId& id) {
+    if (!isScheduled(id)) return false;
+    unlink(id.m_index);
+    m_timers[id.m_index].m_callback = nullptr;
+    release(id.m_index);
+    id = TimerId();
+    return true;
+}
+bool TimerWheel::isScheduled(const TimerId& id) const {
+    return id.isValid() && id.m_index < m_timers.size() && m_timers[id.m_index].m_generation == id.m_generation
+        && m_timers[id.m_index].m_slot != NIL;
+}
+void TimerWheel::advance(const uint64_t& ticks) {
+    for (uint64_t i = 0; i < ticks; i++) {
+        m_tick++;
+        // higher levels first, a timer may move down more than one level
+        size_t levels = 0;
+        while (levels < LEVELS - 1 && !((m_tick >> (SLOT_BITS * levels)) & (SLOTS - 1))) levels++;
+        for (size_t level = levels; level > 0; level--) cascade(level);
+        uint32_t slot = zinc_safe_cast<uint64_t, uint32_t>(m_tick & (SLOTS - 1));
+        while (m_slots[slot] != NIL) {
+            uint32_t index = m_slots[slot];
+            unlink(index);
+            std::function<void()> callback = std::move(m_timers[index].m_callback);
+            m_timers[index].m_callback = nullptr;
+            release(index);
+            callback(); // may schedule or cancel other timers
+        }
+    }
+}
+uint64_t TimerWheel::getTick() const {
+    return m_tick;
+}
+size_t TimerWheel::size() const {
+    return m_size;
+}
+
+}
@@ -0,0 +1,109 @@
+#include <util/VarInt.h>
+#include <util/Memory.h>
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace zinc {
+
+// both array paths look at a whole block first: palette indices, entity ids and most registry ids are single byte VarInts,
+// those blocks are converted with one pack/widen, anything else goes through the scalar codec value by value
+size_t VarInt::encodeArray(char* out, std::span<const int> values) noexcept {
+    size_t offset = 0, index = 0;
+    const size_t count = values.size();
+    while (index < count) {
+#if defined(__AVX2__)
+        if (count - index >= 16) {
+            const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values.data() + index));
+            const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values.data() + index + 8));
+            if (_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_set1_epi32(~0x7F))) {
+                // packs work per 128-bit lane, the permute puts the 4 byte groups back in order
+                const __m256i words = _mm256_packus_epi32(low, high);
+                const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words, words), _mm256_setr_epi32(0, 4, 1, 5, 0, 4, 1, 5));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm256_castsi256_si128(bytes));
+                offset += 16;
+                index += 16;
+                continue;
+            }
+            for (const size_t end = index + 16; index < end; index++) offset += encode(out + offset, values[index]);
+            continue;
+        }
+#endif
+#if defined(__SSE4_1__)
+        if (count - index >= 8) {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data() + index));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data() + index + 4));
+            if (_mm_testz_si128(_mm_or_si128(low, high), _mm_set1_epi32(~0x7F))) {
+                const __m128i words = _mm_packus_epi32(low, high);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + offset), _mm_packus_epi16(words, words));
+                offset += 8;
+                index += 8;
+                continue;
+            }
+            for (const size_t end = index + 8; index < end; index++) offset += encode(out + offset, values[index]);
+            continue;
+        }
+#endif
+        offset += encode(out + offset, values[index++]);
+    }
+    return offset;
+}
+long VarInt::decodeArray(const char* data, const size_t& length, std::span<int> values) noexcept {
+    size_t offset = 0, index = 0;
+    const size_t count = values.size();
+    // scalar decode up to end, so a block with long values is not loaded again for every one of them
+    auto decodeUntil = [&](const size_t& end) {
+        while (index < count && offset < end) {
+            int value = 0;
+            const int encoded = decode(data + offset, length - offset, value);
+            if (encoded <= 0) return false;
+            values[index++] = value;
+            offset += zinc_safe_cast<int, size_t>(encoded);
+        }
+        return true;
+    };
+    while (index < count) {
+#if defined(__AVX2__)
+        if (count - index >= 32 && length - offset >= 32) {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            const uint32_t continuations = static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+            if (!continuations) {
+                for (size_t i = 0; i < 32; i += 8) {
+                    const __m128i group = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + offset + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(values.data() + index + i), _mm256_cvtepu8_epi32(group));
+                }
+                offset += 32;
+                index += 32;
+                continue;
+            }
+            // everything before the first continuation bit is a complete single byte value
+            const size_t blockEnd = offset + 32;
+            for (size_t run = static_cast<size_t>(std::countr_zero(continuations)); run; run--) values[index++] = static_cast<unsigned char>(data[offset++]);
+            if (!decodeUntil(blockEnd)) return -1;
+            continue;
+        }
+#endif
+#if defined(__SSE4_1__)
+        if (count - index >= 16 && length - offset >= 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            const uint32_t continuations = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+            if (!continuations) {
+                for (size_t i = 0; i < 16; i += 4, bytes = _mm_srli_si128(bytes, 4)) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(values.data() + index + i), _mm_cvtepu8_epi32(bytes));
+                }
+                offset += 16;
+                index += 16;
+                continue;
+            }
+            const size_t blockEnd = offset + 16;
+            for (size_t run = static_cast<size_t>(std::countr_zero(continuations)); run; run--) values[index++] = static_cast<unsigned char>(data[offset++]);
+            if (!decodeUntil(blockEnd)) return -1;
+            continue;
+        }
+#endif
+        if (!decodeUntil(offset + 1)) return -1;
+    }
+    return zinc_safe_cast<size_t, long>(offset);
+}
+
+}
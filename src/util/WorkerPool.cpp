@@ -0,0 +1,110 @@
+#include <util/WorkerPool.h>
+
+namespace zinc {
+
+namespace {
+
+thread_local const WorkerPool* t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+}
+
+void WorkerPool::start(const size_t& threads) {
+    std::lock_guard lock(m_mutex);
+    if (m_started || !threads) return;
+    m_started = true;
+    m_workers.resize(threads);
+    for (size_t i = 0; i < threads; i++) m_workers[i].m_thread = std::thread(&WorkerPool::worker, this, i);
+}
+void WorkerPool::stop() {
+    m_mutex.lock();
+    if (!m_started) {
+        m_mutex.unlock();
+        return;
+    }
+    m_started = false;
+    m_mutex.unlock();
+    m_condition.notify_all();
+    for (Worker& worker : m_workers) if (worker.m_thread.joinable()) worker.m_thread.join();
+    for (Worker& worker : m_workers) {
+        for (const Task& task : worker.m_tasks) m_stages[task.m_stage].m_queueDepth--;
+        worker.m_tasks.clear();
+    }
+    m_workers.clear();
+    m_pending = 0;
+}
+void WorkerPool::submit(const size_t& stage, const std::function<void()>& work) {
+    Task task { work, std::min(stage, MAX_STAGES - 1), std::chrono::steady_clock::now() };
+    m_stages[task.m_stage].m_queueDepth++;
+    std::unique_lock lock(m_mutex);
+    if (!m_started) {
+        lock.unlock();
+        run(task);
+        return;
+    }
+    // a worker submitting follow-up work keeps it local, everyone else spreads round-robin
+    size_t index = t_pool == this ? t_workerIndex : m_nextWorker++ % m_workers.size();
+    // counted under the deque lock, a worker can only pop the task once it's counted
+    m_workers[index].m_mutex.lock();
+    m_workers[index].m_tasks.push_back(std::move(task));
+    m_pending++;
+    m_workers[index].m_mutex.unlock();
+    lock.unlock();
+    m_condition.notify_one();
+}
+bool WorkerPool::pop(const size_t& index, Task& task) {
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        Worker& worker = m_workers[(index + i) % m_workers.size()];
+        std::lock_guard lock(worker.m_mutex);
+        if (worker.m_tasks.empty()) continue;
+        // own queue is served oldest first, steals take the newest job of the victim
+        if (!i) {
+            task = std::move(worker.m_tasks.front());
+            worker.m_tasks.pop_front();
+        } else {
+            task = std::move(worker.m_tasks.back());
+            worker.m_tasks.pop_back();
+        }
+        m_pending--;
+        return true;
+    }
+    return false;
+}
+void WorkerPool::run(Task& task) {
+    task.m_work();
+    Stage& stage = m_stages[task.m_stage];
+    uint64_t latency = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - task.m_submitted).count();
+    stage.m_queueDepth--;
+    stage.m_totalLatency += latency;
+    uint64_t maxLatency = stage.m_maxLatency.load();
+    while (latency > maxLatency && !stage.m_maxLatency.compare_exchange_weak(maxLatency, latency));
+    stage.m_completed++;
+}
+void WorkerPool::worker(const size_t& index) {
+    t_pool = this;
+    t_workerIndex = index;
+    while (true) {
+        Task task;
+        if (pop(index, task)) {
+            run(task);
+            continue;
+        }
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this]() { return !m_started || m_pending > 0; });
+        if (!m_started) return;
+    }
+}
+size_t WorkerPool::getThreadCount() const {
+    return m_workers.size();
+}
+WorkerStageStats WorkerPool::getStats(const size_t& stage) const {
+    WorkerStageStats stats;
+    if (stage >= MAX_STAGES) return stats;
+    stats.m_queueDepth = m_stages[stage].m_queueDepth.load();
+    stats.m_completed = m_stages[stage].m_completed.load();
+    stats.m_totalLatencyNanoseconds = m_stages[stage].m_totalLatency.load();
+    stats.m_maxLatencyNanoseconds = m_stages[stage].m_maxLatency.load();
+    return stats;
+}
+
+}
@@ -1,31 +1,98 @@
 #include <util/ZLibUtil.h>
 #include <util/Logger.h>
-#include <zlib-ng.h>
+#include <util/Memory.h>
+#include <cstring>
 
 namespace zinc {
 
 Logger m_zlibLogger = Logger("ZLib");
 
-std::vector<char> ZLibUtil::compress(const std::vector<char>& buffer) {
-    size_t compressedSize = zng_compressBound(buffer.size());
-    std::vector<char> compressed(compressedSize);
-    int ret = zng_compress2((uint8_t*)compressed.data(), &compressedSize, (const uint8_t*)buffer.data(), buffer.size(), Z_DEFAULT_COMPRESSION);
-    if (ret != Z_OK) {
+ZLibContext& ZLibContext::getThreadLocal() {
+    thread_local ZLibContext context;
+    return context;
+}
+void ZLibContext::setLevel(const int& level) {
+    if (level == m_level) return;
+    m_level = level;
+    if (m_isDeflateReady) {
+        zng_deflateEnd(&m_deflate);
+        m_isDeflateReady = false;
+    }
+}
+int ZLibContext::getLevel() const {
+    return m_level;
+}
+size_t ZLibContext::compressBound(const size_t& length) {
+    return ::zng_compressBound(length);
+}
+size_t ZLibContext::compress(const uint8_t* data, const size_t& length, uint8_t* out, const size_t& outCapacity) {
+    return compress(nullptr, 0, data, length, out, outCapacity);
+}
+size_t ZLibContext::compress(const uint8_t* prefix, const size_t& prefixLength, const uint8_t* data, const size_t& length, uint8_t* out,
+                             const size_t& outCapacity) {
+    if (!m_isDeflateReady) {
+        std::memset(&m_deflate, 0, sizeof(m_deflate));
+        int ret = zng_deflateInit(&m_deflate, m_level);
+        if (ret != Z_OK) {
+            m_zlibLogger.error("Deflate init failed: " + std::string(zng_zError(ret)));
+            return 0;
+        }
+        m_isDeflateReady = true;
+    } else zng_deflateReset(&m_deflate);
+    m_deflate.next_out = out;
+    m_deflate.avail_out = zinc_safe_cast<size_t, uint32_t>(outCapacity);
+    if (prefixLength) {
+        m_deflate.next_in = (uint8_t*) prefix;
+        m_deflate.avail_in = zinc_safe_cast<size_t, uint32_t>(prefixLength);
+        int ret = zng_deflate(&m_deflate, Z_NO_FLUSH);
+        if (ret != Z_OK || m_deflate.avail_in) {
+            m_zlibLogger.error("Compression failed: " + std::string(zng_zError(ret)));
+            return 0;
+        }
+    }
+    m_deflate.next_in = (uint8_t*) data;
+    m_deflate.avail_in = zinc_safe_cast<size_t, uint32_t>(length);
+    int ret = zng_deflate(&m_deflate, Z_FINISH);
+    if (ret != Z_STREAM_END) {
         m_zlibLogger.error("Compression failed: " + std::string(zng_zError(ret)));
-        return {};
+        return 0;
+    }
+    return m_deflate.total_out;
+}
+bool ZLibContext::uncompress(const uint8_t* data, const size_t& length, uint8_t* out, const size_t& outLength) {
+    if (!m_isInflateReady) {
+        std::memset(&m_inflate, 0, sizeof(m_inflate));
+        int ret = zng_inflateInit(&m_inflate);
+        if (ret != Z_OK) {
+            m_zlibLogger.error("Inflate init failed: " + std::string(zng_zError(ret)));
+            return false;
+        }
+        m_isInflateReady = true;
+    } else zng_inflateReset(&m_inflate);
+    m_inflate.next_in = (uint8_t*) data;
+    m_inflate.avail_in = zinc_safe_cast<size_t, uint32_t>(length);
+    m_inflate.next_out = out;
+    m_inflate.avail_out = zinc_safe_cast<size_t, uint32_t>(outLength);
+    int ret = zng_inflate(&m_inflate, Z_FINISH);
+    if (ret != Z_STREAM_END || m_inflate.total_out != outLength) {
+        m_zlibLogger.error("Decompression failed: " + std::string(ret == Z_STREAM_END ? "size mismatch" : zng_zError(ret)));
+        return false;
     }
+    return true;
+}
+
+std::vector<char> ZLibUtil::compress(const std::vector<char>& buffer) {
+    ZLibContext& context = ZLibContext::getThreadLocal();
+    std::vector<char> compressed(ZLibContext::compressBound(buffer.size()));
+    size_t compressedSize = context.compress((const uint8_t*)buffer.data(), buffer.size(), (uint8_t*)compressed.data(), compressed.size());
+    if (!compressedSize) return {};
+    compressed.resize(compressedSize);
     m_zlibLogger.debug("Compressed " + std::to_string(buffer.size()) + " bytes");
     return compressed;
 }
 std::vector<char> ZLibUtil::uncompress(const std::vector<char>& buffer, const size_t& decompressedSize) {
-    size_t m_decompressedSize = decompressedSize;
-    size_t sourceLen = buffer.size();
     std::vector<char> decompressed(decompressedSize);
-    int ret = zng_uncompress2((uint8_t*)decompressed.data(), &m_decompressedSize, (const uint8_t*)buffer.data(), &sourceLen);
-    if (ret != Z_OK) {
-        m_zlibLogger.error("Decompression failed: " + std::string(zng_zError(ret)));
-        return {};
-    }
+    if (!ZLibContext::getThreadLocal().uncompress((const uint8_t*)buffer.data(), buffer.size(), (uint8_t*)decompressed.data(), decompressedSize)) return {};
     m_zlibLogger.debug("Decompressed " + std::to_string(buffer.size()) + " bytes");
     return decompressed;
 }
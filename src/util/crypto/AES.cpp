@@ -1,7 +1,6 @@
 #include <string>
 #include <util/crypto/AES.h>
 #include <openssl/err.h>
-#include <openssl/evp.h>
 #include <util/Memory.h>
 
 namespace zinc {
@@ -13,6 +12,10 @@ void AESWrapper::setKey(const std::vector<unsigned char>& key) {
     }
     m_key = Lockable<SafeVector<unsigned char>>(SafeVector<unsigned char>(key.data(), key.size()));
     m_isKeySet = true;
+    if (m_context) {
+        EVP_CIPHER_CTX_free(m_context);
+        m_context = nullptr;
+    }
     m_logger.debug("AES key updated");
 }
 void AESWrapper::setIV(const std::vector<unsigned char>& iv) {
@@ -22,21 +25,23 @@ void AESWrapper::setIV(const std::vector<unsigned char>& iv) {
     }
     m_iv = Lockable<SafeVector<unsigned char>>(SafeVector<unsigned char>(iv.data(), iv.size()));
     m_isIVSet = true;
+    if (m_context) {
+        EVP_CIPHER_CTX_free(m_context);
+        m_context = nullptr;
+    }
     m_logger.debug("AES IV updated");
 }
 
-std::vector<unsigned char> AESWrapper::encryptCFB8(const std::vector<unsigned char>& data) {
-    return processCFB8(data, 1);
+void AESWrapper::logError(const std::string& message) {
+    char err_buf[256];
+    ERR_error_string_n(ERR_get_error(), err_buf, sizeof(err_buf));
+    m_logger.error(message + ": " + err_buf);
 }
 
-std::vector<unsigned char> AESWrapper::decryptCFB8(const std::vector<unsigned char>& data) {
-    return processCFB8(data, 0);
-}
-
-std::vector<unsigned char> AESWrapper::processCFB8(const std::vector<unsigned char>& data, int enc) {
+bool AESWrapper::initCFB8(const int& enc) {
     if (!m_isKeySet || !m_isIVSet) {
         m_logger.error("You must set both AES Key and IV");
-        return {};
+        return false;
     }
 
     const EVP_CIPHER* cipher = nullptr;
@@ -46,62 +51,50 @@ std::vector<unsigned char> AESWrapper::processCFB8(const std::vector<unsigned ch
         case 32: cipher = EVP_aes_256_cfb8(); break;
         default:
             m_logger.error("Invalid key length: " + std::to_string(m_key.data().size()));
-            return {};
+            return false;
     }
 
-    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
+    if (!m_context) m_context = EVP_CIPHER_CTX_new();
+    if (!m_context) {
         m_logger.error("Failed to create EVP context");
-        return {};
-    }
-
-    if (1 != EVP_CipherInit_ex(ctx, cipher, nullptr, m_key.data().data(), m_iv.data().data(), enc)) {
-        char err_buf[256];
-        ERR_error_string_n(ERR_get_error(), err_buf, sizeof(err_buf));
-        m_logger.error(std::string("EVP_CipherInit_ex failed: ") + err_buf);
-        EVP_CIPHER_CTX_free(ctx);
-        return {};
+        return false;
     }
 
-    std::vector<unsigned char> out(data.size() + EVP_MAX_BLOCK_LENGTH);
-    int out_len1 = 0;
-    int out_len2 = 0;
-
-    if (1 != EVP_CipherUpdate(ctx, out.data(), &out_len1, data.data(), zinc_safe_cast<size_t, int>(data.size()))) {
-        char err_buf[256];
-        ERR_error_string_n(ERR_get_error(), err_buf, sizeof(err_buf));
-        m_logger.error(std::string("EVP_CipherUpdate failed: ") + err_buf);
-        EVP_CIPHER_CTX_free(ctx);
-        return {};
+    if (1 != EVP_CipherInit_ex(m_context, cipher, nullptr, m_key.data().data(), m_iv.data().data(), enc)) {
+        logError("EVP_CipherInit_ex failed");
+        EVP_CIPHER_CTX_free(m_context);
+        m_context = nullptr;
+        return false;
     }
+    m_enc = enc;
+    return true;
+}
 
-    if (1 != EVP_CipherFinal_ex(ctx, out.data() + out_len1, &out_len2)) {
-        char err_buf[256];
-        ERR_error_string_n(ERR_get_error(), err_buf, sizeof(err_buf));
-        m_logger.error(std::string("EVP_CipherFinal_ex failed: ") + err_buf);
-        EVP_CIPHER_CTX_free(ctx);
-        return {};
+bool AESWrapper::update(uint8_t* data, const size_t& length) {
+    if (!m_context) {
+        m_logger.error("AES context is not initialized");
+        return false;
     }
-
-    const int total_len = out_len1 + out_len2;
-    out.resize(zinc_safe_cast<int, size_t>(total_len));
-
-    size_t iv_len = zinc_safe_cast<int, size_t>(EVP_CIPHER_CTX_get_iv_length(ctx));
-    if (iv_len == 16) {
-        if (1 != EVP_CIPHER_CTX_get_updated_iv(ctx, m_iv.data().data(), iv_len)) {
-           char err_buf[256];
-           ERR_error_string_n(ERR_get_error(), err_buf, sizeof(err_buf));
-           m_logger.error(std::string("EVP_CIPHER_CTX_get_updated_iv failed: ") + err_buf);
-           m_isIVSet = false;
-        }
-    } else {
-        m_logger.error("Unexpected IV length: " + std::to_string(iv_len) + " (expected 16)");
-        m_isIVSet = false;
+    // CFB8 is a stream mode: output length always equals input length, so in == out is safe
+    int outLength = 0;
+    if (1 != EVP_CipherUpdate(m_context, data, &outLength, data, zinc_safe_cast<size_t, int>(length))) {
+        logError("EVP_CipherUpdate failed");
+        return false;
     }
+    return true;
+}
 
-    EVP_CIPHER_CTX_free(ctx);
+std::vector<unsigned char> AESWrapper::encryptCFB8(const std::vector<unsigned char>& data) {
+    if ((!m_context || m_enc != 1) && !initCFB8(1)) return {};
+    std::vector<unsigned char> out = data;
+    if (!update(out.data(), out.size())) return {};
+    return out;
+}
 
-    m_logger.debug(enc ? "called encryptCFB8()" : "called decryptCFB8()");
+std::vector<unsigned char> AESWrapper::decryptCFB8(const std::vector<unsigned char>& data) {
+    if ((!m_context || m_enc != 0) && !initCFB8(0)) return {};
+    std::vector<unsigned char> out = data;
+    if (!update(out.data(), out.size())) return {};
     return out;
 }
 
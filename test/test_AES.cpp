@@ -16,6 +16,33 @@ TEST(AESTest, EncryptDecrypt) {
     EXPECT_EQ(data, decryptedData);
 }
 
+TEST(AESTest, StreamingInPlaceUpdate) {
+    std::vector<unsigned char> keyIV = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16};
+    std::vector<unsigned char> data (1000);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (unsigned char) (i * 7);
+    zinc::AESWrapper oneShot, streamEncrypt, streamDecrypt;
+    oneShot.setKey(keyIV);
+    oneShot.setIV(keyIV);
+    streamEncrypt.setKey(keyIV);
+    streamEncrypt.setIV(keyIV);
+    streamDecrypt.setKey(keyIV);
+    streamDecrypt.setIV(keyIV);
+    ASSERT_TRUE(streamEncrypt.initCFB8(1));
+    ASSERT_TRUE(streamDecrypt.initCFB8(0));
+
+    std::vector<unsigned char> expected = oneShot.encryptCFB8(data);
+    std::vector<unsigned char> buffer = data;
+    // uneven chunks must continue the same stream
+    size_t offsets[] = { 0, 1, 17, 300, 301, 999, 1000 };
+    for (size_t i = 0; i + 1 < sizeof(offsets) / sizeof(offsets[0]); i++)
+        ASSERT_TRUE(streamEncrypt.update(buffer.data() + offsets[i], offsets[i + 1] - offsets[i]));
+    EXPECT_EQ(expected, buffer);
+
+    ASSERT_TRUE(streamDecrypt.update(buffer.data(), 500));
+    ASSERT_TRUE(streamDecrypt.update(buffer.data() + 500, 500));
+    EXPECT_EQ(data, buffer);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
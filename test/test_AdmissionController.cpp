@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <network/minecraft/ZincAdmissionController.h>
+#include <ZincConfig.h>
+
+namespace {
+
+void configure(const int& rateLimit, const int& burst, const int& subnetRate, const int& subnetBurst, const int& maxConcurrent) {
+    zinc::g_zincConfig.m_core.m_security.m_rateLimit = rateLimit;
+    zinc::g_zincConfig.m_core.m_security.m_connectionBurst = burst;
+    zinc::g_zincConfig.m_core.m_security.m_subnetConnectionRate = subnetRate;
+    zinc::g_zincConfig.m_core.m_security.m_subnetConnectionBurst = subnetBurst;
+    zinc::g_zincConfig.m_core.m_security.m_maxConcurrentAccount = maxConcurrent;
+}
+zinc::ZincAddressKey ipv4(const uint32_t& address) {
+    return zinc::ZincAddressKey(0, 0x0000FFFF00000000ULL | address);
+}
+// every address of one /64 lands in the same shard
+zinc::ZincAddressKey ipv6(const uint64_t& interfaceId) {
+    return zinc::ZincAddressKey(0x20010DB800000000ULL, interfaceId);
+}
+
+}
+
+TEST(AdmissionControllerTest, RefillsOverTime) {
+    configure(2, 3, 0, 0, 0);
+    zinc::ZincAdmissionController controller;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; i++) EXPECT_TRUE(controller.admit(ipv4(0x0A000001), now));
+    EXPECT_FALSE(controller.admit(ipv4(0x0A000001), now));
+    EXPECT_FALSE(controller.admit(ipv4(0x0A000001), now + std::chrono::seconds(1)));
+    EXPECT_TRUE(controller.admit(ipv4(0x0A000001), now + std::chrono::seconds(2)));
+    EXPECT_FALSE(controller.admit(ipv4(0x0A000001), now + std::chrono::seconds(2)));
+    // other addresses have their own bucket
+    EXPECT_TRUE(controller.admit(ipv4(0x0A000102), now));
+}
+
+TEST(AdmissionControllerTest, PaysFromBothBuckets) {
+    configure(1000, 2, 1, 3, 0);
+    zinc::ZincAdmissionController controller;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const zinc::ZincAddressKey a = ipv4(0x0A000001), b = ipv4(0x0A000002), c = ipv4(0x0A000003), d = ipv4(0x0A000004);
+    EXPECT_TRUE(controller.admit(a, now));
+    EXPECT_TRUE(controller.admit(a, now));
+    EXPECT_TRUE(controller.admit(b, now));
+    // the /24 is out of tokens, refusals neither charge the address nor create entries
+    EXPECT_FALSE(controller.admit(b, now));
+    EXPECT_FALSE(controller.admit(d, now));
+    EXPECT_EQ(controller.getTrackedAddresses(), 2u);
+    EXPECT_EQ(controller.getTrackedSubnets(), 1u);
+    EXPECT_TRUE(controller.admit(b, now + std::chrono::seconds(1)));
+    // b is out of tokens now and its refusal leaves the subnet token for c
+    EXPECT_FALSE(controller.admit(b, now + std::chrono::seconds(2)));
+    EXPECT_TRUE(controller.admit(c, now + std::chrono::seconds(2)));
+    EXPECT_FALSE(controller.admit(d, now + std::chrono::seconds(2)));
+}
+
+TEST(AdmissionControllerTest, LimitsConcurrentConnections) {
+    configure(0, 1, 0, 1, 2);
+    zinc::ZincAdmissionController controller;
+    EXPECT_TRUE(controller.admit(ipv4(0x0A000001)));
+    EXPECT_TRUE(controller.admit(ipv4(0x0A000001)));
+    EXPECT_FALSE(controller.admit(ipv4(0x0A000001)));
+    controller.release(ipv4(0x0A000001));
+    EXPECT_TRUE(controller.admit(ipv4(0x0A000001)));
+}
+
+TEST(AdmissionControllerTest, EvictsLeastRecentlyUsedIdleEntry) {
+    configure(1000, 3, 0, 1, 0);
+    zinc::ZincAdmissionController controller;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const uint64_t count = zinc::ZincAdmissionController::MAX_ENTRIES_PER_SHARD;
+    for (uint64_t i = 0; i < count; i++) {
+        ASSERT_TRUE(controller.admit(ipv6(i), now));
+        controller.release(ipv6(i));
+    }
+    EXPECT_TRUE(controller.admit(ipv6(0), now));
+    controller.release(ipv6(0));
+    // a full shard makes room instead of refusing, ipv6(1) is the least recently used one now
+    EXPECT_TRUE(controller.admit(ipv6(count), now));
+    controller.release(ipv6(count));
+    EXPECT_EQ(controller.getTrackedAddresses(), count);
+    // ipv6(0) kept its drained bucket, ipv6(1) comes back with a full one
+    EXPECT_TRUE(controller.admit(ipv6(0), now));
+    EXPECT_FALSE(controller.admit(ipv6(0), now));
+    for (int i = 0; i < 3; i++) EXPECT_TRUE(controller.admit(ipv6(1), now));
+}
+
+TEST(AdmissionControllerTest, FullShardOfOpenConnections) {
+    configure(1000, 3, 0, 1, 0);
+    zinc::ZincAdmissionController controller;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const uint64_t count = zinc::ZincAdmissionController::MAX_ENTRIES_PER_SHARD;
+    for (uint64_t i = 0; i < count; i++) ASSERT_TRUE(controller.admit(ipv6(i), now));
+    // addresses with open connections are never evicted, only a new address is refused
+    EXPECT_FALSE(controller.admit(ipv6(count), now));
+    EXPECT_TRUE(controller.admit(ipv6(5), now));
+    EXPECT_EQ(controller.getTrackedAddresses(), count);
+    controller.release(ipv6(7));
+    EXPECT_TRUE(controller.admit(ipv6(count), now));
+    EXPECT_EQ(controller.getTrackedAddresses(), count);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <network/minecraft/ZincAuthService.h>
+#include <ZincConfig.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+
+// local stand-in for the session server, answers the n-th request with the n-th scripted response
+// and repeats the last one once the script ran out
+struct SessionServerStandIn {
+    int m_fd = -1;
+    unsigned short m_port = 0;
+    std::vector<std::pair<int, std::string>> m_responses;
+    std::atomic<int> m_requests = 0;
+    std::mutex m_mutex;
+    std::string m_lastRequest; // guarded by m_mutex, written by the server thread
+    std::thread m_thread;
+    std::atomic<bool> m_running = true;
+
+    SessionServerStandIn(const std::vector<std::pair<int, std::string>>& responses) : m_responses(responses) {
+        m_fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        bind(m_fd, (sockaddr*) &addr, length);
+        listen(m_fd, 16);
+        getsockname(m_fd, (sockaddr*) &addr, &length);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this]() { serve(); });
+    }
+    ~SessionServerStandIn() {
+        m_running = false;
+        shutdown(m_fd, SHUT_RDWR);
+        close(m_fd);
+        m_thread.join();
+    }
+
+    std::string getUrl() const {
+        return "http://127.0.0.1:" + std::to_string(m_port);
+    }
+    std::string getLastRequest() {
+        std::lock_guard lock(m_mutex);
+        return m_lastRequest;
+    }
+    void serve() {
+        while (m_running) {
+            int client = accept(m_fd, nullptr, nullptr);
+            if (client < 0) return;
+            std::string request;
+            char chunk[1024];
+            while (request.find("\r\n\r\n") == std::string::npos) {
+                ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+                if (received <= 0) break;
+                request.append(chunk, (size_t) received);
+            }
+            m_mutex.lock();
+            m_lastRequest = request;
+            m_mutex.unlock();
+            size_t index = std::min((size_t) m_requests++, m_responses.size() - 1);
+            const auto& [status, body] = m_responses[index];
+            std::string response = "HTTP/1.1 " + std::to_string(status) + " Scripted\r\nContent-Length: " + std::to_string(body.size())
+                                 + "\r\nConnection: close\r\n\r\n" + body;
+            send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            close(client);
+        }
+    }
+};
+
+static const std::string PROFILE = R"({"id":"069a79f444e94726a5befca90e38aaf5","name":"Notch",)"
+                                   R"("properties":[{"name":"textures","value":"abc","signature":"sig"}]})";
+
+static zinc::ZincAuthResult verify(const std::string& sessionServer, const std::string& playerName = "Notch") {
+    zinc::g_zincConfig.m_core.m_security.m_sessionServer = sessionServer;
+    zinc::g_zincConfig.m_core.m_security.m_sessionServerTimeout = 5;
+    zinc::ZincAuthService service;
+    service.start(1);
+    std::promise<zinc::ZincAuthResult> promise;
+    zinc::ZincAuthRequest request;
+    request.m_playerName = playerName;
+    request.m_serverId = "-2a3b";
+    request.m_callback = [&promise](const zinc::ZincAuthResult& result) { promise.set_value(result); };
+    service.submit(request);
+    zinc::ZincAuthResult result = promise.get_future().get();
+    service.stop();
+    return result;
+}
+
+TEST(AuthServiceTest, AcceptsJoinedPlayer) {
+    SessionServerStandIn server ({ { 200, PROFILE } });
+    zinc::ZincAuthResult result = verify(server.getUrl());
+    EXPECT_TRUE(result.m_success);
+    EXPECT_FALSE(result.m_unreachable);
+    EXPECT_EQ(result.m_playerName, "Notch");
+    EXPECT_EQ(uuids::to_string(result.m_playerUUID), "069a79f4-44e9-4726-a5be-fca90e38aaf5");
+    ASSERT_EQ(result.m_properties.size(), 1);
+    EXPECT_EQ(result.m_properties[0].m_name, "textures");
+    EXPECT_EQ(result.m_properties[0].m_value, "abc");
+    EXPECT_EQ(server.m_requests, 1);
+    EXPECT_NE(server.getLastRequest().find("GET /session/minecraft/hasJoined?username=Notch&serverId=-2a3b "), std::string::npos);
+}
+
+TEST(AuthServiceTest, EscapesPlayerName) {
+    SessionServerStandIn server ({ { 204, "" } });
+    verify(server.getUrl(), "a&serverId=0 b");
+    EXPECT_NE(server.getLastRequest().find("GET /session/minecraft/hasJoined?username=a%26serverId%3D0%20b&serverId=-2a3b "), std::string::npos);
+}
+
+TEST(AuthServiceTest, RetriesServerErrors) {
+    SessionServerStandIn server ({ { 503, "" }, { 500, "" }, { 200, PROFILE } });
+    zinc::ZincAuthResult result = verify(server.getUrl());
+    EXPECT_TRUE(result.m_success);
+    EXPECT_EQ(server.m_requests, 3);
+}
+
+TEST(AuthServiceTest, GivesUpAfterMaxAttempts) {
+    SessionServerStandIn server ({ { 502, "" } });
+    zinc::ZincAuthResult result = verify(server.getUrl());
+    EXPECT_FALSE(result.m_success);
+    EXPECT_TRUE(result.m_unreachable);
+    EXPECT_EQ(server.m_requests, zinc::ZincAuthService::MAX_ATTEMPTS);
+}
+
+TEST(AuthServiceTest, RejectsOtherResponsesWithoutRetrying) {
+    for (int status : { 204, 403, 404 }) {
+        SessionServerStandIn server ({ { status, "" } });
+        zinc::ZincAuthResult result = verify(server.getUrl());
+        EXPECT_FALSE(result.m_success);
+        EXPECT_FALSE(result.m_unreachable);
+        EXPECT_EQ(server.m_requests, 1);
+    }
+}
+
+TEST(AuthServiceTest, RejectsMalformedProfileWithoutRetrying) {
+    for (const std::string& body : { std::string("{\"id\":"), std::string(R"({"id":"not-a-uuid","name":"Notch","properties":[]})"),
+                                     std::string(R"({"id":"069a79f444e94726a5befca90e38aaf5","name":"Notch","properties":[{"name":"textures"}]})") }) {
+        SessionServerStandIn server ({ { 200, body } });
+        zinc::ZincAuthResult result = verify(server.getUrl());
+        EXPECT_FALSE(result.m_success);
+        EXPECT_FALSE(result.m_unreachable);
+        EXPECT_EQ(server.m_requests, 1);
+    }
+}
+
+TEST(AuthServiceTest, ReportsUnreachableServer) {
+    unsigned short port = 0;
+    {
+        SessionServerStandIn server ({ { 200, PROFILE } });
+        port = server.m_port;
+    }
+    // nothing listens on the port anymore, every attempt fails to connect
+    zinc::ZincAuthResult result = verify("http://127.0.0.1:" + std::to_string(port));
+    EXPECT_FALSE(result.m_success);
+    EXPECT_TRUE(result.m_unreachable);
+}
+
+TEST(AuthServiceTest, BoundsTheQueue) {
+    zinc::ZincAuthService service; // not started, nothing drains the queue
+    zinc::ZincAuthRequest request;
+    request.m_callback = [](const zinc::ZincAuthResult&) {};
+    for (size_t i = 0; i < zinc::ZincAuthService::MAX_QUEUED_REQUESTS; i++) EXPECT_TRUE(service.submit(request));
+    EXPECT_FALSE(service.submit(request));
+    EXPECT_EQ(service.getQueueSize(), zinc::ZincAuthService::MAX_QUEUED_REQUESTS);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
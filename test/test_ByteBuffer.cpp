@@ -151,6 +151,125 @@ TEST(ByteBufferTest, WriteReadGameTypes) {
     EXPECT_TRUE(buffer.readNBTElement() == element);
     EXPECT_TRUE(buffer.readChatType() == chat);
 }
+TEST(ByteBufferTest, ContiguousStorage) {
+    zinc::ByteBuffer buffer;
+    std::vector<char> bytes (10000);
+    for (size_t i = 0; i < bytes.size(); i++) bytes[i] = (char) (i % 127);
+    buffer.writeNumeric<int>(7);
+    buffer.writeBytes(bytes);
+
+    EXPECT_EQ(buffer.size(), bytes.size() + 4);
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), buffer.getSpan().begin() + 4));
+
+    const char* storage = buffer.data();
+    zinc::ByteBuffer moved (std::move(buffer));
+    EXPECT_EQ(moved.data(), storage);
+    EXPECT_EQ(buffer.size(), 0u);
+    EXPECT_EQ(moved.readNumeric<int>(), 7);
+    EXPECT_TRUE(moved.readBytes(bytes.size()) == bytes);
+}
+TEST(ByteBufferTest, RecycleReadBytes) {
+    zinc::ByteBuffer buffer;
+    buffer.m_internalBuffer.toggleBlockRecycle(true);
+    for (int i = 0; i < 1000; i++) {
+        buffer.writeVarNumeric<int>(i);
+        EXPECT_EQ(buffer.readVarNumeric<int>(), i);
+    }
+    EXPECT_LE(buffer.m_internalBuffer.capacity(), zinc::ByteBuffer::InternalByteBuffer::INLINE_SIZE);
+}
+TEST(ByteBufferTest, ViewReads) {
+    zinc::ByteBuffer buffer;
+    buffer.writeNumeric<double>(1.5);
+    buffer.writeString("minecraft:brand");
+    buffer.writeBytes({ 1, 2, 3, 4 });
+    buffer.writeIdentifier(zinc::Identifier("zinc", "test"));
+
+    EXPECT_EQ(buffer.peek<double>(), 1.5);
+    EXPECT_EQ(buffer.peek<double>(), 1.5); // the reader does not move
+    EXPECT_EQ(buffer.readNumeric<double>(), 1.5);
+    std::string_view string = buffer.readStringView();
+    EXPECT_EQ(string, "minecraft:brand");
+    EXPECT_GE(string.data(), buffer.data());
+    EXPECT_LT(string.data(), buffer.data() + buffer.size());
+    std::span<const char> bytes = buffer.readSpan(2);
+    ASSERT_EQ(bytes.size(), 2u);
+    EXPECT_EQ(bytes[1], 2);
+    std::array<char, 2> out {};
+    EXPECT_TRUE(buffer.readInto(out));
+    EXPECT_EQ(out[1], 4);
+    EXPECT_TRUE(buffer.readIdentifier() == zinc::Identifier("zinc", "test"));
+    EXPECT_FALSE(buffer.hasReadFailed());
+
+    EXPECT_FALSE(buffer.peek<int>().has_value());
+    EXPECT_FALSE(buffer.hasReadFailed());
+    EXPECT_TRUE(buffer.readSpan(1).empty());
+    EXPECT_TRUE(buffer.hasReadFailed());
+    EXPECT_FALSE(buffer.readInto(out));
+    buffer.clear();
+    EXPECT_FALSE(buffer.hasReadFailed());
+
+    buffer.writeString("brand");
+    EXPECT_TRUE(buffer.readIdentifier() == zinc::Identifier());
+    EXPECT_TRUE(buffer.hasReadFailed());
+    buffer.clear();
+
+    // a hostile element count stops at the end of the data instead of filling the vector with defaults
+    buffer.writeVarNumeric<int>(1000000000);
+    buffer.writeNumeric<int>(5);
+    std::vector<int> values = buffer.readPrefixedArray<int>(&zinc::ByteBuffer::readNumeric<int>);
+    EXPECT_LE(values.size(), 2u);
+    EXPECT_EQ(values.front(), 5);
+    EXPECT_TRUE(buffer.hasReadFailed());
+}
+template<typename T> void checkNumericArray(const bool& isBigEndian) {
+    for (size_t count : { 0, 1, 3, 4, 7, 15, 16, 17, 33, 1000 }) {
+        std::vector<T> values (count);
+        for (size_t i = 0; i < count; i++) values[i] = static_cast<T>(i * 0x01030507u + 0x0F);
+        zinc::ByteBuffer bulk (isBigEndian), single (isBigEndian);
+        bulk.writePrefixedNumericArray<T>(values);
+        single.writePrefixedArray<T>(values, &zinc::ByteBuffer::writeNumeric<T>);
+        EXPECT_TRUE(bulk.getBytes() == single.getBytes());
+        EXPECT_TRUE(bulk.readPrefixedNumericArray<T>() == values);
+        EXPECT_FALSE(bulk.hasReadFailed());
+    }
+}
+TEST(ByteBufferTest, NumericArrays) {
+    for (bool isBigEndian : { true, false }) {
+        checkNumericArray<short>(isBigEndian);
+        checkNumericArray<int>(isBigEndian);
+        checkNumericArray<long>(isBigEndian);
+        checkNumericArray<double>(isBigEndian);
+        checkNumericArray<unsigned char>(isBigEndian);
+    }
+    zinc::ByteBuffer buffer;
+    buffer.writeVarNumeric<int>(1000);
+    buffer.writeNumeric<long>(1);
+    EXPECT_TRUE(buffer.readPrefixedNumericArray<long>().empty());
+    EXPECT_TRUE(buffer.hasReadFailed());
+}
+
+TEST(ByteBufferTest, EncodedSizes) {
+    zinc::Slot slot (5, 3, { zinc::ComponentWrapper(1, { 1, 2, 3 }) }, { 4, 300 });
+    for (const zinc::Slot& value : { slot, zinc::Slot() }) {
+        zinc::ByteBuffer buffer;
+        buffer.writeSlot(value);
+        EXPECT_EQ(value.encodedSize(), buffer.size());
+        EXPECT_EQ(value.toBytes(), buffer.getBytes());
+    }
+    zinc::LightData light;
+    light.m_skyLightMask.set(3);
+    light.m_blockLightMask.set(130);
+    light.m_skyLightArrays = { std::vector<char>(2048, 15) };
+    light.m_blockLightArrays = { std::vector<char>(2048, 0), std::vector<char>(2048, 1) };
+    zinc::ByteBuffer lightBuffer;
+    lightBuffer.writeLightData(light);
+    EXPECT_EQ(light.encodedSize(), lightBuffer.size());
+    EXPECT_TRUE(lightBuffer.readLightData() == light);
+    zinc::TextComponent text = zinc::TextComponentBuilder().text("Hello").color("red").build();
+    zinc::ByteBuffer textBuffer;
+    textBuffer.writeTextComponent(text);
+    EXPECT_EQ(text.encodedSize(), textBuffer.size());
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
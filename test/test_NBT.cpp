@@ -60,6 +60,43 @@ TEST(NBTTest, LEEncodeDecodeNBTElement) {
     EXPECT_TRUE(element == zinc::NBTElement(buffer));
 }
 
+TEST(NBTTest, EncodedSize) {
+    zinc::NBTElement element = zinc::NBTElement::Compound({
+        zinc::NBTElement::Compound("description", {
+            zinc::NBTElement::String("text", (const std::string&)"Hello World!")
+        }),
+        zinc::NBTElement::List("array", {
+            zinc::NBTElement::Int(1),
+            zinc::NBTElement::Int(-300000)
+        }),
+        zinc::NBTElement::List("mixed", {
+            zinc::NBTElement::Int(1),
+            zinc::NBTElement::Long(2)
+        }),
+        zinc::NBTElement::List("earray", {}),
+        zinc::NBTElement::IntArray("ints", { 1, 2, 3 }),
+        zinc::NBTElement::LongArray("longs", { 1, 2, 3 }),
+        zinc::NBTElement::ByteArray("bytes", std::vector<char>(200, 1)),
+        zinc::NBTElement::Int("int", -1),
+        zinc::NBTElement::Long("long", 1L << 40),
+        zinc::NBTElement::Float("float", 1.1f),
+        zinc::NBTElement::Double("double", 2.2f),
+        zinc::NBTElement::Byte("byte", 73),
+        zinc::NBTElement::Short("short", 12)
+    });
+    for (bool isBigEndian : { true, false }) {
+        zinc::ByteBuffer buffer (isBigEndian);
+        element.encode(buffer);
+        EXPECT_EQ(element.encodedSize(isBigEndian), buffer.size());
+        // network NBT drops the root tag and uses VarInts for little endian
+        zinc::ByteBuffer networkBuffer (isBigEndian);
+        networkBuffer.writeNBTElement(element);
+        zinc::NBTSettings settings;
+        settings.m_isNetwork = true;
+        EXPECT_EQ(element.encodedSize(isBigEndian, settings), networkBuffer.size());
+    }
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <network/minecraft/ZincPackets.h>
+#include <network/minecraft/ZincConnection.h>
+#include <type/TeleportFlags.h>
+#include <util/TCPUtil.h>
+
+TEST(PacketSchemaTest, MatchesHandWrittenEncoding) {
+    zinc::LoginSuccessPacket packet;
+    packet.m_playerUUID = uuids::uuid::from_string("47c4d5c3-6b1c-4f3a-9d4a-2b0f1f6e9a10").value();
+    packet.m_playerName = "Notch";
+    packet.m_properties = { { "textures", "value", std::nullopt }, { "other", "value2", std::string("signature") } };
+
+    zinc::ByteBuffer expected;
+    expected.writeUUID(packet.m_playerUUID);
+    expected.writeString(packet.m_playerName);
+    expected.writePrefixedArray<zinc::ZincConnectionProperty>(packet.m_properties, &zinc::writeZincConnectionProperty);
+
+    zinc::ZincPacket encoded = zinc::encodePacket(packet);
+    EXPECT_EQ(encoded.getId(), zinc::LoginSuccessPacket::ID);
+    EXPECT_EQ(zinc::encodedSize(packet), expected.size());
+    EXPECT_EQ(encoded.getData().getBytes(), expected.getBytes());
+}
+
+TEST(PacketSchemaTest, RoundTrip) {
+    zinc::HandshakePacket handshake;
+    handshake.m_protocolVersion = 770;
+    handshake.m_serverAddr = "localhost";
+    handshake.m_serverPort = 25565;
+    handshake.m_nextState = 2;
+    zinc::ZincPacket encoded = zinc::encodePacket(handshake);
+
+    zinc::HandshakePacket decoded;
+    EXPECT_TRUE(zinc::decodePacket(encoded, decoded));
+    EXPECT_EQ(decoded.m_protocolVersion, 770);
+    EXPECT_EQ(decoded.m_serverAddr, "localhost");
+    EXPECT_EQ(decoded.m_serverPort, 25565);
+    EXPECT_EQ(decoded.m_nextState, 2);
+    EXPECT_EQ(encoded.getData().getReaderPointer(), encoded.getData().size());
+
+    zinc::ClientInformationPacket information;
+    information.m_settings.m_locale = "en_us";
+    information.m_settings.m_renderDistance = 12;
+    information.m_settings.m_chatMode = zinc::ZincConnectionInfo::SettingsInfo::ChatMode::Hidden;
+    information.m_settings.m_enableChatColors = true;
+    information.m_settings.m_skinParts = 0x7F;
+    information.m_settings.m_mainHand = zinc::ZincConnectionInfo::SettingsInfo::MainHand::Right;
+    information.m_settings.m_enableTextFiltering = false;
+    information.m_settings.m_idkWhyIEvenListItHereButOk__enableServerListing = true;
+    information.m_settings.m_particleStatus = zinc::ZincConnectionInfo::SettingsInfo::ParticleStatus::Minimal;
+    encoded = zinc::encodePacket(information);
+
+    zinc::ClientInformationPacket decodedInformation;
+    EXPECT_TRUE(zinc::decodePacket(encoded, decodedInformation));
+    EXPECT_EQ(decodedInformation.m_settings.m_locale, "en_us");
+    EXPECT_EQ(decodedInformation.m_settings.m_renderDistance, 12);
+    EXPECT_EQ(decodedInformation.m_settings.m_chatMode, zinc::ZincConnectionInfo::SettingsInfo::ChatMode::Hidden);
+    EXPECT_EQ(decodedInformation.m_settings.m_skinParts, 0x7F);
+    EXPECT_EQ(decodedInformation.m_settings.m_particleStatus, zinc::ZincConnectionInfo::SettingsInfo::ParticleStatus::Minimal);
+
+    zinc::PluginMessagePacket message;
+    message.m_channel = zinc::Identifier("minecraft", "brand");
+    message.m_data = { 5, 'v', 'a', 'n', 'i', 'l' };
+    encoded = zinc::encodePacket(1, message);
+    zinc::PluginMessagePacket decodedMessage;
+    EXPECT_TRUE(zinc::decodePacket(encoded, decodedMessage));
+    EXPECT_EQ(decodedMessage.m_channel.toString(), "minecraft:brand");
+    EXPECT_EQ(decodedMessage.m_data, message.m_data);
+}
+
+TEST(PacketSchemaTest, PlayPackets) {
+    zinc::SynchronizePlayerPositionPacket synchronize;
+    synchronize.m_teleportId = 300;
+    synchronize.m_x = 1.5;
+    synchronize.m_y = -64;
+    synchronize.m_z = 1e6;
+    synchronize.m_velocityY = -0.08;
+    synchronize.m_yaw = 90.f;
+    synchronize.m_pitch = -45.f;
+    zinc::TeleportFlags flags;
+    flags.setRelYaw(true);
+    synchronize.m_flags = flags.encode();
+
+    zinc::ByteBuffer expected;
+    expected.writeVarNumeric<int>(300);
+    for (double value : { 1.5, -64.0, 1e6, 0.0, -0.08, 0.0 }) expected.writeNumeric<double>(value);
+    expected.writeNumeric<float>(90.f);
+    expected.writeNumeric<float>(-45.f);
+    expected.writeNumeric<int>(flags.encode());
+    zinc::ZincPacket encoded = zinc::encodePacket(synchronize);
+    EXPECT_EQ(encoded.getId(), zinc::SynchronizePlayerPositionPacket::ID);
+    EXPECT_EQ(zinc::encodedSize(synchronize), expected.size());
+    EXPECT_EQ(encoded.getData().getBytes(), expected.getBytes());
+
+    zinc::ByteBuffer movement;
+    movement.writeNumeric<double>(8.25);
+    movement.writeNumeric<double>(70);
+    movement.writeNumeric<double>(-3.5);
+    movement.writeNumeric<float>(180.f);
+    movement.writeNumeric<float>(12.5f);
+    movement.writeUnsignedByte(1);
+    zinc::SetPlayerPositionAndRotationPacket positionAndRotation;
+    EXPECT_TRUE(zinc::decodePacket(movement, positionAndRotation));
+    EXPECT_EQ(positionAndRotation.m_x, 8.25);
+    EXPECT_EQ(positionAndRotation.m_y, 70);
+    EXPECT_EQ(positionAndRotation.m_z, -3.5);
+    EXPECT_EQ(positionAndRotation.m_yaw, 180.f);
+    EXPECT_EQ(positionAndRotation.m_pitch, 12.5f);
+    EXPECT_EQ(positionAndRotation.m_flags, 1);
+
+    zinc::ByteBuffer rotationOnly;
+    rotationOnly.writeNumeric<float>(1.f);
+    zinc::SetPlayerRotationPacket rotation;
+    EXPECT_FALSE(zinc::decodePacket(rotationOnly, rotation));
+
+    zinc::CookieRequestPacket cookieRequest;
+    cookieRequest.m_key = zinc::Identifier("zinc", "session");
+    encoded = zinc::encodePacket(0x15, cookieRequest);
+    zinc::ByteBuffer expectedCookieRequest;
+    expectedCookieRequest.writeIdentifier(cookieRequest.m_key);
+    EXPECT_EQ(encoded.getData().getBytes(), expectedCookieRequest.getBytes());
+}
+
+TEST(PacketSchemaTest, RejectsMalformedPayloads) {
+    zinc::ByteBuffer truncated;
+    truncated.writeVarNumeric<int>(770);
+    truncated.writeVarNumeric<int>(200); // string length beyond the payload
+    truncated.writeString("abc");
+    zinc::HandshakePacket handshake;
+    EXPECT_FALSE(zinc::decodePacket(truncated, handshake));
+
+    zinc::ByteBuffer overlong;
+    for (int i = 0; i < 6; i++) overlong.writeUnsignedByte(0xFF);
+    zinc::KeepAlivePacket keepAlive;
+    zinc::ConfirmTeleportationPacket teleport;
+    EXPECT_FALSE(zinc::decodePacket(overlong, teleport));
+
+    zinc::ByteBuffer shortKeepAlive;
+    shortKeepAlive.writeNumeric<int>(1);
+    EXPECT_FALSE(zinc::decodePacket(shortKeepAlive, keepAlive));
+
+    zinc::ByteBuffer hugeArray;
+    hugeArray.writeVarNumeric<int>(1 << 30);
+    zinc::KnownPacksPacket knownPacks;
+    EXPECT_FALSE(zinc::decodePacket(hugeArray, knownPacks));
+
+    zinc::ByteBuffer bareIdentifier;
+    bareIdentifier.writeString("brand"); // no namespace separator
+    bareIdentifier.writeBytes({ 1, 2 });
+    zinc::PluginMessagePacket message;
+    EXPECT_FALSE(zinc::decodePacket(bareIdentifier, message));
+}
+
+TEST(PacketSchemaTest, FrameLayout) {
+    for (size_t size : { 0, 10, 1000 }) { // 1000 is above the compression threshold
+        zinc::ByteBuffer data;
+        for (size_t i = 0; i < size; i++) data.writeByte(static_cast<char>('a' + i % 26));
+        zinc::ZincPacket packet (0x172, data);
+        for (bool isCompressed : { false, true }) {
+            evbuffer* output = evbuffer_new();
+            ASSERT_TRUE(zinc::ZincConnection::writeFrame(output, packet, isCompressed));
+            std::vector<unsigned char> frame (evbuffer_get_length(output));
+            evbuffer_remove(output, frame.data(), frame.size());
+            evbuffer_free(output);
+            int frameLength = 0, dataLength = 0;
+            int offset = zinc::TCPUtil::peekVarInt(frame.data(), frame.size(), frameLength);
+            ASSERT_GT(offset, 0);
+            EXPECT_EQ(frame.size(), static_cast<size_t>(offset + frameLength));
+            if (isCompressed && size == 1000) {
+                zinc::ZincPacket inflated = zinc::ZincConnection::inflate((const char*) frame.data() + offset, static_cast<size_t>(frameLength));
+                EXPECT_EQ(inflated.getId(), 0x172);
+                EXPECT_EQ(inflated.getData().getBytes(), data.getBytes());
+                continue;
+            }
+            if (isCompressed) {
+                offset += zinc::TCPUtil::peekVarInt(frame.data() + offset, frame.size() - static_cast<size_t>(offset), dataLength);
+                EXPECT_EQ(dataLength, 0);
+            }
+            std::vector<unsigned char> expected = { 0xF2, 0x02 }; // VarInt 0x172
+            const std::vector<char> bytes = data.getBytes();
+            expected.insert(expected.end(), bytes.begin(), bytes.end());
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(), frame.begin() + offset, frame.end()));
+        }
+    }
+}
+
+TEST(PacketSchemaTest, SharedPacketFrames) {
+    zinc::ByteBuffer data;
+    data.writeString(std::string(1000, 'a')); // above the compression threshold
+    zinc::SharedPacket packet (zinc::ZincPacket(0x72, std::move(data)));
+    for (bool isCompressed : { false, true }) {
+        evbuffer* output = evbuffer_new();
+        ASSERT_TRUE(zinc::ZincConnection::writeFrame(output, zinc::ZincPacket(0x72, packet.getData()), isCompressed));
+        std::vector<char> expected (evbuffer_get_length(output));
+        evbuffer_remove(output, expected.data(), expected.size());
+        evbuffer_free(output);
+        const std::vector<char>* frame = packet.getFrame(isCompressed);
+        ASSERT_NE(frame, nullptr);
+        EXPECT_EQ(*frame, expected);
+        // framed once, later recipients get the same bytes
+        EXPECT_EQ(packet.getFrame(isCompressed), frame);
+    }
+    EXPECT_EQ(zinc::SharedPacket().getFrame(false), nullptr);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <network/ProxyProtocol.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<unsigned char> bytes(const std::string& text) {
+    return std::vector<unsigned char>(text.begin(), text.end());
+}
+std::vector<unsigned char> v2Header(const unsigned char& command, const unsigned char& family, const std::vector<unsigned char>& addresses) {
+    std::vector<unsigned char> header = { '\r', '\n', '\r', '\n', 0, '\r', '\n', 'Q', 'U', 'I', 'T', '\n' };
+    header.push_back((unsigned char) (0x20 | command));
+    header.push_back((unsigned char) (family << 4 | 1));
+    header.push_back((unsigned char) (addresses.size() >> 8));
+    header.push_back((unsigned char) (addresses.size() & 0xFF));
+    header.insert(header.end(), addresses.begin(), addresses.end());
+    return header;
+}
+std::string sourceIP(const zinc::ProxyHeader& header) {
+    char buffer[INET6_ADDRSTRLEN] = {};
+    if (header.m_source.ss_family == AF_INET) inet_ntop(AF_INET, &((const sockaddr_in*) &header.m_source)->sin_addr, buffer, sizeof(buffer));
+    else inet_ntop(AF_INET6, &((const sockaddr_in6*) &header.m_source)->sin6_addr, buffer, sizeof(buffer));
+    return buffer;
+}
+
+}
+
+TEST(ProxyProtocolTest, ParsesV1) {
+    std::vector<unsigned char> data = bytes("PROXY TCP4 203.0.113.7 10.0.0.1 51234 25565\r\n");
+    data.insert(data.end(), { 0x10, 0x00 }); // start of the handshake stays in the stream
+    zinc::ProxyHeader header;
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), (int) data.size() - 2);
+    EXPECT_FALSE(header.m_isLocal);
+    EXPECT_EQ(sourceIP(header), "203.0.113.7");
+    EXPECT_EQ(ntohs(((const sockaddr_in*) &header.m_source)->sin_port), 51234);
+
+    data = bytes("PROXY TCP6 2001:db8::1 2001:db8::2 4000 25565\r\n");
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), (int) data.size());
+    EXPECT_EQ(sourceIP(header), "2001:db8::1");
+
+    data = bytes("PROXY UNKNOWN\r\n");
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), (int) data.size());
+    EXPECT_TRUE(header.m_isLocal);
+}
+
+TEST(ProxyProtocolTest, ParsesV2) {
+    std::vector<unsigned char> data = v2Header(1, 1, { 198, 51, 100, 9, 10, 0, 0, 1, 0x1F, 0x90, 0x63, 0xDD });
+    zinc::ProxyHeader header;
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), (int) data.size());
+    EXPECT_FALSE(header.m_isLocal);
+    EXPECT_EQ(sourceIP(header), "198.51.100.9");
+    EXPECT_EQ(ntohs(((const sockaddr_in*) &header.m_source)->sin_port), 8080);
+
+    std::vector<unsigned char> addresses (36, 0);
+    addresses[0] = 0x20;
+    addresses[1] = 0x01;
+    addresses[15] = 0x05;
+    data = v2Header(1, 2, addresses);
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), (int) data.size());
+    EXPECT_EQ(sourceIP(header), "2001::5");
+
+    data = v2Header(0, 0, {});
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), (int) data.size());
+    EXPECT_TRUE(header.m_isLocal);
+}
+
+TEST(ProxyProtocolTest, WaitsForPartialHeaders) {
+    zinc::ProxyHeader header;
+    std::vector<unsigned char> data = bytes("PROXY TCP4 203.0.113.7 10.0.0.1 51234 25565\r\n");
+    for (size_t length = 0; length < data.size(); length++) EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), length, header), 0);
+    data = v2Header(1, 1, { 198, 51, 100, 9, 10, 0, 0, 1, 0x1F, 0x90, 0x63, 0xDD });
+    for (size_t length = 0; length < data.size(); length++) EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), length, header), 0);
+}
+
+TEST(ProxyProtocolTest, RejectsMalformedHeaders) {
+    zinc::ProxyHeader header;
+    for (const std::string& text : { std::string("\x10\x01\xFB\x05"), std::string("PROXY TCP4 nonsense 10.0.0.1 1 2\r\n"),
+                                     std::string("PROXY TCP4 1.2.3.4 10.0.0.1 99999 2\r\n"), std::string("PROXY TCP4 1.2.3.4\r\n"),
+                                     std::string("PROXY TCP6 1.2.3.4 10.0.0.1 1 2\r\n"), std::string("PROXY ") + std::string(120, 'A') }) {
+        std::vector<unsigned char> data = bytes(text);
+        EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), -1) << text;
+    }
+    std::vector<unsigned char> data = v2Header(1, 1, { 1, 2, 3, 4 });
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), -1);
+    data = v2Header(2, 1, { 198, 51, 100, 9, 10, 0, 0, 1, 0x1F, 0x90, 0x63, 0xDD });
+    EXPECT_EQ(zinc::ProxyProtocol::parse(data.data(), data.size(), header), -1);
+}
+
+TEST(ProxyProtocolTest, ReadsFromEvbuffer) {
+    evbuffer* input = evbuffer_new();
+    std::string header = "PROXY TCP4 203.0.113.7 10.0.0.1 51234 25565\r\n";
+    evbuffer_add(input, header.data(), 20);
+    zinc::ProxyHeader result;
+    EXPECT_EQ(zinc::ProxyProtocol::read(input, result), 0);
+    EXPECT_EQ(evbuffer_get_length(input), 20);
+    evbuffer_add(input, header.data() + 20, header.size() - 20);
+    evbuffer_add(input, "\x10\x01", 2);
+    EXPECT_EQ(zinc::ProxyProtocol::read(input, result), (int) header.size());
+    EXPECT_EQ(evbuffer_get_length(input), 2);
+    EXPECT_EQ(sourceIP(result), "203.0.113.7");
+    evbuffer_free(input);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <util/SlotMap.h>
+#include <util/EpochReclaimer.h>
+#include <thread>
+
+TEST(SlotMapTest, InsertGetErase) {
+    zinc::SlotMap<int> map;
+    int a = 1, b = 2;
+    zinc::SlotMapHandle handleA = map.insert(&a);
+    zinc::SlotMapHandle handleB = map.insert(&b);
+    EXPECT_EQ(map.get(handleA), &a);
+    EXPECT_EQ(map.get(handleB), &b);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.erase(handleA), &a);
+    EXPECT_EQ(map.get(handleA), nullptr);
+    EXPECT_EQ(map.erase(handleA), nullptr);
+    EXPECT_EQ(map.get(zinc::SlotMapHandle()), nullptr);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(SlotMapTest, StaleHandleAfterReuse) {
+    zinc::SlotMap<int> map;
+    int a = 1, b = 2;
+    zinc::SlotMapHandle stale = map.insert(&a);
+    map.erase(stale);
+    zinc::SlotMapHandle fresh = map.insert(&b);
+    EXPECT_EQ(fresh.m_index, stale.m_index); // slot is reused
+    EXPECT_NE(fresh, stale);
+    EXPECT_EQ(map.get(stale), nullptr);
+    EXPECT_EQ(map.get(fresh), &b);
+    size_t visited = 0;
+    map.forEach([&](const zinc::SlotMapHandle& handle, int* value) {
+        EXPECT_EQ(handle, fresh);
+        EXPECT_EQ(value, &b);
+        visited++;
+    });
+    EXPECT_EQ(visited, 1u);
+}
+
+TEST(SlotMapTest, GrowsAcrossChunks) {
+    zinc::SlotMap<int> map;
+    std::vector<int> values (zinc::SlotMap<int>::CHUNK_SIZE * 3);
+    std::vector<zinc::SlotMapHandle> handles;
+    for (int& value : values) handles.push_back(map.insert(&value));
+    for (size_t i = 0; i < values.size(); i++) EXPECT_EQ(map.get(handles[i]), &values[i]);
+}
+
+TEST(EpochReclaimerTest, DefersWhilePinned) {
+    zinc::EpochReclaimer reclaimer;
+    int deleted = 0;
+    {
+        zinc::EpochReclaimer::Guard guard = reclaimer.pin();
+        reclaimer.retire([&]() { deleted++; });
+        reclaimer.collect();
+        EXPECT_EQ(deleted, 0);
+    }
+    reclaimer.collect();
+    EXPECT_EQ(deleted, 1);
+    EXPECT_EQ(reclaimer.getRetiredCount(), 0u);
+}
+
+TEST(EpochReclaimerTest, ConcurrentLookups) {
+    zinc::SlotMap<int> map;
+    zinc::EpochReclaimer reclaimer;
+    std::atomic<bool> running = true;
+    std::atomic<int> live = 0;
+    std::array<std::atomic<zinc::SlotMapHandle>, 64> handles;
+    for (std::atomic<zinc::SlotMapHandle>& handle : handles) handle = zinc::SlotMapHandle();
+    std::thread reader([&]() {
+        while (running) {
+            for (const std::atomic<zinc::SlotMapHandle>& handle : handles) {
+                zinc::EpochReclaimer::Guard guard = reclaimer.pin();
+                if (int* value = map.get(handle.load())) EXPECT_EQ(*value, 42);
+            }
+        }
+    });
+    for (int round = 0; round < 2000; round++) {
+        size_t i = (size_t) (round * 7) % handles.size();
+        if (map.get(handles[i].load())) {
+            int* value = map.erase(handles[i].load());
+            reclaimer.retire([value, &live]() {
+                *value = 0;
+                delete value;
+                live--;
+            });
+        }
+        live++;
+        handles[i] = map.insert(new int(42));
+    }
+    running = false;
+    reader.join();
+    map.forEach([&](const zinc::SlotMapHandle&, int* value) {
+        delete value;
+        live--;
+    });
+    reclaimer.collect();
+    EXPECT_EQ(live, 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <util/TimerWheel.h>
+
+TEST(TimerWheelTest, FiresAfterDelay) {
+    zinc::TimerWheel wheel;
+    std::vector<int> fired;
+    wheel.schedule(3, [&]() { fired.push_back(3); });
+    wheel.schedule(1, [&]() { fired.push_back(1); });
+    wheel.schedule(0, [&]() { fired.push_back(0); }); // rounded up to one tick
+    wheel.advance(1);
+    EXPECT_EQ(fired, std::vector<int>({ 0, 1 }));
+    wheel.advance(1);
+    EXPECT_EQ(fired.size(), 2u);
+    wheel.advance(1);
+    EXPECT_EQ(fired, std::vector<int>({ 0, 1, 3 }));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, CascadesAcrossLevels) {
+    zinc::TimerWheel wheel;
+    std::vector<uint64_t> delays = { 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300000, 20000000 };
+    std::vector<uint64_t> firedAt;
+    wheel.advance(17); // start unaligned
+    uint64_t start = wheel.getTick();
+    for (uint64_t delay : delays) wheel.schedule(delay, [&]() { firedAt.push_back(wheel.getTick()); });
+    wheel.advance(20000000);
+    ASSERT_EQ(firedAt.size(), delays.size());
+    for (size_t i = 0; i < delays.size(); i++) EXPECT_EQ(firedAt[i], start + delays[i]);
+}
+
+TEST(TimerWheelTest, CancelAndReschedule) {
+    zinc::TimerWheel wheel;
+    int fired = 0;
+    zinc::TimerWheel::TimerId cancelled = wheel.schedule(10, [&]() { fired += 100; });
+    zinc::TimerWheel::TimerId periodic;
+    std::function<void()> tick = [&]() {
+        fired++;
+        if (fired < 3) periodic = wheel.schedule(5, tick);
+    };
+    periodic = wheel.schedule(5, tick);
+    EXPECT_TRUE(wheel.isScheduled(cancelled));
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.isScheduled(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    wheel.advance(100);
+    EXPECT_EQ(fired, 3);
+    EXPECT_FALSE(wheel.isScheduled(periodic));
+    // the slot of a fired timer is reused, stale ids must stay invalid
+    zinc::TimerWheel::TimerId stale = periodic;
+    wheel.schedule(1, []() {});
+    EXPECT_FALSE(wheel.cancel(stale));
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
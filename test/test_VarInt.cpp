@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <util/VarInt.h>
+#include <type/ByteBuffer.h>
+#include <random>
+
+namespace {
+
+// byte at a time reference encoder
+template<typename T> std::vector<char> referenceEncode(const T& value) {
+    std::vector<char> result;
+    std::make_unsigned_t<T> remaining = static_cast<std::make_unsigned_t<T>>(value);
+    while (remaining >= 0x80) {
+        result.push_back(static_cast<char>((remaining & 0x7F) | 0x80));
+        remaining >>= 7;
+    }
+    result.push_back(static_cast<char>(remaining));
+    return result;
+}
+template<typename T> std::vector<T> boundaryValues() {
+    std::vector<T> values = { 0, 1, static_cast<T>(-1), std::numeric_limits<T>::min(), std::numeric_limits<T>::max() };
+    for (size_t shift = 7; shift < sizeof(T) * 8; shift += 7) {
+        const T edge = static_cast<T>(static_cast<std::make_unsigned_t<T>>(1) << shift);
+        values.insert(values.end(), { static_cast<T>(edge - 1), edge, static_cast<T>(-edge) });
+    }
+    return values;
+}
+template<typename T> void checkRoundTrip() {
+    for (const T& value : boundaryValues<T>()) {
+        const std::vector<char> expected = referenceEncode(value);
+        std::array<char, zinc::VarInt::maxSize<T>()> out;
+        ASSERT_EQ(zinc::VarInt::encode(out.data(), value), expected.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()));
+        EXPECT_EQ(zinc::VarInt::size(value), expected.size());
+        // exact length takes the byte-wise path, padded input the word path
+        T decoded = 0;
+        EXPECT_EQ(zinc::VarInt::decode(expected.data(), expected.size(), decoded), static_cast<int>(expected.size()));
+        EXPECT_EQ(decoded, value);
+        std::vector<char> padded = expected;
+        padded.resize(expected.size() + 16, 0x7F);
+        decoded = 0;
+        EXPECT_EQ(zinc::VarInt::decode(padded.data(), padded.size(), decoded), static_cast<int>(expected.size()));
+        EXPECT_EQ(decoded, value);
+    }
+}
+
+}
+
+TEST(VarIntTest, RoundTrip) {
+    checkRoundTrip<int>();
+    checkRoundTrip<long>();
+    checkRoundTrip<short>();
+    checkRoundTrip<unsigned int>();
+}
+
+TEST(VarIntTest, IncompleteAndMalformed) {
+    int value = 42;
+    const std::vector<char> incomplete = { '\x80', '\x80' };
+    EXPECT_EQ(zinc::VarInt::decode(incomplete.data(), incomplete.size(), value), 0);
+    EXPECT_EQ(zinc::VarInt::decode(incomplete.data(), 0, value), 0);
+    const std::vector<char> tooLong (16, '\x80');
+    EXPECT_EQ(zinc::VarInt::decode(tooLong.data(), 5, value), -1);
+    EXPECT_EQ(zinc::VarInt::decode(tooLong.data(), tooLong.size(), value), -1);
+    long longValue = 0;
+    EXPECT_EQ(zinc::VarInt::decode(tooLong.data(), 9, longValue), 0);
+    EXPECT_EQ(zinc::VarInt::decode(tooLong.data(), tooLong.size(), longValue), -1);
+    EXPECT_EQ(value, 42);
+}
+
+TEST(VarIntTest, ArrayRoundTrip) {
+    std::mt19937 random(7);
+    for (size_t count : { 0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 100, 4096 }) {
+        for (int maxBits : { 4, 7, 8, 14, 31 }) {
+            std::vector<int> values (count);
+            for (int& value : values) value = static_cast<int>(random() & ((1u << maxBits) - 1));
+            if (count > 20 && maxBits == 7) values[count / 2] = -1; // one long value inside a single byte run
+            std::vector<char> expected;
+            for (const int& value : values) {
+                const std::vector<char> encoded = referenceEncode(value);
+                expected.insert(expected.end(), encoded.begin(), encoded.end());
+            }
+            std::vector<char> out (count * zinc::VarInt::maxSize<int>());
+            ASSERT_EQ(zinc::VarInt::encodeArray(out.data(), values), expected.size());
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()));
+            std::vector<int> decoded (count);
+            EXPECT_EQ(zinc::VarInt::decodeArray(expected.data(), expected.size(), decoded), static_cast<long>(expected.size()));
+            EXPECT_EQ(decoded, values);
+            if (count) EXPECT_EQ(zinc::VarInt::decodeArray(expected.data(), expected.size() - 1, decoded), -1);
+        }
+    }
+}
+
+TEST(VarIntTest, ByteBufferArrays) {
+    zinc::ByteBuffer buffer;
+    std::vector<int> values (300);
+    for (size_t i = 0; i < values.size(); i++) values[i] = static_cast<int>(i * i);
+    buffer.writePrefixedVarIntArray(values);
+    buffer.writeVarNumeric<int>(-7);
+    EXPECT_EQ(buffer.readPrefixedVarIntArray(), values);
+    EXPECT_EQ(buffer.readVarNumeric<int>(), -7);
+    // a count larger than the remaining bytes is rejected before anything is allocated
+    buffer.writeVarNumeric<int>(1000000);
+    buffer.writeByte(1);
+    EXPECT_TRUE(buffer.readPrefixedVarIntArray().empty());
+    EXPECT_EQ(buffer.getReaderPointer(), buffer.size());
+    EXPECT_TRUE(buffer.hasReadFailed());
+    // a truncated VarInt fails the same way
+    buffer.clear();
+    buffer.writeByte('\x80');
+    EXPECT_EQ(buffer.readVarNumeric<int>(), 0);
+    EXPECT_EQ(buffer.getReaderPointer(), buffer.size());
+    EXPECT_TRUE(buffer.hasReadFailed());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
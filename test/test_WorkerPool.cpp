@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <util/WorkerPool.h>
+
+TEST(WorkerPoolTest, RunsEverySubmittedTask) {
+    zinc::WorkerPool pool;
+    pool.start(4);
+    EXPECT_EQ(pool.getThreadCount(), 4);
+    std::atomic<int> counter = 0;
+    for (int i = 0; i < 1000; i++) pool.submit(i % 2, [&counter]() { counter++; });
+    while (pool.getStats(0).m_completed + pool.getStats(1).m_completed < 1000) std::this_thread::yield();
+    EXPECT_EQ(counter, 1000);
+    EXPECT_EQ(pool.getStats(0).m_completed, 500);
+    EXPECT_EQ(pool.getStats(1).m_completed, 500);
+    EXPECT_EQ(pool.getStats(0).m_queueDepth, 0);
+    EXPECT_GE(pool.getStats(0).m_maxLatencyNanoseconds * 500, pool.getStats(0).m_totalLatencyNanoseconds);
+    pool.stop();
+}
+
+TEST(WorkerPoolTest, WorkersCanSubmitFollowUpWork) {
+    zinc::WorkerPool pool;
+    pool.start(2);
+    std::atomic<int> counter = 0;
+    for (int i = 0; i < 100; i++) pool.submit(0, [&pool, &counter]() {
+        pool.submit(1, [&counter]() { counter++; });
+    });
+    while (pool.getStats(1).m_completed < 100) std::this_thread::yield();
+    EXPECT_EQ(counter, 100);
+    EXPECT_EQ(pool.getStats(0).m_completed, 100);
+}
+
+TEST(WorkerPoolTest, RunsInlineWithoutThreads) {
+    zinc::WorkerPool pool;
+    pool.start(0);
+    EXPECT_EQ(pool.getThreadCount(), 0);
+    std::thread::id caller;
+    pool.submit(3, [&caller]() { caller = std::this_thread::get_id(); });
+    EXPECT_EQ(caller, std::this_thread::get_id());
+    EXPECT_EQ(pool.getStats(3).m_completed, 1);
+    EXPECT_EQ(pool.getStats(3).m_queueDepth, 0);
+    EXPECT_EQ(pool.getStats(zinc::WorkerPool::MAX_STAGES).m_completed, 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -10,6 +10,35 @@ TEST(ZLibUtilTest, CompressDecompress) {
     EXPECT_EQ(data.getBytes(), decompressed.getBytes());
 }
 
+TEST(ZLibUtilTest, ContextReuse) {
+    zinc::ZLibContext context(1);
+    for (int round = 0; round < 3; round++) {
+        std::vector<uint8_t> data (4096 + round * 1000);
+        for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t) ((i * (size_t) (round + 3)) % 251);
+        std::vector<uint8_t> compressed (zinc::ZLibContext::compressBound(data.size()));
+        size_t compressedSize = context.compress(data.data(), data.size(), compressed.data(), compressed.size());
+        ASSERT_GT(compressedSize, 0u);
+        std::vector<uint8_t> decompressed (data.size());
+        ASSERT_TRUE(context.uncompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()));
+        EXPECT_EQ(data, decompressed);
+    }
+}
+
+TEST(ZLibUtilTest, PrefixedInput) {
+    zinc::ZLibContext context;
+    std::vector<uint8_t> data (3000);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t) (i % 7);
+    std::vector<uint8_t> compressed (zinc::ZLibContext::compressBound(data.size()));
+    // the same stream as compressing the joined input
+    size_t compressedSize = context.compress(data.data(), 2, data.data() + 2, data.size() - 2, compressed.data(), compressed.size());
+    ASSERT_GT(compressedSize, 0u);
+    std::vector<uint8_t> joined (compressed.size());
+    ASSERT_EQ(context.compress(data.data(), data.size(), joined.data(), joined.size()), compressedSize);
+    EXPECT_TRUE(std::equal(compressed.begin(), compressed.begin() + (long) compressedSize, joined.begin()));
+    std::vector<uint8_t> decompressed (data.size());
+    ASSERT_TRUE(context.uncompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()));
+    EXPECT_EQ(data, decompressed);
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
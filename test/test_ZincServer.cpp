@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <network/minecraft/ZincServer.h>
+#include <util/EpochReclaimer.h>
+
+namespace {
+
+constexpr int TEST_PACKET_ID = zinc::ZincPacketDispatcher::MAX_PACKET_ID - 1;
+int g_handled = 0;
+
+// connection in `state` with `input` buffered as if it just arrived on the socket
+zinc::ConnectionHandle connect(zinc::MemoryStream*& stream, const zinc::ZincConnection::State& state, const std::vector<unsigned char>& input) {
+    zinc::ZincConnection* connection = new zinc::ZincConnection();
+    stream = new zinc::MemoryStream();
+    connection->getTCPConnection().setStream(stream);
+    connection->setState(state);
+    zinc::ConnectionHandle handle = zinc::g_zincServer.addClient(connection);
+    evbuffer_add(stream->getInput(), input.data(), input.size());
+    return handle;
+}
+// connection in Play with `count` empty uncompressed frames of TEST_PACKET_ID buffered
+zinc::ConnectionHandle connect(zinc::MemoryStream*& stream, const int& count) {
+    std::vector<unsigned char> input;
+    for (int i = 0; i < count; i++) input.insert(input.end(), { 0x01, (unsigned char) TEST_PACKET_ID });
+    return connect(stream, zinc::ZincConnection::State::Play, input);
+}
+
+}
+
+TEST(ZincServerTest, DispatchesEveryBufferedFrame) {
+    g_handled = 0;
+    zinc::g_zincServer.getPacketDispatcher().registerHandler(zinc::ZincConnection::State::Play, TEST_PACKET_ID, [](zinc::ZincConnection*, zinc::ZincPacket&) {
+        g_handled++;
+        return true;
+    });
+    zinc::MemoryStream* stream;
+    zinc::ConnectionHandle handle = connect(stream, 3);
+    zinc::ZincServer::onRead(stream, zinc::g_zincServer.getClient(handle));
+    EXPECT_EQ(g_handled, 3);
+    EXPECT_TRUE(zinc::g_zincServer.isConnected(handle));
+    zinc::g_zincServer.removeClient(handle);
+    zinc::g_epochReclaimer.collect();
+}
+
+TEST(ZincServerTest, StopsReadingAfterHandlerRemovesClient) {
+    g_handled = 0;
+    // returning true asks for the next frame, but the connection is already freed at that point
+    zinc::g_zincServer.getPacketDispatcher().registerHandler(zinc::ZincConnection::State::Play, TEST_PACKET_ID, [](zinc::ZincConnection* connection, zinc::ZincPacket&) {
+        g_handled++;
+        zinc::g_zincServer.removeClient(connection->m_handle);
+        return true;
+    });
+    zinc::MemoryStream* stream;
+    zinc::ConnectionHandle handle = connect(stream, 3);
+    zinc::ZincServer::onRead(stream, zinc::g_zincServer.getClient(handle));
+    EXPECT_EQ(g_handled, 1);
+    EXPECT_FALSE(zinc::g_zincServer.isConnected(handle));
+    zinc::g_epochReclaimer.collect();
+}
+
+// found by fuzz_ZincConnection, each of these used to throw out of onRead and terminate the server
+TEST(ZincServerTest, SurvivesMalformedConfigPackets) {
+    zinc::MemoryStream* stream;
+    zinc::ConnectionHandle handle = connect(stream, zinc::ZincConnection::State::Config, {
+        0x04, 0x02, 0x01, 'l', 0x2B, // plugin message on a channel without a namespace
+        0x05, 0x02, 0x03, 'a', ':', 'b', // plugin message on a channel nobody registered
+        0x06, 0x01, 0x03, 'a', ':', 'b', 0x00 // cookie response for a key nobody asked for
+    });
+    EXPECT_NO_THROW(zinc::ZincServer::onRead(stream, zinc::g_zincServer.getClient(handle)));
+    EXPECT_TRUE(zinc::g_zincServer.isConnected(handle));
+    EXPECT_EQ(evbuffer_get_length(stream->getInput()), 0u);
+    zinc::g_zincServer.removeClient(handle);
+    zinc::g_epochReclaimer.collect();
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}